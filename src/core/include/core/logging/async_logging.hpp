@@ -0,0 +1,23 @@
+#ifndef CORE_LOGGING_ASYNC_LOGGING_HPP
+#define CORE_LOGGING_ASYNC_LOGGING_HPP
+
+namespace core::logging {
+
+	// Replaces the default logger with one that hands messages to a background thread, which formats and writes them
+	// Messages beyond the bounded queue overwrite the oldest ones, so a burst of logging never blocks the thread that logs
+	// Log statements below the "PLAIN_LOG_LEVEL" CMake option are compiled out when logged through the "SPDLOG_*" macros
+	class AsyncLogging final {
+	public:
+		AsyncLogging();
+		AsyncLogging(const AsyncLogging&) = delete;
+		AsyncLogging(AsyncLogging&&) = delete;
+		AsyncLogging& operator=(const AsyncLogging&) = delete;
+		AsyncLogging& operator=(AsyncLogging&&) = delete;
+
+		// Write the messages that are still queued and stop the background thread
+		~AsyncLogging();
+	};
+
+}
+
+#endif // !CORE_LOGGING_ASYNC_LOGGING_HPP
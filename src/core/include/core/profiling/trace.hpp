@@ -0,0 +1,55 @@
+#ifndef CORE_PROFILING_TRACE_HPP
+#define CORE_PROFILING_TRACE_HPP
+
+#include <cstdint>
+#include <string_view>
+
+// Scoped trace events are compiled in when the "PLAIN_TRACING" CMake option is on, and compile to nothing otherwise
+#ifdef PLAIN_TRACING
+#define PLAIN_TRACE_CONCATENATE_IMPL(a, b) a##b
+#define PLAIN_TRACE_CONCATENATE(a, b) PLAIN_TRACE_CONCATENATE_IMPL(a, b)
+
+// Record the time from this line until the end of the enclosing scope, "name" must be a string literal
+#define PLAIN_TRACE_SCOPE(name) const ::core::profiling::TraceScope PLAIN_TRACE_CONCATENATE(traceScope, __LINE__){ name }
+#else
+#define PLAIN_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace core::profiling {
+
+	// Start recording trace events, events of scopes that were entered before are not recorded
+	void startTracing();
+
+	// Stop recording trace events, scopes that are still open are not recorded
+	void stopTracing();
+
+	// Returns whether trace events are being recorded
+	bool isTracing();
+
+	// Name the calling thread in the trace, threads without a name are shown by their number
+	void setThreadName(const std::string_view& name);
+
+	// Write every recorded event to a file in the Chrome trace event format, which chrome://tracing and Perfetto open
+	// Tracing should be stopped first, events that are recorded while the file is written may be left out
+	bool writeTrace(const std::string_view& path);
+
+	// Records a complete event from construction until destruction
+	// Events are appended to a buffer that belongs to the calling thread, only the first event of a thread takes a lock to register it
+	class TraceScope final {
+	public:
+		explicit TraceScope(const char* const eventName);
+		TraceScope(const TraceScope&) = delete;
+		TraceScope(TraceScope&&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+		TraceScope& operator=(TraceScope&&) = delete;
+		~TraceScope();
+
+	private:
+		// Null when tracing was off when the scope was entered
+		const char* name;
+		std::uint64_t start;
+	};
+
+}
+
+#endif // !CORE_PROFILING_TRACE_HPP
@@ -0,0 +1,85 @@
+#ifndef CORE_SPATIAL_GRID_INDEX_HPP
+#define CORE_SPATIAL_GRID_INDEX_HPP
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace core::spatial {
+
+	// Axis-aligned area in pixels
+	struct Bounds {
+		float x;
+		float y;
+		float width;
+		float height;
+
+		bool operator==(const Bounds&) const = default;
+	};
+
+	// Uniform grid over a set of items, every cell lists the items whose bounds overlap it in ascending order
+	// A grid is never modified once built, which makes it safe to query from any thread without locks
+	class GridIndex final {
+	public:
+		friend class GridIndexBuilder;
+
+		// Collect the items in the cells an area overlaps, in ascending order
+		// This is a superset of the items that intersect the area, callers test the exact bounds of every candidate themselves
+		void query(const Bounds& area, std::vector<std::uint32_t>& candidates) const;
+
+		// Number of items in the grid
+		std::size_t size() const;
+
+	private:
+		// Cells an area overlaps, clamped to the grid - items and queries outside of the grid end up in the cells along its edge
+		struct CellRange {
+			std::size_t firstColumn;
+			std::size_t lastColumn;
+			std::size_t firstRow;
+			std::size_t lastRow;
+		};
+
+		// Should not be instantiated directly - please use "GridIndexBuilder" instead
+		GridIndex() = default;
+
+		CellRange getCellRange(const Bounds& area) const;
+
+	private:
+		float cellSize;
+		std::size_t columnCount;
+		std::size_t rowCount;
+		std::size_t itemCount;
+
+		// Row-major, empty cells are null - cells that did not change are shared with the grid they were copied from
+		std::vector<std::shared_ptr<const std::vector<std::uint32_t>>> cells;
+	};
+
+	// Keeps a grid index up to date as the items it covers change
+	class GridIndexBuilder final {
+	public:
+		explicit GridIndexBuilder(const float cellSize);
+		GridIndexBuilder(const GridIndexBuilder&) = delete;
+		GridIndexBuilder(GridIndexBuilder&&) = delete;
+		GridIndexBuilder& operator=(const GridIndexBuilder&) = delete;
+		GridIndexBuilder& operator=(GridIndexBuilder&&) = delete;
+		~GridIndexBuilder() = default;
+
+		// Index a new set of items, "bounds[i]" is the area covered by item "i"
+		// Items are compared to those of the previous update by index, only the cells of items that were added, removed, or moved are rebuilt
+		std::shared_ptr<const GridIndex> update(const std::span<const Bounds> bounds);
+
+	private:
+		// Build a grid with the given number of columns from scratch
+		std::shared_ptr<const GridIndex> build(const std::span<const Bounds> bounds, const std::size_t columnCount, const std::size_t rowCount);
+
+	private:
+		float cellSize;
+
+		std::shared_ptr<const GridIndex> grid;
+		std::vector<Bounds> previousBounds;
+	};
+
+}
+
+#endif // !CORE_SPATIAL_GRID_INDEX_HPP
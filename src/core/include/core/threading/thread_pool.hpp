@@ -0,0 +1,66 @@
+#ifndef CORE_THREADING_THREAD_POOL_HPP
+#define CORE_THREADING_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace core::threading {
+
+	// Fixed-size pool of worker threads that execute tasks in submission order
+	class ThreadPool final {
+	public:
+		// Create a pool - a thread count of zero uses one worker per hardware thread, minus the main thread
+		explicit ThreadPool(std::uint32_t threadCount = 0);
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+		~ThreadPool();
+
+		// Queue a task for execution on one of the workers, the returned future holds its result
+		template<typename Task>
+		std::future<std::invoke_result_t<Task>> submit(Task&& task) {
+			using Result = std::invoke_result_t<Task>;
+
+			// Packaged tasks are move-only, but std::function requires a copyable target
+			auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+			auto future = packagedTask->get_future();
+
+			enqueue([packagedTask]() { (*packagedTask)(); });
+			return future;
+		}
+
+		// Number of worker threads in this pool
+		std::uint32_t getThreadCount() const;
+
+		// Returns whether the calling thread is one of this pool's workers
+		bool isWorkerThread() const;
+
+	private:
+		// Add a type-erased task to the queue and wake up a worker
+		void enqueue(std::function<void()> task);
+
+		// Main loop of every worker thread
+		void work();
+
+	private:
+		std::vector<std::thread> workers;
+		std::queue<std::function<void()>> tasks;
+
+		std::mutex mutex;
+		std::condition_variable condition;
+
+		bool isStopping;
+	};
+
+}
+
+#endif // !CORE_THREADING_THREAD_POOL_HPP
@@ -0,0 +1,37 @@
+#include "core/logging/async_logging.hpp"
+
+#include "spdlog/async.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/spdlog.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+using namespace core::logging;
+
+// Messages that can wait for the background thread, further messages overwrite the oldest queued ones
+constexpr std::size_t LOG_QUEUE_SIZE = 8'192;
+
+// How often the background thread flushes the console, errors are flushed right away
+constexpr std::chrono::seconds LOG_FLUSH_INTERVAL{ 1 };
+
+AsyncLogging::AsyncLogging() {
+	// A single thread keeps messages in the order they were logged
+	spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+
+	auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+	auto logger = std::make_shared<spdlog::async_logger>("plain", std::move(sink), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+
+	// Let the level set at compile time decide, rather than discarding messages a second time at runtime
+	logger->set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
+	logger->flush_on(spdlog::level::err);
+
+	spdlog::set_default_logger(std::move(logger));
+	spdlog::flush_every(LOG_FLUSH_INTERVAL);
+}
+
+AsyncLogging::~AsyncLogging() {
+	spdlog::shutdown();
+}
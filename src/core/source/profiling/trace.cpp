@@ -0,0 +1,192 @@
+#include "core/profiling/trace.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace core::profiling;
+
+// Events every thread can record, further events are dropped
+constexpr std::size_t EVENTS_PER_THREAD = 65'536;
+
+struct TraceEvent {
+	const char* name;
+
+	// Nanoseconds since the process started
+	std::uint64_t start;
+	std::uint64_t duration;
+};
+
+// Only the owning thread appends events, "count" publishes them to the thread that writes the trace
+// Events are allocated by the first event the thread records, naming a thread is cheap
+struct ThreadBuffer {
+	std::uint32_t id{ 0 };
+	std::unique_ptr<TraceEvent[]> events{};
+	std::atomic<std::size_t> count{ 0 };
+	std::atomic<std::size_t> droppedCount{ 0 };
+
+	// Guarded by the registry mutex
+	std::string name{};
+};
+
+// Buffers outlive their threads, pool workers may exit before the trace is written
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+
+static std::atomic<bool> isRecording{ false };
+static const auto epoch = std::chrono::steady_clock::now();
+
+static std::uint64_t getTimestamp() {
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+// The buffer of the calling thread, which is registered the first time the thread records an event or is named
+static ThreadBuffer& getThreadBuffer() {
+	thread_local ThreadBuffer* buffer = nullptr;
+
+	if (buffer == nullptr) {
+		auto newBuffer = std::make_unique<ThreadBuffer>();
+
+		std::lock_guard lock{ registryMutex };
+		newBuffer->id = static_cast<std::uint32_t>(threadBuffers.size() + 1);
+		buffer = newBuffer.get();
+		threadBuffers.push_back(std::move(newBuffer));
+	}
+
+	return *buffer;
+}
+
+// Names are string literals chosen by the code base, escaping only guards against quotes and backslashes
+static void writeJsonString(std::ofstream& file, const std::string_view& text) {
+	file << '"';
+
+	for (const auto character : text) {
+		if (character == '"' || character == '\\') {
+			file << '\\';
+		}
+
+		file << character;
+	}
+
+	file << '"';
+}
+
+void core::profiling::startTracing() {
+	isRecording.store(true, std::memory_order_relaxed);
+}
+
+void core::profiling::stopTracing() {
+	isRecording.store(false, std::memory_order_relaxed);
+}
+
+bool core::profiling::isTracing() {
+	return isRecording.load(std::memory_order_relaxed);
+}
+
+void core::profiling::setThreadName(const std::string_view& name) {
+	auto& buffer = getThreadBuffer();
+
+	std::lock_guard lock{ registryMutex };
+	buffer.name = name;
+}
+
+bool core::profiling::writeTrace(const std::string_view& path) {
+	std::ofstream file(std::string(path), std::ios::trunc);
+
+	if (!file.is_open()) {
+		spdlog::error("Unable to open \"{}\" to write the trace to", path);
+		return false;
+	}
+
+	std::size_t eventCount = 0;
+	std::size_t droppedCount = 0;
+
+	// Timestamps are written in microseconds, as the trace event format expects
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	file.setf(std::ios::fixed);
+	file.precision(3);
+
+	auto isFirstEvent = true;
+
+	const auto separate = [&file, &isFirstEvent]() {
+		if (!isFirstEvent) {
+			file << ",\n";
+		}
+
+		isFirstEvent = false;
+	};
+
+	{
+		std::lock_guard lock{ registryMutex };
+
+		for (const auto& buffer : threadBuffers) {
+			separate();
+			file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":";
+			writeJsonString(file, buffer->name.empty() ? "Thread " + std::to_string(buffer->id) : buffer->name);
+			file << "}}";
+
+			const auto count = buffer->count.load(std::memory_order_acquire);
+
+			for (std::size_t i = 0; i < count; ++i) {
+				const auto& event = buffer->events[i];
+
+				separate();
+				file << "{\"ph\":\"X\",\"cat\":\"plain\",\"name\":";
+				writeJsonString(file, event.name);
+				file << ",\"pid\":1,\"tid\":" << buffer->id
+					<< ",\"ts\":" << static_cast<double>(event.start) / 1'000.0
+					<< ",\"dur\":" << static_cast<double>(event.duration) / 1'000.0 << '}';
+			}
+
+			eventCount += count;
+			droppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+		}
+	}
+
+	file << "]}\n";
+
+	if (!file.good()) {
+		spdlog::error("Failed to write the trace to \"{}\"", path);
+		return false;
+	}
+
+	if (droppedCount > 0) {
+		spdlog::warn("{} trace events were dropped because a thread recorded more than {} events", droppedCount, EVENTS_PER_THREAD);
+	}
+
+	spdlog::info("Wrote {} trace events to \"{}\"", eventCount, path);
+	return true;
+}
+
+TraceScope::TraceScope(const char* const eventName) :
+	name{ isTracing() ? eventName : nullptr },
+	start{ name != nullptr ? getTimestamp() : 0 } {}
+
+TraceScope::~TraceScope() {
+	if (name == nullptr || !isTracing()) {
+		return;
+	}
+
+	const auto end = getTimestamp();
+	auto& buffer = getThreadBuffer();
+	const auto index = buffer.count.load(std::memory_order_relaxed);
+
+	if (index == EVENTS_PER_THREAD) {
+		buffer.droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	if (!buffer.events) {
+		buffer.events = std::make_unique<TraceEvent[]>(EVENTS_PER_THREAD);
+	}
+
+	buffer.events[index] = { name, start, end - start };
+	buffer.count.store(index + 1, std::memory_order_release);
+}
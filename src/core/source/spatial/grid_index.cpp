@@ -0,0 +1,249 @@
+#include "core/spatial/grid_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
+
+using namespace core::spatial;
+
+// Items beyond this many cells along either axis share the cells along the edge, which keeps a stray huge box from allocating a huge grid
+constexpr std::size_t MAXIMUM_CELLS_PER_AXIS = 4'096;
+
+// Number of cells needed to cover everything up to a coordinate
+static std::size_t getCellCount(const float extent, const float cellSize) {
+	const auto count = std::ceil(extent / cellSize);
+
+	// Also rejects NaN
+	if (!(count > 1.0f)) {
+		return 1;
+	}
+
+	return std::min(static_cast<std::size_t>(count), MAXIMUM_CELLS_PER_AXIS);
+}
+
+// Cell that contains a coordinate, clamped to the grid
+static std::size_t getCell(const float coordinate, const float cellSize, const std::size_t count) {
+	const auto cell = std::floor(coordinate / cellSize);
+
+	if (!(cell > 0.0f)) {
+		return 0;
+	}
+
+	return std::min(static_cast<std::size_t>(cell), count - 1);
+}
+
+// Cell that contains the last pixel before a coordinate, areas that end exactly on a cell boundary do not reach into the next cell
+static std::size_t getLastCell(const float end, const float cellSize, const std::size_t count) {
+	const auto cell = std::ceil(end / cellSize) - 1.0f;
+
+	if (!(cell > 0.0f)) {
+		return 0;
+	}
+
+	return std::min(static_cast<std::size_t>(cell), count - 1);
+}
+
+void GridIndex::query(const Bounds& area, std::vector<std::uint32_t>& candidates) const {
+	candidates.clear();
+
+	if (itemCount == 0) {
+		return;
+	}
+
+	const auto range = getCellRange(area);
+	std::size_t cellsWithItems = 0;
+
+	for (auto row = range.firstRow; row <= range.lastRow; ++row) {
+		for (auto column = range.firstColumn; column <= range.lastColumn; ++column) {
+			const auto& cell = cells[row * columnCount + column];
+
+			if (cell != nullptr) {
+				candidates.insert(candidates.end(), cell->begin(), cell->end());
+				++cellsWithItems;
+			}
+		}
+	}
+
+	// A single cell is already sorted, items that span several cells have to be removed when merging more than one
+	if (cellsWithItems > 1) {
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	}
+}
+
+std::size_t GridIndex::size() const {
+	return itemCount;
+}
+
+GridIndex::CellRange GridIndex::getCellRange(const Bounds& area) const {
+	const auto firstColumn = getCell(area.x, cellSize, columnCount);
+	const auto firstRow = getCell(area.y, cellSize, rowCount);
+
+	return {
+		firstColumn,
+		std::max(firstColumn, getLastCell(area.x + area.width, cellSize, columnCount)),
+		firstRow,
+		std::max(firstRow, getLastCell(area.y + area.height, cellSize, rowCount))
+	};
+}
+
+GridIndexBuilder::GridIndexBuilder(const float cellSize) :
+	cellSize(cellSize),
+	grid{},
+	previousBounds{} {}
+
+std::shared_ptr<const GridIndex> GridIndexBuilder::update(const std::span<const Bounds> bounds) {
+	auto right = 0.0f;
+	auto bottom = 0.0f;
+
+	for (const auto& area : bounds) {
+		right = std::max(right, area.x + area.width);
+		bottom = std::max(bottom, area.y + area.height);
+	}
+
+	const auto columnCount = getCellCount(right, cellSize);
+
+	// The number of columns only changes along with the width of the page, which moves nearly everything anyway
+	if (grid == nullptr || grid->columnCount != columnCount) {
+		return build(bounds, columnCount, getCellCount(bottom, cellSize));
+	}
+
+	// Rows are only ever added, so the cells of the previous grid keep their position
+	auto next = std::shared_ptr<GridIndex>(new GridIndex());
+	next->cellSize = cellSize;
+	next->columnCount = columnCount;
+	next->rowCount = std::max(grid->rowCount, getCellCount(bottom, cellSize));
+	next->itemCount = bounds.size();
+	next->cells = grid->cells;
+	next->cells.resize(next->columnCount * next->rowCount);
+
+	std::vector<bool> isChanged(bounds.size(), false);
+	std::vector<bool> isCellDirty(next->cells.size(), false);
+	std::vector<std::size_t> dirtyCells;
+	std::size_t changedCount = 0;
+
+	const auto markCells = [&next, &isCellDirty, &dirtyCells](const Bounds& area) {
+		const auto range = next->getCellRange(area);
+
+		for (auto row = range.firstRow; row <= range.lastRow; ++row) {
+			for (auto column = range.firstColumn; column <= range.lastColumn; ++column) {
+				const auto cell = row * next->columnCount + column;
+
+				if (!isCellDirty[cell]) {
+					isCellDirty[cell] = true;
+					dirtyCells.push_back(cell);
+				}
+			}
+		}
+	};
+
+	const auto sharedCount = std::min(previousBounds.size(), bounds.size());
+
+	for (std::size_t i = 0; i < bounds.size(); ++i) {
+		if (i < sharedCount && bounds[i] == previousBounds[i]) {
+			continue;
+		}
+
+		if (i < sharedCount) {
+			markCells(previousBounds[i]);
+		}
+
+		markCells(bounds[i]);
+		isChanged[i] = true;
+		++changedCount;
+	}
+
+	for (auto i = sharedCount; i < previousBounds.size(); ++i) {
+		markCells(previousBounds[i]);
+	}
+
+	// Nothing moved, the previous grid is still accurate
+	if (dirtyCells.empty() && next->rowCount == grid->rowCount) {
+		return grid;
+	}
+
+	// Patching cells costs more than filling them from scratch once most items moved
+	if (changedCount > bounds.size() / 2) {
+		return build(bounds, columnCount, next->rowCount);
+	}
+
+	// Changed items are visited in ascending order, so the items added to every cell are sorted
+	std::unordered_map<std::size_t, std::vector<std::uint32_t>> addedItems;
+
+	for (std::size_t i = 0; i < bounds.size(); ++i) {
+		if (!isChanged[i]) {
+			continue;
+		}
+
+		const auto range = next->getCellRange(bounds[i]);
+
+		for (auto row = range.firstRow; row <= range.lastRow; ++row) {
+			for (auto column = range.firstColumn; column <= range.lastColumn; ++column) {
+				addedItems[row * columnCount + column].push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+
+	std::vector<std::uint32_t> keptItems;
+
+	for (const auto cell : dirtyCells) {
+		keptItems.clear();
+
+		if (const auto& previousItems = next->cells[cell]) {
+			std::copy_if(previousItems->begin(), previousItems->end(), std::back_inserter(keptItems), [&bounds, &isChanged](const std::uint32_t item) {
+				return item < bounds.size() && !isChanged[item];
+			});
+		}
+
+		const auto added = addedItems.find(cell);
+		std::vector<std::uint32_t> items;
+
+		if (added != addedItems.end()) {
+			items.reserve(keptItems.size() + added->second.size());
+			std::merge(keptItems.begin(), keptItems.end(), added->second.begin(), added->second.end(), std::back_inserter(items));
+		} else {
+			items = keptItems;
+		}
+
+		next->cells[cell] = items.empty() ? nullptr : std::make_shared<const std::vector<std::uint32_t>>(std::move(items));
+	}
+
+	grid = next;
+	previousBounds.assign(bounds.begin(), bounds.end());
+
+	return grid;
+}
+
+std::shared_ptr<const GridIndex> GridIndexBuilder::build(const std::span<const Bounds> bounds, const std::size_t columnCount, const std::size_t rowCount) {
+	auto next = std::shared_ptr<GridIndex>(new GridIndex());
+	next->cellSize = cellSize;
+	next->columnCount = columnCount;
+	next->rowCount = rowCount;
+	next->itemCount = bounds.size();
+
+	std::vector<std::vector<std::uint32_t>> cellItems(columnCount * rowCount);
+
+	for (std::size_t i = 0; i < bounds.size(); ++i) {
+		const auto range = next->getCellRange(bounds[i]);
+
+		for (auto row = range.firstRow; row <= range.lastRow; ++row) {
+			for (auto column = range.firstColumn; column <= range.lastColumn; ++column) {
+				cellItems[row * columnCount + column].push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+
+	next->cells.resize(cellItems.size());
+
+	for (std::size_t i = 0; i < cellItems.size(); ++i) {
+		if (!cellItems[i].empty()) {
+			next->cells[i] = std::make_shared<const std::vector<std::uint32_t>>(std::move(cellItems[i]));
+		}
+	}
+
+	grid = next;
+	previousBounds.assign(bounds.begin(), bounds.end());
+
+	return grid;
+}
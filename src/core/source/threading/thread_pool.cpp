@@ -0,0 +1,89 @@
+#include "core/threading/thread_pool.hpp"
+#include "core/profiling/trace.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace core::threading;
+
+ThreadPool::ThreadPool(std::uint32_t threadCount) :
+	workers{},
+	tasks{},
+	mutex{},
+	condition{},
+	isStopping{ false } {
+	if (threadCount == 0) {
+		// The main thread keeps itself busy as well, so leave one hardware thread for it
+		threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+	}
+
+	workers.reserve(threadCount);
+
+	for (std::uint32_t i = 0; i < threadCount; ++i) {
+		workers.emplace_back([this, i]() {
+			profiling::setThreadName("Worker " + std::to_string(i + 1));
+			work();
+		});
+	}
+
+	spdlog::debug("Thread pool started with {} worker{}", threadCount, threadCount != 1 ? "s" : "");
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock{ mutex };
+		isStopping = true;
+	}
+
+	condition.notify_all();
+
+	// Workers drain the queue before exiting, so no submitted task is ever dropped
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	spdlog::debug("Thread pool stopped");
+}
+
+std::uint32_t ThreadPool::getThreadCount() const {
+	return static_cast<std::uint32_t>(workers.size());
+}
+
+bool ThreadPool::isWorkerThread() const {
+	const auto id = std::this_thread::get_id();
+
+	return std::any_of(workers.begin(), workers.end(), [&id](const std::thread& worker) {
+		return worker.get_id() == id;
+	});
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+	{
+		std::lock_guard lock{ mutex };
+		tasks.push(std::move(task));
+	}
+
+	condition.notify_one();
+}
+
+void ThreadPool::work() {
+	while (true) {
+		std::function<void()> task;
+
+		{
+			std::unique_lock lock{ mutex };
+			condition.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+
+			if (tasks.empty()) {
+				return;
+			}
+
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+
+		task();
+	}
+}
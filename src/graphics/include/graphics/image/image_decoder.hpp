@@ -0,0 +1,48 @@
+#ifndef GRAPHICS_IMAGE_IMAGE_DECODER_HPP
+#define GRAPHICS_IMAGE_IMAGE_DECODER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace graphics::image {
+
+	enum class ImageFormat {
+		Png,
+		Ppm,
+		Jpeg,
+		WebP,
+		Gif,
+		Unknown
+	};
+
+	// Pixels of an image, ready to be handed to Renderer::createTexture()
+	struct DecodedImage {
+		// Size of the pixels, which is smaller than the image in the file when it was decoded to a smaller size
+		std::uint32_t width;
+		std::uint32_t height;
+
+		// Size of the image in the file
+		std::uint32_t intrinsicWidth;
+		std::uint32_t intrinsicHeight;
+
+		// Tightly packed RGBA with premultiplied alpha, which is what the image pipeline blends
+		std::vector<std::uint8_t> pixels;
+	};
+
+	// Recognize the format of an encoded image by its signature
+	ImageFormat detectImageFormat(const std::span<const std::uint8_t> data);
+
+	// Decode a PNG or binary PPM image, scaled down while decoding so it is no larger than "maxWidth" by "maxHeight"
+	// Each axis is scaled on its own, images are drawn stretched to their bounds - zero leaves an axis at its intrinsic size
+	// Rows are decompressed, unfiltered, and scaled down one at a time, so memory use grows with the width of the image and the size asked for
+	std::optional<DecodedImage> decodeImage(const std::span<const std::uint8_t> data, const std::uint32_t maxWidth = 0, const std::uint32_t maxHeight = 0);
+
+	// Read an image file and decode it, see decodeImage()
+	std::optional<DecodedImage> decodeImageFile(const std::string_view& path, const std::uint32_t maxWidth = 0, const std::uint32_t maxHeight = 0);
+
+}
+
+#endif // !GRAPHICS_IMAGE_IMAGE_DECODER_HPP
@@ -0,0 +1,118 @@
+#ifndef GRAPHICS_IMAGE_IMAGE_LOADER_HPP
+#define GRAPHICS_IMAGE_IMAGE_LOADER_HPP
+
+#include "image_decoder.hpp"
+
+#include "graphics/renderer/display_list.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace core::threading {
+	class ThreadPool;
+}
+
+namespace graphics {
+
+	namespace image {
+
+		// Handle to an image that was added to the loader
+		using ImageId = std::uint32_t;
+
+		// Create a texture from tightly packed RGBA pixels on the thread that owns the renderer, such as Compositor::createTexture()
+		// "onCreated" must be called on that thread once the texture exists, the future has to be ready by then
+		using CreateTextureFunction = std::function<std::future<renderer::TextureId>(const std::uint32_t width, const std::uint32_t height, std::vector<std::uint8_t> pixels, std::function<void()> onCreated)>;
+
+		// Decodes the images of a page on a thread pool, at the size they are laid out at, and hands them to the renderer
+		// Images are only decoded once they come close to the viewport, and only uploaded once they are inside it
+		// Decoded bitmaps that wait to come into view are discarded when they take more memory than the budget allows
+		class ImageLoader final {
+		public:
+			// Images are decoded on the workers of "threadPool", or on the calling thread of update() when it is a null pointer
+			// Textures are never created by the loader itself, the renderer may be owned by another thread
+			// "onProgress" is called on the decoding thread every time an image is decoded, and on the renderer's thread every time it received a texture
+			// It is meant to wake up the event loop, so update() picks up the result
+			ImageLoader(core::threading::ThreadPool* threadPool, CreateTextureFunction createTexture, std::function<void()> onProgress = {});
+			ImageLoader(const ImageLoader&) = delete;
+			ImageLoader(ImageLoader&&) = delete;
+			ImageLoader& operator=(const ImageLoader&) = delete;
+			ImageLoader& operator=(ImageLoader&&) = delete;
+			~ImageLoader() = default;
+
+			// Add an image file that is laid out at "bounds" in page coordinates, nothing is read until update() finds it near the viewport
+			ImageId add(std::string path, const renderer::Rectangle& bounds);
+
+			// Move an image after layout changed, an image that was not uploaded yet is decoded at its new size
+			void setBounds(const ImageId image, const renderer::Rectangle& bounds);
+
+			// Texture to paint the image with, NO_TEXTURE while it is not decoded yet or could not be decoded
+			renderer::TextureId getTexture(const ImageId image) const;
+
+			// Start decoding images near "viewport", upload decoded images inside it, and discard decoded bitmaps over the budget
+			// Returns whether an image received a texture since the previous update, the page should then be painted again
+			bool update(const renderer::Rectangle& viewport);
+
+			// Upper limit of memory held by decoded bitmaps that are not uploaded yet
+			void setMemoryBudget(const std::size_t bytes);
+
+			// Memory held by decoded bitmaps that are not uploaded yet
+			std::size_t getDecodedBytes() const;
+
+		private:
+			enum class State {
+				Unloaded,
+				Decoding,
+				Decoded,
+				Uploading,
+				Uploaded,
+				Failed
+			};
+
+			struct Image {
+				std::string path;
+				renderer::Rectangle bounds;
+				State state;
+
+				// Size the image is being decoded at, or was decoded at
+				std::uint32_t decodeWidth;
+				std::uint32_t decodeHeight;
+
+				std::future<std::optional<DecodedImage>> decode;
+				std::optional<DecodedImage> bitmap;
+				std::future<renderer::TextureId> upload;
+				renderer::TextureId texture;
+			};
+
+			// Queue the decode of an image at the size it is laid out at
+			void startDecode(Image& image);
+
+			// Release a decoded bitmap, the image is decoded again when it is needed
+			void discardBitmap(Image& image);
+
+			// Discard the bitmaps of the images farthest from the viewport until the decoded bitmaps fit the budget again, after it was lowered or the page moved
+			void enforceMemoryBudget(const renderer::Rectangle& viewport);
+
+		private:
+			core::threading::ThreadPool* threadPool;
+			CreateTextureFunction createTexture;
+			std::function<void()> onProgress;
+
+			std::vector<Image> images;
+
+			std::size_t memoryBudget;
+			std::size_t decodedBytes;
+
+			// Upper limit of the memory the decodes in progress will take
+			std::size_t pendingBytes;
+		};
+
+	}
+
+}
+
+#endif // !GRAPHICS_IMAGE_IMAGE_LOADER_HPP
@@ -0,0 +1,112 @@
+#ifndef GRAPHICS_IMAGE_INFLATE_HPP
+#define GRAPHICS_IMAGE_INFLATE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace graphics::image {
+
+	// Decompresses a zlib stream (RFC 1950 and 1951) piece by piece, so the caller never has to hold all of its output at once
+	// The stream may be split over several parts (such as the IDAT chunks of a PNG file), which are read as if they were concatenated
+	// The parts are not copied, they have to outlive the inflater
+	class Inflater final {
+	public:
+		explicit Inflater(std::vector<std::span<const std::uint8_t>> parts);
+		Inflater(const Inflater&) = delete;
+		Inflater(Inflater&&) = delete;
+		Inflater& operator=(const Inflater&) = delete;
+		Inflater& operator=(Inflater&&) = delete;
+		~Inflater() = default;
+
+		// Decompress the next bytes of the stream into "output", returns how many were written
+		// Fewer bytes than requested are only written once the end of the stream is reached
+		// Malformed data returns nothing, and so does every call after it
+		std::optional<std::size_t> read(const std::span<std::uint8_t> output);
+
+	private:
+		// Longest Huffman code deflate allows
+		static constexpr std::uint32_t MAX_CODE_LENGTH = 15;
+
+		// Codes up to this length are decoded with a single table lookup, longer codes one bit at a time
+		static constexpr std::uint32_t FAST_BITS = 9;
+
+		static constexpr std::size_t LITERAL_LENGTH_CODE_COUNT = 288;
+
+		// Back-references reach at most this many bytes into the output that was already produced
+		static constexpr std::size_t WINDOW_SIZE = 32'768;
+
+		// Reads the stream least significant bit first, as deflate packs it
+		struct BitReader {
+			std::vector<std::span<const std::uint8_t>> parts;
+			std::size_t partIndex;
+			std::size_t position;
+
+			// Zero bytes that were buffered after the end of the last part
+			std::size_t paddingBytes;
+
+			std::uint64_t buffer;
+			std::uint32_t count;
+
+			// Past the end of the data zero bits are read, isOverrun() tells whether any of those were consumed
+			std::uint32_t peek(const std::uint32_t bitCount);
+			void consume(const std::uint32_t bitCount);
+			std::uint32_t read(const std::uint32_t bitCount);
+			void alignToByte();
+			bool isOverrun() const;
+		};
+
+		// Canonical Huffman code, see https://www.rfc-editor.org/rfc/rfc1951#section-3.2.2
+		struct HuffmanTable {
+			// Number of codes of every length, and the symbols sorted by code
+			std::array<std::uint16_t, MAX_CODE_LENGTH + 1> counts;
+			std::array<std::uint16_t, LITERAL_LENGTH_CODE_COUNT> symbols;
+
+			// Indexed by the next "FAST_BITS" bits of the stream, entries hold the symbol and the length of its code (zero when longer)
+			std::array<std::uint16_t, 1 << FAST_BITS> fast;
+		};
+
+		enum class State {
+			BlockHeader,
+			StoredBlock,
+			CompressedBlock,
+			Finished,
+			Failed
+		};
+
+		static bool buildTable(HuffmanTable& table, const std::span<const std::uint8_t> lengths);
+		static std::optional<std::uint32_t> decodeSymbol(BitReader& reader, const HuffmanTable& table);
+		static bool readDynamicTables(BitReader& reader, HuffmanTable& literals, HuffmanTable& distances);
+		static void buildFixedTables(HuffmanTable& literals, HuffmanTable& distances);
+
+		// Read the header of the next block and prepare its tables
+		bool beginBlock();
+
+		// Append a byte to the output and remember it for later back-references
+		void emit(const std::uint8_t byte, std::uint8_t* const output);
+
+	private:
+		BitReader reader;
+		HuffmanTable literals;
+		HuffmanTable distances;
+		State state;
+		bool isFinalBlock;
+
+		// Bytes left in the current stored block
+		std::uint32_t storedRemaining;
+
+		// Back-reference that did not fit into the previous output
+		std::uint32_t copyLength;
+		std::uint32_t copyDistance;
+
+		// The last "WINDOW_SIZE" bytes of output, indexed by the total output size modulo the window size
+		std::vector<std::uint8_t> window;
+		std::uint64_t totalOutput;
+	};
+
+}
+
+#endif // !GRAPHICS_IMAGE_INFLATE_HPP
@@ -0,0 +1,27 @@
+#ifndef GRAPHICS_RENDERER_CACHE_FILE_HPP
+#define GRAPHICS_RENDERER_CACHE_FILE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace graphics::renderer {
+
+	// Seed of "hashBytes", pass the result of a previous call instead to hash multiple ranges as one
+	constexpr std::uint64_t HASH_SEED = 14'695'981'039'346'656'037ull;
+
+	// 64-bit FNV-1a hash, used to key and validate cache entries
+	std::uint64_t hashBytes(const std::span<const std::uint8_t> bytes, const std::uint64_t seed = HASH_SEED);
+
+	// Read the entire contents of a cache file, returns nothing when the file does not exist or cannot be read
+	std::optional<std::vector<std::uint8_t>> readCacheFile(const std::filesystem::path& path);
+
+	// Replace the contents of a cache file, the parent directories are created when needed
+	// The data is written to a temporary file first, so a crash never leaves a truncated cache file behind
+	bool writeCacheFile(const std::filesystem::path& path, const std::span<const std::uint8_t> bytes);
+
+}
+
+#endif // !GRAPHICS_RENDERER_CACHE_FILE_HPP
@@ -0,0 +1,182 @@
+#ifndef GRAPHICS_RENDERER_COMPOSITOR_HPP
+#define GRAPHICS_RENDERER_COMPOSITOR_HPP
+
+#include "display_list.hpp"
+#include "frame_pacer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace graphics {
+
+	namespace window {
+		class Window;
+	}
+
+	namespace renderer {
+
+		class Renderer;
+
+		// Transform and opacity of a layer, the transform is applied around the center of the viewport in the order scale, rotate, translate
+		struct LayerProperties {
+			// Offset in pixels
+			float translateX;
+			float translateY;
+
+			// Uniform scale factor
+			float scale;
+
+			// Clockwise, in radians
+			float rotation;
+
+			// Between fully transparent (0) and opaque (1)
+			float opacity;
+		};
+
+		// Properties of a layer that is drawn as it was rasterized
+		constexpr LayerProperties DEFAULT_LAYER_PROPERTIES{ 0.0f, 0.0f, 1.0f, 0.0f, 1.0f };
+
+		// How an animation progresses over its duration
+		enum class Easing {
+			Linear,
+
+			// Starts and ends slowly
+			EaseInOut
+		};
+
+		// Transition between two sets of layer properties, evaluated by the compositor every frame
+		struct LayerAnimation {
+			LayerProperties from;
+			LayerProperties to;
+			FramePacer::Clock::duration duration;
+			Easing easing;
+		};
+
+		// Everything the compositor needs to draw a page, produced by the main thread and never modified once it is committed
+		// The page is a single layer for now, whose contents are rasterized into tiles by the renderer
+		struct LayerTree {
+			DisplayList displayList;
+
+			// Size of the page in pixels, which limits how far it can be scrolled
+			float contentWidth;
+			float contentHeight;
+
+			// Properties of the page layer while no animation is running
+			LayerProperties properties;
+
+			// Starts when the compositor picks up the tree, afterwards the layer keeps the properties the animation ended with
+			std::optional<LayerAnimation> animation;
+		};
+
+		// Owns the renderer on a thread of its own, which scrolls, animates, and presents every frame without waiting for the main thread
+		// The main thread hands over layer trees, scroll input, and resizes - a busy main thread only delays new content, never a frame
+		class Compositor final {
+		public:
+			// The window is only used to read its size, which is safe from any thread
+			Compositor(Renderer& renderer, const window::Window& window);
+			Compositor(const Compositor&) = delete;
+			Compositor(Compositor&&) = delete;
+			Compositor& operator=(const Compositor&) = delete;
+			Compositor& operator=(Compositor&&) = delete;
+			~Compositor();
+
+			// Start the compositor thread, the renderer must not be used by any other thread until stop() returns
+			bool start();
+
+			// Stop the compositor thread once it finishes its current frame, after which the renderer belongs to the calling thread again
+			void stop();
+
+			// Replace the page that is drawn, a tree that was not picked up yet is dropped in favor of this one
+			void commit(LayerTree layerTree);
+
+			// Scroll the page by a distance in pixels, the compositor eases into the new position over the next frames
+			void scrollBy(const float deltaX, const float deltaY);
+
+			// Rebuild the swapchain at the current size of the window
+			void resize();
+
+			// Record that the user interacted with the page, see Renderer::notifyInput()
+			void notifyInput();
+
+			// Have the thread that owns the renderer create a texture, see Renderer::createTexture()
+			// "onCreated" is called on that thread once the texture exists, the future is ready by then
+			// The texture is created right away when the compositor is not running
+			std::future<TextureId> createTexture(const std::uint32_t width, const std::uint32_t height, std::vector<std::uint8_t> pixels, std::function<void()> onCreated = {});
+
+			// Scroll offset of the most recent frame, may be called from any thread
+			float getScrollX() const;
+			float getScrollY() const;
+
+		private:
+			// Texture the main thread asked for, created on the compositor thread before its next frame
+			struct TextureRequest {
+				std::uint32_t width;
+				std::uint32_t height;
+				std::vector<std::uint8_t> pixels;
+				std::function<void()> onCreated;
+				std::promise<TextureId> texture;
+			};
+
+			// Main loop of the compositor thread
+			void run();
+
+			// Create the textures of the requests and fulfill their promises
+			void createTextures(std::vector<TextureRequest>& requests);
+
+			// Returns whether the main thread handed over anything since the compositor last looked, the mutex must be held
+			bool hasPendingWork() const;
+
+			// Move scrolling and the layer animation forward to "now", returns whether either still has further to go
+			bool animate(const FramePacer::Clock::time_point now);
+
+		private:
+			Renderer& renderer;
+			const window::Window& window;
+
+			std::thread thread;
+
+			// Time between two refreshes of the display, which is how long the thread waits when an animation did not change a pixel
+			FramePacer::Clock::duration frameInterval;
+
+			// Guards everything the main thread hands over
+			std::mutex mutex;
+			std::condition_variable wakeCondition;
+			std::unique_ptr<LayerTree> pendingTree;
+			float pendingScrollX;
+			float pendingScrollY;
+			bool isResizePending;
+			bool isInputPending;
+			bool isStopping;
+			std::vector<TextureRequest> pendingTextures;
+
+			// Only used by the compositor thread
+			float contentWidth;
+			float contentHeight;
+			float targetScrollX;
+			float targetScrollY;
+			float currentScrollX;
+			float currentScrollY;
+			LayerProperties layerProperties;
+			std::optional<LayerAnimation> animation;
+			FramePacer::Clock::time_point animationStart;
+			FramePacer::Clock::time_point previousTick;
+
+			// Published after every frame for hit testing on the main thread
+			std::atomic<float> scrollX;
+			std::atomic<float> scrollY;
+		};
+
+	}
+
+}
+
+#endif // !GRAPHICS_RENDERER_COMPOSITOR_HPP
@@ -0,0 +1,17 @@
+#ifndef GRAPHICS_RENDERER_DAMAGE_TRACKER_HPP
+#define GRAPHICS_RENDERER_DAMAGE_TRACKER_HPP
+
+#include "display_list.hpp"
+
+#include <vector>
+
+namespace graphics::renderer {
+
+	// Collect the areas of a page that look different after replacing one display list with another
+	// Items that are identical and keep their order are skipped, every item that was removed, added, or changed damages its paint bounds
+	// Lists that need more than a fixed number of edits are treated as entirely different past their identical start and end
+	void computeDamage(const DisplayList& previous, const DisplayList& next, std::vector<Rectangle>& damage);
+
+}
+
+#endif // !GRAPHICS_RENDERER_DAMAGE_TRACKER_HPP
@@ -0,0 +1,105 @@
+#ifndef GRAPHICS_RENDERER_DISPLAY_LIST_HPP
+#define GRAPHICS_RENDERER_DISPLAY_LIST_HPP
+
+#include "graphics/text/font_collection.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace graphics::renderer {
+
+	// Handle to a texture that was registered with the renderer
+	using TextureId = std::uint32_t;
+
+	constexpr TextureId NO_TEXTURE = std::numeric_limits<TextureId>::max();
+
+	// Axis-aligned rectangle in pixels, the origin is the top-left corner of the page
+	struct Rectangle {
+		float x;
+		float y;
+		float width;
+		float height;
+
+		// Returns whether both rectangles share at least one pixel
+		bool intersects(const Rectangle& other) const {
+			return x < other.x + other.width && other.x < x + width && y < other.y + other.height && other.y < y + height;
+		}
+
+		bool operator==(const Rectangle&) const = default;
+	};
+
+	enum class DisplayItemType : std::uint8_t {
+		// Solid colored rectangle
+		Rectangle,
+
+		// Outline of a rectangle, drawn on the inside of its bounds
+		Border,
+
+		// Textured rectangle
+		Image,
+
+		// Run of text in a single font and size, positioned at its baseline
+		GlyphRun
+	};
+
+	// A single drawing command
+	struct DisplayItem {
+		DisplayItemType type;
+		Rectangle bounds;
+
+		// Color as RGBA (ignored by images)
+		std::uint32_t color;
+
+		// Only used by borders
+		float borderWidth;
+
+		// Only used by images
+		TextureId texture;
+
+		// Only used by glyph runs, the text is stored in the display list
+		text::FontId font;
+		std::uint32_t pixelSize;
+		float baseline;
+		std::uint32_t textOffset;
+		std::uint32_t textLength;
+	};
+
+	// Area an item may paint into, which can be larger than its layout bounds (glyphs overhang the line they sit on)
+	Rectangle getPaintBounds(const DisplayItem& item);
+
+	// Flat, ordered list of drawing commands that describe a page - items are painted in the order they were added
+	class DisplayList final {
+	public:
+		// Add a solid rectangle
+		void pushRectangle(const Rectangle& bounds, const std::uint32_t color);
+
+		// Add a border of the given width along the inside of the bounds
+		void pushBorder(const Rectangle& bounds, const float width, const std::uint32_t color);
+
+		// Add an image that is stretched to fill the bounds
+		void pushImage(const Rectangle& bounds, const TextureId texture);
+
+		// Add a run of text - "bounds" covers the line the text sits on, "baseline" is the absolute y-coordinate of the baseline
+		void pushGlyphRun(const Rectangle& bounds, const float baseline, const text::FontId font, const std::uint32_t pixelSize, const std::string_view& text, const std::uint32_t color);
+
+		// Remove all items
+		void clear();
+
+		// All items in paint order
+		std::span<const DisplayItem> getItems() const;
+
+		// Text of a glyph run
+		std::string_view getText(const DisplayItem& item) const;
+
+	private:
+		std::vector<DisplayItem> items;
+		std::string text;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_DISPLAY_LIST_HPP
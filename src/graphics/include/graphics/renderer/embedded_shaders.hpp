@@ -0,0 +1,32 @@
+#ifndef GRAPHICS_RENDERER_EMBEDDED_SHADERS_HPP
+#define GRAPHICS_RENDERER_EMBEDDED_SHADERS_HPP
+
+// SPIR-V bytecode of the shaders in "resources/shaders", compiled by the build
+// The included word lists are generated by glslc, which is why this header is only available inside the graphics library
+#ifndef PLAIN_RUNTIME_SHADER_COMPILATION
+
+#include <cstdint>
+
+namespace graphics::renderer::shaders {
+
+	constexpr std::uint32_t QUAD_VERTEX[] = {
+#include "quad.vs.inc"
+	};
+
+	constexpr std::uint32_t SOLID_FRAGMENT[] = {
+#include "solid.fs.inc"
+	};
+
+	constexpr std::uint32_t IMAGE_FRAGMENT[] = {
+#include "image.fs.inc"
+	};
+
+	constexpr std::uint32_t TEXT_FRAGMENT[] = {
+#include "text.fs.inc"
+	};
+
+}
+
+#endif // !PLAIN_RUNTIME_SHADER_COMPILATION
+
+#endif // !GRAPHICS_RENDERER_EMBEDDED_SHADERS_HPP
@@ -0,0 +1,115 @@
+#ifndef GRAPHICS_RENDERER_FRAME_PACER_HPP
+#define GRAPHICS_RENDERER_FRAME_PACER_HPP
+
+#include "vulkan/vulkan.h"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace graphics::renderer {
+
+	// How frames are paced against the refresh rate of the display
+	enum class PacingPolicy {
+		// Mailbox presentation capped at the refresh rate, a frame always shows the most recent input
+		LowLatency,
+
+		// FIFO presentation, the GPU never renders frames that are not shown
+		PowerSaving,
+
+		// Low latency while the user interacts with the page, power saving otherwise
+		Adaptive
+	};
+
+	// Averages over recent frames, in milliseconds
+	struct FrameStatistics {
+		// Recording and submitting a frame
+		double cpuTime;
+
+		// Submission until the GPU finished the frame, only sampled when the CPU had to wait for it
+		double gpuTime;
+
+		// First input event a frame handles until the frame is handed to the presentation engine
+		double inputLatency;
+
+		// Between two presented frames
+		double frameInterval;
+	};
+
+	// Chooses the present mode, decides when the next frame should start, and measures frame times
+	class FramePacer final {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		FramePacer(const PacingPolicy policy, const std::uint32_t framesInFlight);
+		FramePacer(const FramePacer&) = delete;
+		FramePacer(FramePacer&&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+		FramePacer& operator=(FramePacer&&) = delete;
+		~FramePacer() = default;
+
+		void setPolicy(const PacingPolicy newPolicy);
+		PacingPolicy getPolicy() const;
+
+		// Refresh rate of the display in hertz, zero leaves the frame rate uncapped
+		void setRefreshRate(const std::uint32_t hertz);
+
+		// Pick the present mode that suits the policy and recent activity, among the modes the surface supports
+		VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR>& availableModes);
+
+		// Returns whether the swapchain should be recreated because a different present mode suits the policy better now
+		bool shouldChangePresentMode(const VkPresentModeKHR currentMode) const;
+
+		// Record that the user interacted with the page, the next presented frame is considered to respond to it
+		void notifyInput();
+
+		// The frame in slot "frameSlot" is finished, "hasWaited" tells whether the CPU had to wait for its fence
+		void retireFrame(const std::uint32_t frameSlot, const bool hasWaited);
+
+		// Called before a frame is recorded
+		void beginFrame();
+
+		// Called instead of endFrame() when a frame is dropped before it was submitted, it is left out of the statistics
+		void cancelFrame();
+
+		// Called once the frame in slot "frameSlot" was submitted
+		void endFrame(const std::uint32_t frameSlot);
+
+		// Called once a frame was handed to the presentation engine
+		void present();
+
+		// Time until the next frame should start, zero when it can start right away
+		Clock::duration getTimeUntilNextFrame() const;
+
+		FrameStatistics getStatistics() const;
+
+	private:
+		// Returns whether the user interacted with the page recently enough for frames to favor latency over power
+		bool isInteractive() const;
+
+		// Present mode that suits the policy right now, among the modes passed to choosePresentMode()
+		VkPresentModeKHR getPreferredPresentMode() const;
+
+	private:
+		PacingPolicy policy;
+		Clock::duration refreshInterval;
+		std::vector<VkPresentModeKHR> presentModes;
+
+		std::optional<Clock::time_point> frameStart;
+		std::optional<Clock::time_point> previousPresent;
+		std::optional<Clock::time_point> lastInput;
+
+		// Earliest input that no presented frame responded to yet
+		std::optional<Clock::time_point> pendingInput;
+
+		// Indexed by frame slot
+		std::vector<std::optional<Clock::time_point>> submissionTimes;
+
+		FrameStatistics statistics;
+		Clock::time_point lastStatisticsLog;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_FRAME_PACER_HPP
@@ -0,0 +1,85 @@
+#ifndef GRAPHICS_RENDERER_GPU_PROFILER_HPP
+#define GRAPHICS_RENDERER_GPU_PROFILER_HPP
+
+#include "vulkan/vulkan.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace graphics::renderer {
+
+	// GPU time of a pass, averaged over recent frames
+	struct PassTiming {
+		std::string_view name;
+		double milliseconds;
+	};
+
+	// Measures how long the GPU spends on passes by writing timestamps around their commands
+	// Every frame in flight has its own query pool, which is read once the fence of its frame is signaled, so reading never stalls
+	class GpuProfiler final {
+	public:
+		GpuProfiler(const VkDevice& device);
+		GpuProfiler(const GpuProfiler&) = delete;
+		GpuProfiler(GpuProfiler&&) = delete;
+		GpuProfiler& operator=(const GpuProfiler&) = delete;
+		GpuProfiler& operator=(GpuProfiler&&) = delete;
+		~GpuProfiler() = default;
+
+		// Create a query pool per frame in flight, profiling is disabled (but not an error) when "queueFamily" cannot write timestamps
+		bool create(const VkPhysicalDevice& physicalDevice, const std::uint32_t queueFamily, const std::uint32_t framesInFlight);
+
+		// Collect the timings the frame in "frameSlot" recorded the last time it was used, and reset its queries
+		// The fence of that frame must be signaled, and no render pass may be active in "commandBuffer"
+		void beginFrame(const VkCommandBuffer& commandBuffer, const std::uint32_t frameSlot);
+
+		// Write a timestamp before the commands of a pass, passes may be nested - "name" must outlive the profiler
+		void beginPass(const VkCommandBuffer& commandBuffer, const std::string_view& name);
+
+		// Write a timestamp after the commands of the pass that was begun most recently
+		void endPass(const VkCommandBuffer& commandBuffer);
+
+		// Averages of recent frames, in the order the passes were first recorded
+		std::span<const PassTiming> getTimings() const;
+
+		// Returns whether the device can write timestamps
+		bool isEnabled() const;
+
+		// Deallocate resources, the GPU must not be using any query pool
+		void destroy();
+
+	private:
+		// Queries of a frame in flight, pass "i" owns queries "2 * i" and "2 * i + 1"
+		struct FrameQueries {
+			VkQueryPool queryPool;
+			std::vector<std::string_view> passes;
+		};
+
+		// Fold the results of a frame into the averages
+		void collect(FrameQueries& frame);
+
+	private:
+		const VkDevice& device;
+
+		std::vector<FrameQueries> frames;
+		std::uint32_t currentFrame;
+
+		// Indices into the passes of the current frame, a pass that did not fit the query pool is not measured
+		std::vector<std::size_t> openPasses;
+
+		std::vector<std::uint64_t> results;
+		std::vector<PassTiming> timings;
+
+		// Nanoseconds per timestamp tick, and the bits of a timestamp that are valid
+		double timestampPeriod;
+		std::uint64_t timestampMask;
+
+		std::chrono::steady_clock::time_point lastLog;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_GPU_PROFILER_HPP
@@ -0,0 +1,16 @@
+#ifndef GRAPHICS_RENDERER_IMAGE_WRITER_HPP
+#define GRAPHICS_RENDERER_IMAGE_WRITER_HPP
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace graphics::renderer {
+
+	// Write tightly packed 8-bit RGBA pixels to disk, the file extension (".png" or ".ppm") selects the format
+	// PNG files are written without compression, which keeps them exact and avoids a dependency on zlib
+	bool writeImage(const std::string_view& path, const std::uint32_t width, const std::uint32_t height, const std::span<const std::uint8_t> pixels);
+
+}
+
+#endif // !GRAPHICS_RENDERER_IMAGE_WRITER_HPP
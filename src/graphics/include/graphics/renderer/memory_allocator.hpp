@@ -0,0 +1,141 @@
+#ifndef GRAPHICS_RENDERER_MEMORY_ALLOCATOR_HPP
+#define GRAPHICS_RENDERER_MEMORY_ALLOCATOR_HPP
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace graphics::renderer {
+
+	// Buffers and images are kept in separate pools, so neighbouring allocations can never violate "bufferImageGranularity"
+	enum class ResourceKind : std::uint8_t {
+		Buffer,
+		Image
+	};
+
+	// A range of device memory handed out by the allocator, an allocation without memory is empty
+	struct Allocation {
+		VkDeviceMemory memory;
+		VkDeviceSize offset;
+		VkDeviceSize size;
+
+		// Points at "offset" within the persistently mapped block, null when the memory is not host visible
+		std::uint8_t* mappedData;
+
+		// Identify the block the range was taken from
+		std::uint32_t poolIndex;
+		std::uint32_t blockIndex;
+	};
+
+	// Snapshot of the memory owned by the allocator
+	struct MemoryStatistics {
+		// Number of device memory allocations, which the driver limits to "maxMemoryAllocationCount"
+		std::uint32_t blockCount;
+
+		// Blocks that hold a single large resource
+		std::uint32_t dedicatedBlockCount;
+
+		std::uint64_t allocationCount;
+
+		// Device memory allocated from the driver, and the part of it that is handed out
+		VkDeviceSize reservedBytes;
+		VkDeviceSize usedBytes;
+	};
+
+	// Sub-allocates buffers and images from large blocks of device memory, with a pool of blocks per memory type and resource kind
+	// New allocations prefer the fullest block they fit in, which lets sparsely used blocks drain so they can be released
+	class MemoryAllocator final {
+	public:
+		MemoryAllocator(const VkDevice& device);
+		MemoryAllocator(const MemoryAllocator&) = delete;
+		MemoryAllocator(MemoryAllocator&&) = delete;
+		MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+		MemoryAllocator& operator=(MemoryAllocator&&) = delete;
+		~MemoryAllocator() = default;
+
+		// Query the memory types and heaps of the device
+		bool initialize(const VkPhysicalDevice& physicalDevice);
+
+		// Find room for a resource with the given requirements, host visible memory is mapped automatically
+		std::optional<Allocation> allocate(const VkMemoryRequirements& requirements, const VkMemoryPropertyFlags properties, const ResourceKind kind);
+
+		// Allocate memory for a buffer and bind it
+		std::optional<Allocation> allocateBuffer(const VkBuffer& buffer, const VkMemoryPropertyFlags properties);
+
+		// Allocate memory for an image and bind it
+		std::optional<Allocation> allocateImage(const VkImage& image, const VkMemoryPropertyFlags properties);
+
+		// Return a range to its block, the GPU must be done with the resource that was bound to it
+		void free(Allocation& allocation);
+
+		// Returns whether an allocation lives in a sparsely used block whose other allocations fit elsewhere in the pool
+		// Moving such allocations (allocate a new range first, then free the old one) eventually empties the block
+		bool shouldRelocate(const Allocation& allocation) const;
+
+		// Returns whether any block is sparse enough that relocating its allocations would release it
+		bool isFragmented() const;
+
+		MemoryStatistics getStatistics() const;
+
+		// Print the statistics of every pool that holds memory
+		void logStatistics() const;
+
+		// Release every block, all allocations must have been freed
+		void destroy();
+
+	private:
+		// Unused range within a block
+		struct FreeRange {
+			VkDeviceSize offset;
+			VkDeviceSize size;
+		};
+
+		// Single device memory allocation that ranges are handed out from, a block without memory is an unused slot
+		struct Block {
+			VkDeviceMemory memory;
+			VkDeviceSize size;
+			std::uint8_t* mappedData;
+
+			// Sorted by offset, neighbouring ranges are always merged
+			std::vector<FreeRange> freeRanges;
+
+			VkDeviceSize usedBytes;
+			std::uint32_t allocationCount;
+
+			// Created for a single resource that is too large to share a block
+			bool isDedicated;
+		};
+
+		// Blocks of a single memory type that hold a single kind of resource
+		struct Pool {
+			std::uint32_t memoryType;
+			ResourceKind kind;
+			VkDeviceSize blockSize;
+			std::vector<Block> blocks;
+		};
+
+		// Allocate a new block of device memory in a pool, returns its index
+		std::optional<std::uint32_t> createBlock(Pool& pool, const VkDeviceSize size, const bool isDedicated);
+
+		// Carve a range out of a block, returns nothing when it does not fit
+		std::optional<VkDeviceSize> allocateFromBlock(Block& block, const VkDeviceSize size, const VkDeviceSize alignment);
+
+		// Whether a block is used little enough that relocating its allocations is worth it
+		bool isSparse(const Pool& pool, const Block& block) const;
+
+	private:
+		const VkDevice& device;
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+
+		// Indexed by memory type * 2 + resource kind
+		std::vector<Pool> pools;
+
+		mutable std::mutex mutex;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_MEMORY_ALLOCATOR_HPP
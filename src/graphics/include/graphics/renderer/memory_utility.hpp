@@ -0,0 +1,19 @@
+#ifndef GRAPHICS_RENDERER_MEMORY_UTILITY_HPP
+#define GRAPHICS_RENDERER_MEMORY_UTILITY_HPP
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace graphics::renderer {
+
+	// Find a memory type that is allowed by "typeBits" and has all of the requested properties
+	std::optional<std::uint32_t> findMemoryType(const VkPhysicalDevice& physicalDevice, const std::uint32_t typeBits, const VkMemoryPropertyFlags properties);
+
+	// Same as above, for callers that already queried the memory properties of the device
+	std::optional<std::uint32_t> findMemoryType(const VkPhysicalDeviceMemoryProperties& memoryProperties, const std::uint32_t typeBits, const VkMemoryPropertyFlags properties);
+
+}
+
+#endif // !GRAPHICS_RENDERER_MEMORY_UTILITY_HPP
@@ -0,0 +1,68 @@
+#ifndef GRAPHICS_RENDERER_PARALLEL_RECORDER_HPP
+#define GRAPHICS_RENDERER_PARALLEL_RECORDER_HPP
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace core::threading {
+	class ThreadPool;
+}
+
+namespace graphics::renderer {
+
+	// Records the commands of a single item, "commandBuffer" is a secondary command buffer that was begun for it
+	using RecordFunction = std::function<void(const std::uint32_t item, const VkCommandBuffer& commandBuffer)>;
+
+	// Records items of a frame into secondary command buffers on the workers of a thread pool, the primary buffer only executes them
+	// Items are split into contiguous chunks, one per worker and one for the calling thread
+	// Every chunk has its own command pool per frame in flight, so no pool is ever used by two threads at once
+	class ParallelRecorder final {
+	public:
+		// Chunks are recorded on the calling thread only when "threadPool" is a null pointer
+		ParallelRecorder(const VkDevice& device, core::threading::ThreadPool* threadPool);
+		ParallelRecorder(const ParallelRecorder&) = delete;
+		ParallelRecorder(ParallelRecorder&&) = delete;
+		ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+		ParallelRecorder& operator=(ParallelRecorder&&) = delete;
+		~ParallelRecorder() = default;
+
+		// Create the command pools of every chunk for every frame in flight
+		bool create(const std::uint32_t queueFamily, const std::uint32_t framesInFlight);
+
+		// Record one secondary command buffer per item, which continue a render pass compatible with "renderPass"
+		// The buffers are written to "commandBuffers" in item order, and stay valid until "frameSlot" is recorded again
+		// The fence of the frame that last used "frameSlot" must be signaled
+		bool record(const std::uint32_t frameSlot, const std::uint32_t itemCount, const VkRenderPass& renderPass, const RecordFunction& recordItem, std::vector<VkCommandBuffer>& commandBuffers);
+
+		// Number of threads that record at the same time
+		std::uint32_t getChunkCount() const;
+
+		// Deallocate resources, the GPU must not be executing any recorded command buffer
+		void destroy();
+
+	private:
+		// Command buffers of a chunk in a frame in flight, buffers are reused once the pool is reset
+		struct ChunkPool {
+			VkCommandPool commandPool;
+			std::vector<VkCommandBuffer> commandBuffers;
+		};
+
+		// Record the items "[firstItem, lastItem)" with the pool of a chunk
+		bool recordChunk(ChunkPool& pool, const std::uint32_t firstItem, const std::uint32_t lastItem, const VkRenderPass& renderPass, const RecordFunction& recordItem, std::vector<VkCommandBuffer>& commandBuffers);
+
+	private:
+		const VkDevice& device;
+		core::threading::ThreadPool* threadPool;
+
+		std::uint32_t chunkCount;
+
+		// Indexed by "frameSlot * chunkCount + chunk"
+		std::vector<ChunkPool> pools;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_PARALLEL_RECORDER_HPP
@@ -0,0 +1,59 @@
+#ifndef GRAPHICS_RENDERER_PIPELINE_CACHE_HPP
+#define GRAPHICS_RENDERER_PIPELINE_CACHE_HPP
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <filesystem>
+
+namespace graphics::renderer {
+
+	// Vulkan pipeline cache that is persisted to disk, so pipelines compiled by one run are reused by the next
+	// The file is only loaded when it was written on the same device with the same driver version
+	class PipelineCache final {
+	public:
+		PipelineCache(const VkDevice& device);
+		PipelineCache(const PipelineCache&) = delete;
+		PipelineCache(PipelineCache&&) = delete;
+		PipelineCache& operator=(const PipelineCache&) = delete;
+		PipelineCache& operator=(PipelineCache&&) = delete;
+		~PipelineCache() = default;
+
+		// Create the pipeline cache, seeded with the contents of "cachePath" when it holds a compatible cache
+		bool create(const VkPhysicalDevice& physicalDevice, const std::filesystem::path& cachePath);
+
+		// Write the current contents of the pipeline cache back to disk
+		bool save() const;
+
+		// Destroy the pipeline cache without saving it
+		void destroy();
+
+		// Access the raw handle to the Vulkan object
+		const VkPipelineCache& handle() const;
+
+	private:
+		// Prepended to the data returned by the driver, the header written by the driver itself does not contain the driver version
+		struct FileHeader {
+			std::uint64_t dataSize;
+			std::uint64_t dataHash;
+			std::uint32_t magic;
+			std::uint32_t vendorId;
+			std::uint32_t deviceId;
+			std::uint32_t driverVersion;
+			std::uint8_t pipelineCacheUuid[VK_UUID_SIZE];
+		};
+
+		// Header that data written with the properties of the current device must have
+		FileHeader expectedHeader() const;
+
+	private:
+		const VkDevice& device;
+		VkPipelineCache pipelineCache;
+
+		VkPhysicalDeviceProperties deviceProperties;
+		std::filesystem::path path;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_PIPELINE_CACHE_HPP
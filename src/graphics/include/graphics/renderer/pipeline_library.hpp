@@ -0,0 +1,124 @@
+#ifndef GRAPHICS_RENDERER_PIPELINE_LIBRARY_HPP
+#define GRAPHICS_RENDERER_PIPELINE_LIBRARY_HPP
+
+#include "quad_batcher.hpp"
+#include "shader_module.hpp"
+
+#include "vulkan/vulkan.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace core::threading {
+	class ThreadPool;
+}
+
+namespace graphics::renderer {
+
+	// Must match the push constant block of "quad.vs"
+	struct QuadPushConstants {
+		// Column-major 4x4 matrix
+		std::array<float, 16> transform;
+
+		float viewportSize[2];
+		float origin[2];
+	};
+
+	// Transform that leaves every quad where it is
+	constexpr std::array<float, 16> IDENTITY_TRANSFORM = {
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+
+	// Builds the graphics pipelines as a graph of jobs on worker threads
+	// The shared vertex shader is a single job, every pipeline job compiles its own fragment shader in parallel and then waits for it
+	// Pipelines become available one by one, so the renderer can draw with whatever is ready instead of waiting for all of them
+	class PipelineLibrary final {
+	public:
+		PipelineLibrary(const VkDevice& device);
+		PipelineLibrary(const PipelineLibrary&) = delete;
+		PipelineLibrary(PipelineLibrary&&) = delete;
+		PipelineLibrary& operator=(const PipelineLibrary&) = delete;
+		PipelineLibrary& operator=(PipelineLibrary&&) = delete;
+		~PipelineLibrary();
+
+		// Create the pipeline layout and start building every pipeline - all pipelines are built on the calling thread when "threadPool" is a null pointer
+		// The render pass, descriptor set layout, and pipeline cache must stay alive until the library is destroyed
+		bool initialize(const VkRenderPass& renderPass, const VkDescriptorSetLayout& descriptorSetLayout, const VkPipelineCache& pipelineCache, core::threading::ThreadPool* threadPool);
+
+		// Returns the pipeline of a type, or a null handle when it is still being built or failed to build
+		VkPipeline get(const PipelineType type) const;
+
+		// Returns whether the pipeline of a type can be used
+		bool isReady(const PipelineType type) const;
+
+		// Returns whether any job is still running, pipelines that are not ready by then failed to build
+		bool isBuilding() const;
+
+		// Block until every job has finished, returns false when any pipeline failed to build
+		bool wait();
+
+		// Wait for outstanding jobs and destroy every pipeline and the pipeline layout
+		void destroy();
+
+		// Layout shared by every pipeline in the library
+		const VkPipelineLayout& getLayout() const;
+
+	private:
+		// Time spent in a single job, used to log the startup timeline once every job is done
+		struct JobTiming {
+			std::string_view name;
+			std::thread::id thread;
+			std::chrono::steady_clock::time_point start;
+			std::chrono::steady_clock::time_point end;
+		};
+
+		// Compile the shared vertex shader
+		bool buildVertexShader();
+
+		// Compile the fragment shader of a pipeline and create the pipeline itself
+		bool buildPipeline(const PipelineType type);
+
+		// Run a job and record its timing, the last job to finish logs the timeline
+		void runJob(const std::string_view name, const std::function<bool()>& job);
+
+		// Print when every job ran and on which thread
+		void logTimeline() const;
+
+	private:
+		const VkDevice& device;
+		VkRenderPass renderPass;
+		VkPipelineCache pipelineCache;
+		VkPipelineLayout pipelineLayout;
+
+		// Written once by the job that builds the pipeline, read by the renderer every frame
+		std::array<std::atomic<VkPipeline>, PIPELINE_TYPE_COUNT> pipelines;
+
+		std::unique_ptr<ShaderModule> vertexShaderModule;
+		std::promise<void> vertexShaderReady;
+		std::shared_future<void> vertexShaderFuture;
+
+		std::vector<std::future<void>> jobs;
+		std::atomic<std::size_t> remainingJobCount;
+		std::atomic<bool> hasFailed;
+
+		std::chrono::steady_clock::time_point startTime;
+		mutable std::mutex timingMutex;
+		std::vector<JobTiming> timings;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_PIPELINE_LIBRARY_HPP
@@ -0,0 +1,103 @@
+#ifndef GRAPHICS_RENDERER_QUAD_BATCHER_HPP
+#define GRAPHICS_RENDERER_QUAD_BATCHER_HPP
+
+#include "display_list.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace core::spatial {
+	class GridIndex;
+}
+
+namespace graphics::text {
+	class TextSystem;
+}
+
+namespace graphics::renderer {
+
+	enum class PipelineType : std::uint8_t {
+		// Untextured quads (rectangles and borders)
+		Solid,
+
+		// Quads that sample a premultiplied RGBA texture
+		Image,
+
+		// Quads that sample coverage from the glyph atlas
+		Text
+	};
+
+	constexpr std::size_t PIPELINE_TYPE_COUNT = 3;
+
+	// Per-instance vertex data of a single quad, must match the input layout of "quad.vs"
+	struct QuadInstance {
+		// Position and size in pixels
+		float rectangle[4];
+
+		// Texture coordinates of the top-left and bottom-right corners
+		float textureCoordinates[4];
+
+		// Linear, premultiplied color
+		float color[4];
+
+		// Element of the texture array that is sampled, untextured quads use "NO_TEXTURE"
+		TextureId texture;
+	};
+
+	// A range of instances that is drawn with a single draw call, every instance selects its own texture
+	struct DrawBatch {
+		PipelineType pipeline;
+		std::uint32_t firstInstance;
+		std::uint32_t instanceCount;
+	};
+
+	// Converts a display list into instanced quads, grouped into as few draw calls as possible
+	// An item may join an earlier batch with the same pipeline, as long as it does not overlap anything painted in between
+	class QuadBatcher final {
+	public:
+		QuadBatcher();
+
+		// Convert all items of a display list, replacing the result of the previous call
+		// When a clip is given, items that cannot paint into it are skipped
+		// An index over the paint bounds of the display list's items lets the clip skip distant items without visiting them
+		void build(const DisplayList& displayList, text::TextSystem& textSystem, const TextureId glyphAtlasTexture, const std::optional<Rectangle>& clip = std::nullopt, const core::spatial::GridIndex* const index = nullptr);
+
+		// Instances of all batches, stored back to back
+		std::span<const QuadInstance> getInstances() const;
+
+		// Batches in the order they should be drawn
+		std::span<const DrawBatch> getBatches() const;
+
+		// Textures the instances sample, every texture is listed once
+		std::span<const TextureId> getTextures() const;
+
+	private:
+		struct PendingBatch {
+			PipelineType pipeline;
+			Rectangle bounds;
+			std::vector<QuadInstance> instances;
+		};
+
+		// Add the quads of a single display item to the most suitable batch
+		void append(const PipelineType pipeline, const Rectangle& bounds, const std::span<const QuadInstance> quads);
+
+	private:
+		// Pending batches are reused between frames to avoid reallocating their instance storage
+		std::vector<PendingBatch> pendingBatches;
+		std::size_t pendingBatchCount;
+
+		// Indices of the items that are converted
+		std::vector<std::uint32_t> candidates;
+
+		std::vector<QuadInstance> quads;
+		std::vector<QuadInstance> instances;
+		std::vector<DrawBatch> batches;
+		std::vector<TextureId> textures;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_QUAD_BATCHER_HPP
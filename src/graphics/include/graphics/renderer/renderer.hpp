@@ -1,48 +1,232 @@
 #ifndef GRAPHICS_RENDERER_RENDERER_HPP
 #define GRAPHICS_RENDERER_RENDERER_HPP
 
+#include "display_list.hpp"
+#include "frame_pacer.hpp"
+#include "gpu_profiler.hpp"
+#include "memory_allocator.hpp"
+#include "quad_batcher.hpp"
+#include "streaming_uploader.hpp"
+#include "tile_cache.hpp"
+
 #include "vulkan/vulkan.h"
 
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <vector>
 
+namespace core::spatial {
+	class GridIndex;
+	class GridIndexBuilder;
+}
+
+namespace core::threading {
+	class ThreadPool;
+}
+
 namespace graphics {
 
+	namespace text {
+		class TextSystem;
+	}
+
 	namespace window {
 		class Window;
 	}
 
 	namespace renderer {
 
+		class ParallelRecorder;
+		class PipelineCache;
+		class PipelineLibrary;
+		class RingBuffer;
+
+		// Number of frames the CPU may record ahead of the GPU by default
+		constexpr std::uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+		// Upper limit of frames in flight, more only adds latency
+		constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
 		class Renderer final {
 		public:
-			Renderer();
+			// Pipelines are built on the workers of "threadPool", or on the calling thread when it is a null pointer
+			explicit Renderer(core::threading::ThreadPool* threadPool = nullptr, const std::uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
 			Renderer(const Renderer&) = delete;
 			Renderer(Renderer&&) = delete;
 			Renderer& operator=(const Renderer&) = delete;
 			Renderer& operator=(const Renderer&&) = delete;
-			~Renderer() = default;
+			~Renderer();
 
 			// Initialize the renderer's systems
 			bool initialize(const window::Window& window);
 
-			// Draw the scene
-			void render() const;
+			// Initialize the renderer without a window, frames are rendered into offscreen images and never presented
+			bool initializeHeadless(const std::uint32_t width, const std::uint32_t height);
+
+			// Draw the scene, does nothing when the previous frame is still up to date
+			void render();
+
+			// Rebuild the swapchain at the current size of the window before the next frame, nothing else is recreated
+			void resize();
+
+			// Select how frames are paced, a different present mode takes effect on the next frame
+			void setPacingPolicy(const PacingPolicy policy);
+
+			// Record that the user interacted with the page, which adaptive pacing responds to with low latency presentation
+			void notifyInput();
+
+			// Time the caller should wait before rendering the next frame, so frames are not rendered faster than they are shown
+			FramePacer::Clock::duration getTimeUntilNextFrame() const;
+
+			// CPU, GPU, and input latency of recent frames
+			FrameStatistics getFrameStatistics() const;
+
+			// Show the GPU time of every pass in the corner of the window, text is drawn in "font" - a null option hides the overlay
+			// The overlay is only updated when a frame is drawn for another reason
+			void setProfilerOverlay(const std::optional<text::FontId> font);
+
+			// GPU time of every pass, averaged over recent frames - empty when the device cannot write timestamps
+			std::span<const PassTiming> getGpuTimings() const;
 
 			// Deallocate resources
 			void destroy();
 
+			// Access the text subsystem (fonts, shaping, and glyph atlas)
+			text::TextSystem& getTextSystem();
+
+			// Make a texture available to display lists - the image must be in the shader read-only layout when it is drawn
+			TextureId registerTexture(const VkImageView& imageView);
+
+			// Create a texture from tightly packed RGBA pixels, which are streamed to the GPU over the next frames
+			// Display lists may use the texture right away, areas that show it are drawn again once the upload completes
+			// Only the thread that owns the renderer may call this, other threads go through Compositor::createTexture() while it runs
+			TextureId createTexture(const std::uint32_t width, const std::uint32_t height, std::vector<std::uint8_t> pixels);
+
+			// Replace the display list that is drawn, only the areas that differ from the previous list are rasterized again
+			void setDisplayList(DisplayList displayList);
+
+			// Scroll the page, which only composites the cached tiles at a different position
+			void setScrollOffset(const float x, const float y);
+
+			// Transform (a column-major 4x4 matrix in viewport pixels) and opacity the page is composited with, neither rasterizes tiles again
+			// The tiles that are composited are still those that cover the untransformed viewport
+			void setPageLayer(const std::array<float, 16>& transform, const float opacity);
+
+			// Returns whether the next call to render() will produce a new frame
+			bool needsRedraw() const;
+
+			// Rasterize the entire page again on the next frame, which is mostly useful to measure rendering throughput
+			void invalidate();
+
+			// Returns whether the renderer was initialized without a window
+			bool isHeadless() const;
+
+			// Wait for the most recent frame and write it to a PNG or PPM file, only available when rendering headless
+			bool saveFrame(const std::string_view& path);
+
+			// Move cached tiles out of sparsely used memory blocks so those can be released, waits for the GPU when there is anything to move
+			// Meant to be called while idle, it does nothing when device memory is not fragmented
+			void compactMemory();
+
+			// Summary of the device memory that is in use
+			MemoryStatistics getMemoryStatistics() const;
+
+		private:
+			// Shared implementation of both initialization methods, "window" is a null pointer when rendering headless
+			bool initialize(const window::Window* const window, const std::uint32_t width, const std::uint32_t height);
+
+			// Allocate the images that take the place of the swapchain when rendering headless, along with the readback buffer
+			bool createOffscreenImages();
+
+			// Destroy the objects created by createOffscreenImages(), including those of a partially completed call
+			void destroyOffscreenImages();
+
+			// Create a swapchain that matches the current size of the window, "oldSwapchain" keeps presenting until the new one takes over
+			bool createSwapchain(const VkSwapchainKHR& oldSwapchain);
+
+			// Create the image views, framebuffers, and semaphores that exist once per swapchain image
+			bool createSwapchainResources();
+
+			// Destroy the objects created by createSwapchainResources(), the GPU must not be using them
+			void destroySwapchainResources();
+
+			// Replace the swapchain and the objects that depend on it, returns false when the window has no area to draw to
+			bool recreateSwapchain();
+
+			// Resources that exist once per frame in flight, so the CPU can record a frame while the GPU executes the previous one
+			struct FrameResources {
+				VkCommandBuffer commandBuffer;
+				VkSemaphore imageAvailableSemaphore;
+				VkFence inFlightFence;
+			};
+
+			// A tile that is rasterized this frame, along with its range in "tileBatches"
+			struct TileRaster {
+				Tile* tile;
+				std::uint32_t firstBatch;
+				std::uint32_t batchCount;
+
+				// Whether every batch of the tile could be drawn, the tile becomes valid once the frame is submitted
+				bool isComplete;
+			};
+
+			// Image that is owned by the renderer, created by createTexture()
+			struct TextureImage {
+				VkImage image;
+				Allocation allocation;
+				VkImageView imageView;
+			};
+
+			// Allocate the command buffer and synchronization objects of a frame in flight
+			bool createFrameResources(FrameResources& frame);
+
+			// Leave the current frame slot ready for reuse after its frame failed after the swapchain image was acquired
+			void abandonFrame();
+
+			// Point the descriptor set of a texture at an image view
+			void writeTextureDescriptor(const TextureId texture, const VkImageView& imageView);
+
+			// Returns whether a texture may be sampled this frame, textures created by createTexture() are not until their upload completes
+			bool isTextureReady(const TextureId texture) const;
+
+			// Fill the overlay display list with the latest GPU timings
+			void buildProfilerOverlay(const text::FontId font);
+
+			// Record the draw calls of a set of batches into a command buffer
+			// Only reads state that is fixed while a frame is recorded, so multiple threads may record batches at once
+			void recordBatches(const VkCommandBuffer& commandBuffer, const std::span<const DrawBatch> batches);
+
+			// Record the draw calls of a tile inside its render pass, safe to call from multiple threads like recordBatches()
+			void recordTile(const VkCommandBuffer& commandBuffer, const TileRaster& tileRaster);
+
 		private:
 			VkInstance instance;
+			VkPhysicalDevice physicalDevice;
 			VkDevice device;
+			std::unique_ptr<MemoryAllocator> memoryAllocator;
 			VkQueue graphicsQueue;
 			VkQueue presentQueue;
+			VkQueue transferQueue;
 			VkSurfaceKHR surface;
 			VkSwapchainKHR swapchain;
+
+			// Only set when presenting, the swapchain follows its size
+			const window::Window* targetWindow;
+			std::uint32_t graphicsQueueFamily;
+			std::uint32_t presentQueueFamily;
 			VkRenderPass renderPass;
-			VkPipelineLayout pipelineLayout;
-			VkPipeline graphicsPipeline;
+			std::unique_ptr<PipelineCache> pipelineCache;
+			std::unique_ptr<PipelineLibrary> pipelineLibrary;
+			VkDescriptorSetLayout textureDescriptorSetLayout;
+			VkDescriptorPool descriptorPool;
+			VkSampler textureSampler;
 			VkCommandPool commandPool;
-			VkCommandBuffer commandBuffer;
+			std::unique_ptr<GpuProfiler> gpuProfiler;
+			std::unique_ptr<ParallelRecorder> parallelRecorder;
 
 #ifndef NDEBUG
 			VkDebugUtilsMessengerEXT debugMessenger;
@@ -50,14 +234,82 @@ namespace graphics {
 
 			VkFormat swapchainImageFormat;
 			VkExtent2D swapchainExtent;
+			VkPresentModeKHR swapchainPresentMode;
 			std::vector<VkImage> swapchainImages;
 			std::vector<VkImageView> swapchainImageViews;
 			std::vector<VkFramebuffer> swapchainFrameBuffers;
 
-			VkSemaphore imageAvailableSemaphore;
-			VkSemaphore renderFinishedSemaphore;
+			// Only used when rendering headless
+			std::vector<Allocation> offscreenImageAllocations;
+			VkBuffer readbackBuffer;
+			Allocation readbackAllocation;
+			std::uint8_t* readbackData;
+
+			// Index of the swapchain (or offscreen) image that was rendered to most recently
+			std::optional<std::uint32_t> lastRenderedImage;
+
+			core::threading::ThreadPool* threadPool;
+
+			std::uint32_t framesInFlight;
+			std::uint32_t currentFrame;
+			std::vector<FrameResources> frames;
+
+			// Quad instances of every frame, one region per frame in flight
+			std::unique_ptr<RingBuffer> transientBuffer;
+
+			// Indexed by swapchain image, a semaphore can only be signaled again once the presentation engine is done with its image
+			std::vector<VkSemaphore> renderFinishedSemaphores;
+
+			std::unique_ptr<text::TextSystem> textSystem;
+
+			// Holds an array with an element for every texture, texture identifiers index into it
+			VkDescriptorSet textureDescriptorSet;
+
+			// Indexed by texture identifier
+			std::vector<UploadId> textureUploads;
+
+			std::unique_ptr<StreamingUploader> streamingUploader;
+			std::vector<TextureImage> textureImages;
+			TextureId glyphAtlasTexture;
+
+			DisplayList displayList;
+			QuadBatcher quadBatcher;
+
+			// Paint bounds of the display list's items, tiles only convert the items in the cells they cover
+			std::unique_ptr<core::spatial::GridIndexBuilder> displayListIndexBuilder;
+			std::shared_ptr<const core::spatial::GridIndex> displayListIndex;
+
+			// Drawn on top of the page in window coordinates when a font is set
+			std::optional<text::FontId> profilerOverlayFont;
+			DisplayList profilerOverlay;
+			std::vector<DrawBatch> overlayBatches;
+
+			std::unique_ptr<TileCache> tileCache;
+			std::vector<Tile*> visibleTiles;
+			std::vector<TileRaster> tileRasters;
+			std::vector<DrawBatch> tileBatches;
+
+			// Secondary command buffers of the tiles in "tileRasters", only filled when tiles are recorded in parallel
+			std::vector<VkCommandBuffer> tileCommandBuffers;
+			std::vector<Rectangle> damage;
+
+			// Top-left corner of the viewport in page coordinates
+			float scrollX;
+			float scrollY;
+
+			std::array<float, 16> pageTransform;
+			float pageOpacity;
+
+			FramePacer framePacer;
+
+			std::uint64_t frameIndex;
+			bool needsComposite;
+
+			// Set while tiles of the viewport could not be allocated, so the shortage is reported once instead of every frame
+			bool isTileShortageReported;
 
-			VkFence inFlightFence;
+			// Set when the window was resized or presentation reported a swapchain that no longer matches the surface
+			bool isSwapchainOutdated;
 
 			bool isDestroyed;
 		};
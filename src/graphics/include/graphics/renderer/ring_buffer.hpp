@@ -0,0 +1,58 @@
+#ifndef GRAPHICS_RENDERER_RING_BUFFER_HPP
+#define GRAPHICS_RENDERER_RING_BUFFER_HPP
+
+#include "memory_allocator.hpp"
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <optional>
+
+namespace graphics::renderer {
+
+	// Range of a ring buffer that is valid until its region is reused
+	struct TransientAllocation {
+		VkDeviceSize offset;
+		std::uint8_t* data;
+	};
+
+	// Persistently mapped buffer for data that only lives for a single frame, split into one region per frame in flight
+	// Allocating is a pointer bump within the region of the current frame, and the whole region is reset at once when the frame slot comes around again
+	class RingBuffer final {
+	public:
+		RingBuffer(const VkDevice& device, MemoryAllocator& allocator);
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer(RingBuffer&&) = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+		RingBuffer& operator=(RingBuffer&&) = delete;
+		~RingBuffer() = default;
+
+		// Create the buffer, host visible and coherent so writes need no explicit flush
+		bool create(const VkBufferUsageFlags usage, const VkDeviceSize bytesPerRegion, const std::uint32_t regionCount);
+
+		// Start allocating from the region of a frame slot - the GPU must be done with the frame that used it last
+		void beginFrame(const std::uint32_t region);
+
+		// Take a range from the current region, returns nothing when the region is full
+		std::optional<TransientAllocation> allocate(const VkDeviceSize size, const VkDeviceSize alignment);
+
+		const VkBuffer& getBuffer() const;
+
+		// Deallocate resources
+		void destroy();
+
+	private:
+		const VkDevice& device;
+		MemoryAllocator& allocator;
+
+		VkBuffer buffer;
+		Allocation allocation;
+
+		VkDeviceSize regionSize;
+		VkDeviceSize regionStart;
+		VkDeviceSize head;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_RING_BUFFER_HPP
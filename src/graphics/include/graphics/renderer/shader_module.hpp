@@ -4,6 +4,8 @@
 #include "vulkan/vulkan.h"
 
 #include <cstdint>
+#include <filesystem>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -13,14 +15,19 @@ namespace graphics::renderer {
 	public:
 		ShaderModule() = delete;
 		ShaderModule(const VkDevice& device);
+		// Use SPIR-V bytecode that was compiled ahead of time, such as the shaders embedded by the build
+		ShaderModule(const VkDevice& device, const std::span<const std::uint32_t> spirV);
 		ShaderModule(const ShaderModule& other);
 		ShaderModule(ShaderModule&& other) noexcept;
 		ShaderModule& operator=(const ShaderModule& other) = delete;
 		ShaderModule& operator=(ShaderModule&& other) noexcept = delete;
 		~ShaderModule();
 
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
 		// Compile the contents of a given source file into SPIR-V shader bytecode
-		bool compileFromFile(const std::string_view source);
+		// When a cache directory is given, bytecode compiled by a previous run from the same source and options is reused
+		bool compileFromFile(const std::string_view source, const std::string_view cacheDirectory = {});
+#endif
 
 		// Turn the compiled shader bytecode into a Vulkan shader module
 		bool create();
@@ -28,10 +35,15 @@ namespace graphics::renderer {
 		// Access the raw handle to the Vulkan object
 		const VkShaderModule& handle() const;
 
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
 	private:
-		std::vector<std::uint32_t> spirV;
+		// Load previously compiled bytecode, returns false when the file does not exist or is invalid
+		bool loadFromCache(const std::filesystem::path& cachePath);
+#endif
 
+	private:
 		const VkDevice& device;
+		std::vector<std::uint32_t> spirV;
 		VkShaderModule shaderModule;
 	};
 
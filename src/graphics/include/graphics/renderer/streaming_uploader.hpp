@@ -0,0 +1,124 @@
+#ifndef GRAPHICS_RENDERER_STREAMING_UPLOADER_HPP
+#define GRAPHICS_RENDERER_STREAMING_UPLOADER_HPP
+
+#include "memory_allocator.hpp"
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace graphics::renderer {
+
+	// Identifies an upload, zero is never handed out
+	using UploadId = std::uint64_t;
+
+	constexpr UploadId NO_UPLOAD = 0;
+
+	// Streams pixels into images on the transfer queue, so large uploads do not stall the graphics queue
+	// Pixels are staged through a ring buffer and copied in bands of rows, at most a fixed number of bytes per frame
+	// Finished images are handed over to the graphics queue through a timeline semaphore and a queue family ownership transfer
+	class StreamingUploader final {
+	public:
+		StreamingUploader(const VkDevice& device, MemoryAllocator& allocator);
+		StreamingUploader(const StreamingUploader&) = delete;
+		StreamingUploader(StreamingUploader&&) = delete;
+		StreamingUploader& operator=(const StreamingUploader&) = delete;
+		StreamingUploader& operator=(StreamingUploader&&) = delete;
+		~StreamingUploader() = default;
+
+		// Create the staging ring, command pool, and timeline semaphore
+		// "queueFamily" equals "graphicsQueueFamily" when the device has no dedicated transfer queue, no ownership transfer is needed then
+		bool create(const VkQueue& queue, const std::uint32_t queueFamily, const std::uint32_t graphicsQueueFamily, const VkDeviceSize ringSize, const VkDeviceSize bytesPerFrame);
+
+		// Queue the upload of tightly packed pixels into the whole of "image", which must be in the undefined layout
+		// The image ends up in the shader read-only layout, and must not be used before isComplete() returns true
+		UploadId uploadImage(const VkImage& image, const std::uint32_t width, const std::uint32_t height, const std::uint32_t bytesPerPixel, std::vector<std::uint8_t> pixels);
+
+		// Copy as many pending bytes as the frame budget allows into the staging ring and submit them on the transfer queue
+		// Called once per frame, before the frame decides which images it can sample
+		void submit();
+
+		// Record the ownership acquire of every image that was finished by submit() and not acquired yet, before any draw samples them
+		// Returns the value of getSemaphore() the graphics submission has to wait for at the fragment shader stage, or zero when it need not wait
+		std::uint64_t recordAcquires(const VkCommandBuffer& commandBuffer);
+
+		// The command buffer passed to recordAcquires() was submitted, its images are not acquired again
+		// Without this call the next recordAcquires() records the same acquires, so a frame that fails to submit loses none of them
+		void commitAcquires();
+
+		// Timeline semaphore that is signaled by every transfer submission
+		const VkSemaphore& getSemaphore() const;
+
+		// Returns whether an image may be sampled by commands recorded after the acquires of this frame
+		bool isComplete(const UploadId upload) const;
+
+		// Returns whether there are uploads that still have rows to copy
+		bool hasPendingUploads() const;
+
+		// Deallocate resources, the transfer queue must be idle
+		void destroy();
+
+	private:
+		struct PendingUpload {
+			UploadId id;
+			VkImage image;
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint32_t bytesPerPixel;
+			std::vector<std::uint8_t> pixels;
+			std::uint32_t uploadedRows;
+		};
+
+		// Transfer work that may still be executing, its command buffer and staging range are reused once the semaphore reaches "value"
+		struct Submission {
+			VkCommandBuffer commandBuffer;
+			std::uint64_t value;
+			VkDeviceSize stagingEnd;
+		};
+
+		// Release the command buffers and staging ranges of submissions the GPU has finished
+		void reclaim();
+
+		// Reserve a contiguous range of the staging ring, returns its offset in the buffer
+		std::optional<VkDeviceSize> reserve(const VkDeviceSize size, const VkDeviceSize alignment);
+
+	private:
+		const VkDevice& device;
+		MemoryAllocator& allocator;
+
+		VkQueue transferQueue;
+		std::uint32_t transferFamily;
+		std::uint32_t graphicsFamily;
+
+		VkCommandPool commandPool;
+		std::vector<VkCommandBuffer> freeCommandBuffers;
+		std::deque<Submission> submissions;
+
+		VkSemaphore timelineSemaphore;
+		std::uint64_t timelineValue;
+
+		// Positions in the ring only ever grow, the offset in the buffer is the position modulo its size
+		VkBuffer stagingBuffer;
+		Allocation stagingAllocation;
+		VkDeviceSize stagingSize;
+		VkDeviceSize stagingHead;
+		VkDeviceSize stagingTail;
+
+		VkDeviceSize frameBudget;
+
+		std::deque<PendingUpload> pendingUploads;
+		std::vector<VkImage> releasedImages;
+
+		// Leading part of "releasedImages" that the last call to recordAcquires() recorded
+		std::size_t recordedAcquireCount;
+
+		UploadId nextUpload;
+		UploadId completedUpload;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_STREAMING_UPLOADER_HPP
@@ -0,0 +1,102 @@
+#ifndef GRAPHICS_RENDERER_TILE_CACHE_HPP
+#define GRAPHICS_RENDERER_TILE_CACHE_HPP
+
+#include "display_list.hpp"
+#include "memory_allocator.hpp"
+
+#include "vulkan/vulkan.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace graphics::renderer {
+
+	// Width and height of a tile in pixels
+	constexpr std::uint32_t TILE_SIZE = 256;
+
+	// Fixed-size piece of the page that is rasterized into its own texture
+	struct Tile {
+		// Position in the tile grid, the tile covers [column * TILE_SIZE, (column + 1) * TILE_SIZE) horizontally
+		std::int32_t column;
+		std::int32_t row;
+
+		VkImage image;
+		Allocation imageAllocation;
+		VkImageView imageView;
+		VkFramebuffer framebuffer;
+
+		// Assigned by the renderer the first time the tile is composited
+		TextureId texture;
+
+		// Set when the contents of the image match the current display list
+		bool isValid;
+
+		std::uint64_t lastUsedFrame;
+
+		// Area of the page covered by this tile
+		Rectangle getBounds() const;
+	};
+
+	// Owns the offscreen textures that cached page content is rasterized into
+	// Tiles are recycled in least recently used order once the budget is reached, so their textures never have to be reallocated
+	class TileCache final {
+	public:
+		TileCache(const VkDevice& device, MemoryAllocator& allocator);
+		TileCache(const TileCache&) = delete;
+		TileCache(TileCache&&) = delete;
+		TileCache& operator=(const TileCache&) = delete;
+		TileCache& operator=(TileCache&&) = delete;
+		~TileCache() = default;
+
+		// Create the render pass tiles are rasterized with - "tileFormat" must match the format pipelines were created for
+		bool initialize(const VkFormat tileFormat, const std::uint32_t tileCount);
+
+		// Find the tile at a grid position, recycling the least recently used tile when the cache is full
+		// Returns a null pointer when every tile is already in use this frame
+		Tile* acquire(const std::int32_t column, const std::int32_t row, const std::uint64_t frame);
+
+		// Raise the tile budget, for instance when the viewport grew - pointers to tiles are invalidated
+		void grow(const std::uint32_t tileCount);
+
+		// Mark every tile that intersects an area as outdated
+		void invalidate(const Rectangle& area);
+
+		// Mark all tiles as outdated
+		void invalidateAll();
+
+		// Move tiles out of sparsely used memory blocks, so the allocator can release them - the GPU must not be using any tile
+		// Moved tiles get a new image and view and lose their contents, the tiles that moved are returned
+		std::vector<Tile*> defragment();
+
+		// Render pass that clears a tile and leaves it ready to be sampled
+		const VkRenderPass& getRenderPass() const;
+
+		// Deallocate resources
+		void destroy();
+
+	private:
+		// Allocate the image, memory, view, and framebuffer of a tile
+		bool createTile(Tile& tile);
+
+		// Release the image, memory, view, and framebuffer of a tile
+		void destroyTile(Tile& tile);
+
+	private:
+		VkDevice device;
+		MemoryAllocator& allocator;
+		VkFormat format;
+		VkRenderPass renderPass;
+		std::uint32_t maxTileCount;
+
+		// Reserved up front so pointers to tiles stay valid
+		std::vector<Tile> tiles;
+
+		// Grid position to index into "tiles"
+		std::unordered_map<std::uint64_t, std::size_t> tileLookup;
+	};
+
+}
+
+#endif // !GRAPHICS_RENDERER_TILE_CACHE_HPP
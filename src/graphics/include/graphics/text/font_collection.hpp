@@ -0,0 +1,76 @@
+#ifndef GRAPHICS_TEXT_FONT_COLLECTION_HPP
+#define GRAPHICS_TEXT_FONT_COLLECTION_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+typedef struct FT_LibraryRec_* FT_Library;
+typedef struct FT_FaceRec_* FT_Face;
+
+namespace graphics::text {
+
+	// Handle to a font that was loaded into a font collection
+	using FontId = std::uint16_t;
+
+	// Coverage bitmap of a single glyph, one byte per pixel
+	struct RasterizedGlyph {
+		std::uint32_t width;
+		std::uint32_t height;
+
+		// Offset from the pen position to the top-left corner of the bitmap (y points down)
+		std::int32_t bearingX;
+		std::int32_t bearingY;
+
+		std::vector<std::uint8_t> pixels;
+	};
+
+	// Metrics needed to position a single glyph
+	struct GlyphMetrics {
+		std::uint32_t glyphIndex;
+
+		// Horizontal advance in pixels
+		float advance;
+	};
+
+	// Owns all fonts loaded through FreeType
+	class FontCollection final {
+	public:
+		FontCollection();
+		FontCollection(const FontCollection&) = delete;
+		FontCollection(FontCollection&&) = delete;
+		FontCollection& operator=(const FontCollection&) = delete;
+		FontCollection& operator=(FontCollection&&) = delete;
+		~FontCollection();
+
+		// Initialize FreeType
+		bool initialize();
+
+		// Load a font from a file (TrueType, OpenType, ...)
+		std::optional<FontId> load(const std::string_view& path);
+
+		// Look up the glyph that represents a code point and measure it
+		std::optional<GlyphMetrics> getGlyphMetrics(const FontId font, const std::uint32_t pixelSize, const std::uint32_t codePoint);
+
+		// Horizontal kerning adjustment in pixels between two glyphs
+		float getKerning(const FontId font, const std::uint32_t pixelSize, const std::uint32_t leftGlyphIndex, const std::uint32_t rightGlyphIndex);
+
+		// Render a glyph into an 8-bit coverage bitmap
+		std::optional<RasterizedGlyph> rasterize(const FontId font, const std::uint32_t pixelSize, const std::uint32_t glyphIndex);
+
+		// Release all fonts and shut down FreeType
+		void destroy();
+
+	private:
+		// Select a font at the given size, returns nullptr if the font does not exist
+		FT_Face selectFace(const FontId font, const std::uint32_t pixelSize);
+
+	private:
+		FT_Library library;
+		std::vector<FT_Face> faces;
+	};
+
+}
+
+#endif // !GRAPHICS_TEXT_FONT_COLLECTION_HPP
@@ -0,0 +1,108 @@
+#ifndef GRAPHICS_TEXT_GLYPH_ATLAS_HPP
+#define GRAPHICS_TEXT_GLYPH_ATLAS_HPP
+
+#include "font_collection.hpp"
+#include "skyline_packer.hpp"
+
+#include "graphics/renderer/memory_allocator.hpp"
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace graphics::text {
+
+	// Location and metrics of a glyph that lives in the atlas
+	struct AtlasGlyph {
+		// Normalized texture coordinates of the glyph's bitmap
+		float u0;
+		float v0;
+		float u1;
+		float v1;
+
+		std::uint32_t width;
+		std::uint32_t height;
+		std::int32_t bearingX;
+		std::int32_t bearingY;
+	};
+
+	// Single-channel GPU texture that caches rasterized glyphs across frames
+	// Glyphs are packed with a skyline packer, and the least recently used glyphs are evicted once the texture is full
+	class GlyphAtlas final {
+	public:
+		GlyphAtlas(const VkDevice& device, renderer::MemoryAllocator& allocator, const std::uint32_t size = 1'024);
+		GlyphAtlas(const GlyphAtlas&) = delete;
+		GlyphAtlas(GlyphAtlas&&) = delete;
+		GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+		GlyphAtlas& operator=(GlyphAtlas&&) = delete;
+		~GlyphAtlas() = default;
+
+		// Allocate the atlas texture and the staging buffer used to upload glyphs
+		// The staging buffer is split into one slice per frame in flight, so an upload never overwrites data the GPU still has to copy
+		bool create(const std::uint32_t sliceCount);
+
+		// Mark the start of a new frame - glyphs used during the current frame are never evicted
+		void beginFrame();
+
+		// Look up a glyph, rasterizing and packing it into the atlas if it is not present yet
+		std::optional<AtlasGlyph> find(FontCollection& fonts, const FontId font, const std::uint32_t pixelSize, const std::uint32_t glyphIndex);
+
+		// Record the upload of every glyph that was added since the previous upload as a single batched copy
+		// Must be recorded outside of a render pass, before any draw that samples the atlas
+		// "stagingSlice" must not be in use by a frame that is still executing on the GPU
+		void recordUpload(const VkCommandBuffer& commandBuffer, const std::uint32_t stagingSlice);
+
+		// Image view of the atlas texture, ready to be sampled in fragment shaders
+		const VkImageView& getImageView() const;
+
+		// Deallocate resources
+		void destroy();
+
+	private:
+		struct Entry {
+			AtlasGlyph glyph;
+			PackedRectangle rectangle;
+			std::uint64_t lastUsedFrame;
+		};
+
+		// Reserve space for a bitmap and copy its pixels into the CPU-side copy of the atlas
+		std::optional<PackedRectangle> insert(const std::uint32_t width, const std::uint32_t height, const std::uint8_t* const source);
+
+		// Throw away the least recently used glyphs and repack the remaining ones
+		// Glyphs used during the current frame keep their position, quads that were built earlier in the frame still refer to it
+		void evict();
+
+		// Compute the texture coordinates of a packed glyph
+		void updateTextureCoordinates(Entry& entry) const;
+
+	private:
+		const VkDevice& device;
+		renderer::MemoryAllocator& allocator;
+		std::uint32_t size;
+
+		SkylinePacker packer;
+		std::unordered_map<std::uint64_t, Entry> entries;
+		std::uint64_t frameIndex;
+
+		// CPU-side copy of the atlas, required to repack glyphs after an eviction
+		std::vector<std::uint8_t> pixels;
+		std::vector<PackedRectangle> pendingUploads;
+		bool needsFullUpload;
+		bool isImageInitialized;
+
+		VkImage image;
+		renderer::Allocation imageAllocation;
+		VkImageView imageView;
+
+		VkBuffer stagingBuffer;
+		renderer::Allocation stagingAllocation;
+		std::uint8_t* stagingData;
+		std::uint32_t stagingSliceCount;
+	};
+
+}
+
+#endif // !GRAPHICS_TEXT_GLYPH_ATLAS_HPP
@@ -0,0 +1,68 @@
+#ifndef GRAPHICS_TEXT_SHAPING_CACHE_HPP
+#define GRAPHICS_TEXT_SHAPING_CACHE_HPP
+
+#include "font_collection.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace graphics::text {
+
+	// A glyph positioned relative to the start of its run
+	struct ShapedGlyph {
+		std::uint32_t glyphIndex;
+		float x;
+	};
+
+	// Result of shaping a run of text with a single font at a single size
+	struct ShapedRun {
+		std::vector<ShapedGlyph> glyphs;
+
+		// Total advance of the run in pixels
+		float width;
+	};
+
+	// Least-recently-used cache of shaped text runs, keyed by (font, size, text)
+	class ShapingCache final {
+	public:
+		// Create a cache that holds at most "capacity" runs
+		explicit ShapingCache(const std::size_t capacity = 8'192);
+
+		// Shape a run of UTF-8 encoded text, or return the cached result of an earlier call with the same arguments
+		// The returned reference stays valid until the next call to "shape"
+		const ShapedRun& shape(FontCollection& fonts, const FontId font, const std::uint32_t pixelSize, const std::string_view& text);
+
+		// Remove all cached runs
+		void clear();
+
+		std::size_t getHitCount() const;
+		std::size_t getMissCount() const;
+
+	private:
+		struct Entry {
+			std::string key;
+			ShapedRun run;
+		};
+
+		// Build the lookup key of a run
+		static std::string makeKey(const FontId font, const std::uint32_t pixelSize, const std::string_view& text);
+
+	private:
+		std::size_t capacity;
+
+		// Most recently used entries are kept at the front of the list
+		std::list<Entry> entries;
+		std::unordered_map<std::string_view, std::list<Entry>::iterator> lookup;
+
+		std::size_t hitCount;
+		std::size_t missCount;
+	};
+
+}
+
+#endif // !GRAPHICS_TEXT_SHAPING_CACHE_HPP
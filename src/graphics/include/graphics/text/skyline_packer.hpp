@@ -0,0 +1,59 @@
+#ifndef GRAPHICS_TEXT_SKYLINE_PACKER_HPP
+#define GRAPHICS_TEXT_SKYLINE_PACKER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace graphics::text {
+
+	// Location of a packed rectangle in pixels
+	struct PackedRectangle {
+		std::uint32_t x;
+		std::uint32_t y;
+		std::uint32_t width;
+		std::uint32_t height;
+	};
+
+	// Packs rectangles into a fixed-size area using the skyline bottom-left heuristic
+	// The skyline is the upper edge of everything packed so far, stored as a list of horizontal segments
+	class SkylinePacker final {
+	public:
+		SkylinePacker(const std::uint32_t width, const std::uint32_t height);
+
+		// Find a spot for a rectangle, returns nothing when the area is full
+		std::optional<PackedRectangle> pack(const std::uint32_t width, const std::uint32_t height);
+
+		// Mark a rectangle at a fixed position as occupied, the area below it is not used until the next reset
+		void reserve(const PackedRectangle& rectangle);
+
+		// Forget about all packed rectangles
+		void reset();
+
+		// Fraction of the area that is covered by packed rectangles
+		float getOccupancy() const;
+
+	private:
+		struct Segment {
+			std::uint32_t x;
+			std::uint32_t y;
+			std::uint32_t width;
+		};
+
+		// Returns the lowest y-coordinate at which a rectangle fits when its left edge is placed at the given segment
+		std::optional<std::uint32_t> fit(const std::size_t segmentIndex, const std::uint32_t width, const std::uint32_t height) const;
+
+		// Raise the skyline to cover a newly packed rectangle
+		void addSkylineLevel(const std::size_t segmentIndex, const PackedRectangle& rectangle);
+
+	private:
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint64_t usedArea;
+
+		std::vector<Segment> skyline;
+	};
+
+}
+
+#endif // !GRAPHICS_TEXT_SKYLINE_PACKER_HPP
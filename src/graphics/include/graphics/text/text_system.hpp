@@ -0,0 +1,59 @@
+#ifndef GRAPHICS_TEXT_TEXT_SYSTEM_HPP
+#define GRAPHICS_TEXT_TEXT_SYSTEM_HPP
+
+#include "font_collection.hpp"
+#include "glyph_atlas.hpp"
+#include "shaping_cache.hpp"
+
+#include "vulkan/vulkan.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace graphics::text {
+
+	// Ties fonts, the shaping cache, and the glyph atlas together
+	// Text runs are shaped once and every glyph is rasterized once, after which both are reused across frames
+	class TextSystem final {
+	public:
+		TextSystem(const VkDevice& device, renderer::MemoryAllocator& allocator);
+		TextSystem(const TextSystem&) = delete;
+		TextSystem(TextSystem&&) = delete;
+		TextSystem& operator=(const TextSystem&) = delete;
+		TextSystem& operator=(TextSystem&&) = delete;
+		~TextSystem() = default;
+
+		// Initialize FreeType and allocate the glyph atlas, uploads are staged separately for every frame in flight
+		bool initialize(const std::uint32_t framesInFlight);
+
+		// Load a font from a file
+		std::optional<FontId> loadFont(const std::string_view& path);
+
+		// Shape a run of UTF-8 encoded text
+		const ShapedRun& shape(const FontId font, const std::uint32_t pixelSize, const std::string_view& text);
+
+		// Find a glyph in the atlas, rasterizing it when it is used for the first time
+		std::optional<AtlasGlyph> findGlyph(const FontId font, const std::uint32_t pixelSize, const std::uint32_t glyphIndex);
+
+		// Mark the start of a new frame
+		void beginFrame();
+
+		// Record the upload of all newly rasterized glyphs, "frameSlot" identifies the frame in flight being recorded
+		void recordUploads(const VkCommandBuffer& commandBuffer, const std::uint32_t frameSlot);
+
+		// Image view of the glyph atlas
+		const VkImageView& getAtlasImageView() const;
+
+		// Deallocate resources
+		void destroy();
+
+	private:
+		FontCollection fonts;
+		ShapingCache shapingCache;
+		GlyphAtlas glyphAtlas;
+	};
+
+}
+
+#endif // !GRAPHICS_TEXT_TEXT_SYSTEM_HPP
@@ -1,9 +1,12 @@
 #ifndef GRAPHICS_WINDOW_WINDOW_HPP
 #define GRAPHICS_WINDOW_WINDOW_HPP
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <utility>
 
 struct GLFWwindow;
 
@@ -27,18 +30,43 @@ namespace graphics::window {
 		// Poll for user input
 		void poll() const;
 
+		// Sleep until there is user input or wake() is called, but no longer than "timeout"
+		void wait(const std::chrono::milliseconds timeout) const;
+
+		// Make a call to wait() return early, may be called from any thread
+		static void wake();
+
+		// Returns whether the framebuffer changed size since the previous call
+		bool consumeResize();
+
+		// Returns whether a key, mouse button, or scroll wheel was used since the previous call
+		bool consumeInput();
+
+		// Returns whether the cursor moved since the previous call
+		bool consumeCursorMove();
+
+		// Returns how far the scroll wheel moved since the previous call, in framebuffer pixels - positive values scroll down and to the right
+		std::pair<float, float> consumeScroll();
+
 		// Destroy the window
 		void destroy();
 
 		// Get the raw window handle
 		GLFWwindow* const getRawHandle() const;
 
-		// Get the width of the screen in pixels
+		// Get the width of the screen in pixels, may be called from any thread
 		std::uint32_t getWidth() const;
 
-		// Get the height of the screen in pixels
+		// Get the height of the screen in pixels, may be called from any thread
 		std::uint32_t getHeight() const;
 
+		// Get the refresh rate of the monitor the window is shown on in hertz
+		std::uint32_t getRefreshRate() const;
+
+		// Get the position of the cursor in framebuffer pixels, relative to the top-left corner of the window
+		float getCursorX() const;
+		float getCursorY() const;
+
 	private:
 		std::uint32_t width;
 		std::uint32_t height;
@@ -46,6 +74,21 @@ namespace graphics::window {
 		std::string title;
 
 		GLFWwindow* handle;
+
+		// Set from the framebuffer size and input callbacks
+		bool isResized;
+		bool hasInput;
+		bool hasCursorMoved;
+
+		float cursorX;
+		float cursorY;
+
+		float scrollX;
+		float scrollY;
+
+		// GLFW may only be queried on the main thread, the framebuffer size is kept up to date by its callback so the compositor can read it
+		std::atomic<std::uint32_t> framebufferWidth;
+		std::atomic<std::uint32_t> framebufferHeight;
 	};
 
 }
@@ -0,0 +1,658 @@
+#include "graphics/image/image_decoder.hpp"
+#include "graphics/image/inflate.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLAIN_IMAGE_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace graphics::image;
+
+// Larger images are rejected before anything is allocated for them, which keeps malformed or hostile files from exhausting memory
+constexpr std::uint64_t MAX_IMAGE_PIXEL_COUNT = 1 << 26;
+
+constexpr std::array<std::uint8_t, 8> PNG_SIGNATURE = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+// Reference: https://www.w3.org/TR/png/#6Colour-values
+enum class PngColorType : std::uint8_t {
+	Grayscale = 0,
+	Truecolor = 2,
+	Indexed = 3,
+	GrayscaleAlpha = 4,
+	TruecolorAlpha = 6
+};
+
+struct PngHeader {
+	std::uint32_t width;
+	std::uint32_t height;
+	std::uint32_t bitDepth;
+	PngColorType colorType;
+	std::uint32_t channelCount;
+	bool isInterlaced;
+};
+
+// Palette and transparency of a PNG image, which are needed to expand its samples to RGBA
+struct PngColors {
+	// RGBA for every palette entry
+	std::vector<std::uint8_t> palette;
+
+	// Samples of the single color that is fully transparent in grayscale and truecolor images
+	std::optional<std::array<std::uint32_t, 3>> transparentColor;
+};
+
+static std::uint32_t readBigEndian32(const std::span<const std::uint8_t> data, const std::size_t offset) {
+	return static_cast<std::uint32_t>(data[offset]) << 24 | static_cast<std::uint32_t>(data[offset + 1]) << 16 | static_cast<std::uint32_t>(data[offset + 2]) << 8 | data[offset + 3];
+}
+
+static std::uint32_t readBigEndian16(const std::span<const std::uint8_t> data, const std::size_t offset) {
+	return static_cast<std::uint32_t>(data[offset]) << 8 | data[offset + 1];
+}
+
+// Exact "value * alpha / 255", rounded to the nearest integer
+static std::uint8_t multiplyAlpha(const std::uint32_t value, const std::uint32_t alpha) {
+	const auto product = value * alpha + 128;
+	return static_cast<std::uint8_t>((product + (product >> 8)) >> 8);
+}
+
+// Multiply the color channels of a row of RGBA pixels by their alpha, four pixels at a time where SSE2 is available
+static void premultiplyRow(std::uint8_t* const pixels, const std::size_t pixelCount) {
+	std::size_t i = 0;
+
+#ifdef PLAIN_IMAGE_SSE2
+	const auto zero = _mm_setzero_si128();
+	const auto colorMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const auto opaqueAlpha = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	const auto rounding = _mm_set1_epi16(128);
+
+	// Widen two pixels to 16 bits per channel, multiply every channel by the alpha of its pixel (alpha by 255), and divide by 255
+	const auto premultiplyHalf = [&](const __m128i half) {
+		const auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, 0xFF), 0xFF);
+		const auto factor = _mm_or_si128(_mm_and_si128(alpha, colorMask), opaqueAlpha);
+		const auto product = _mm_add_epi16(_mm_mullo_epi16(half, factor), rounding);
+
+		return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+	};
+
+	for (; i + 4 <= pixelCount; i += 4) {
+		auto* const address = reinterpret_cast<__m128i*>(pixels + i * 4);
+		const auto packed = _mm_loadu_si128(address);
+
+		const auto low = premultiplyHalf(_mm_unpacklo_epi8(packed, zero));
+		const auto high = premultiplyHalf(_mm_unpackhi_epi8(packed, zero));
+
+		_mm_storeu_si128(address, _mm_packus_epi16(low, high));
+	}
+#endif
+
+	for (; i < pixelCount; ++i) {
+		auto* const pixel = pixels + i * 4;
+		const auto alpha = pixel[3];
+
+		pixel[0] = multiplyAlpha(pixel[0], alpha);
+		pixel[1] = multiplyAlpha(pixel[1], alpha);
+		pixel[2] = multiplyAlpha(pixel[2], alpha);
+	}
+}
+
+// Averages rows of premultiplied RGBA into an image of the target size as they are decoded
+// Every target pixel is the average of the box of source pixels that maps onto it, images are never scaled up
+class RowScaler final {
+public:
+	RowScaler(const std::uint32_t sourceWidth, const std::uint32_t sourceHeight, const std::uint32_t targetWidth, const std::uint32_t targetHeight) :
+		sourceWidth{ sourceWidth },
+		sourceHeight{ sourceHeight },
+		targetWidth{ targetWidth },
+		targetHeight{ targetHeight },
+		targetColumns(sourceWidth),
+		columnWeights(targetWidth),
+		sums(static_cast<std::size_t>(targetWidth) * 4),
+		sourceRow{ 0 },
+		accumulatedRows{ 0 },
+		pixels(static_cast<std::size_t>(targetWidth) * targetHeight * 4) {
+		for (std::uint32_t x = 0; x < sourceWidth; ++x) {
+			targetColumns[x] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(x) * targetWidth / sourceWidth);
+			++columnWeights[targetColumns[x]];
+		}
+	}
+
+	// Add the next row of the source image, "row" holds one premultiplied RGBA pixel for every source column
+	void addRow(const std::uint8_t* const row) {
+		const auto targetRow = static_cast<std::uint32_t>(static_cast<std::uint64_t>(sourceRow) * targetHeight / sourceHeight);
+		++sourceRow;
+
+		if (sourceWidth == targetWidth && sourceHeight == targetHeight) {
+			std::memcpy(pixels.data() + static_cast<std::size_t>(targetRow) * targetWidth * 4, row, static_cast<std::size_t>(targetWidth) * 4);
+			return;
+		}
+
+		for (std::uint32_t x = 0; x < sourceWidth; ++x) {
+			auto* const sum = sums.data() + static_cast<std::size_t>(targetColumns[x]) * 4;
+			const auto* const pixel = row + static_cast<std::size_t>(x) * 4;
+
+			sum[0] += pixel[0];
+			sum[1] += pixel[1];
+			sum[2] += pixel[2];
+			sum[3] += pixel[3];
+		}
+
+		++accumulatedRows;
+
+		// Write the target row once the last source row that maps onto it was added
+		const auto isLastRow = sourceRow == sourceHeight || static_cast<std::uint64_t>(sourceRow) * targetHeight / sourceHeight != targetRow;
+
+		if (!isLastRow) {
+			return;
+		}
+
+		auto* const target = pixels.data() + static_cast<std::size_t>(targetRow) * targetWidth * 4;
+
+		for (std::size_t i = 0; i < sums.size(); ++i) {
+			const std::uint64_t weight = static_cast<std::uint64_t>(columnWeights[i / 4]) * accumulatedRows;
+			target[i] = static_cast<std::uint8_t>((sums[i] + weight / 2) / weight);
+		}
+
+		std::fill(sums.begin(), sums.end(), 0);
+		accumulatedRows = 0;
+	}
+
+	std::vector<std::uint8_t> takePixels() {
+		return std::move(pixels);
+	}
+
+private:
+	const std::uint32_t sourceWidth;
+	const std::uint32_t sourceHeight;
+	const std::uint32_t targetWidth;
+	const std::uint32_t targetHeight;
+
+	std::vector<std::uint32_t> targetColumns;
+	std::vector<std::uint32_t> columnWeights;
+	std::vector<std::uint64_t> sums;
+
+	std::uint32_t sourceRow;
+	std::uint32_t accumulatedRows;
+
+	std::vector<std::uint8_t> pixels;
+};
+
+static std::uint32_t getTargetSize(const std::uint32_t intrinsicSize, const std::uint32_t maxSize) {
+	return maxSize == 0 ? intrinsicSize : std::min(intrinsicSize, maxSize);
+}
+
+static bool isTooLarge(const std::uint32_t width, const std::uint32_t height) {
+	return width == 0 || height == 0 || static_cast<std::uint64_t>(width) * height > MAX_IMAGE_PIXEL_COUNT;
+}
+
+static std::uint32_t readPngSample(const std::uint8_t* const row, const std::size_t index, const std::uint32_t bitDepth) {
+	switch (bitDepth) {
+		case 16:
+			return static_cast<std::uint32_t>(row[index * 2]) << 8 | row[index * 2 + 1];
+
+		case 8:
+			return row[index];
+
+		default:
+		{
+			// Samples smaller than a byte are packed from the most significant bit down
+			const auto bitOffset = index * bitDepth;
+			const auto shift = 8 - bitDepth - static_cast<std::uint32_t>(bitOffset % 8);
+
+			return (row[bitOffset / 8] >> shift) & ((1u << bitDepth) - 1);
+		}
+	}
+}
+
+// Scale a sample of any bit depth to eight bits
+static std::uint8_t toEightBits(const std::uint32_t sample, const std::uint32_t bitDepth) {
+	if (bitDepth == 16) {
+		return static_cast<std::uint8_t>(sample >> 8);
+	}
+
+	return static_cast<std::uint8_t>(sample * 255 / ((1u << bitDepth) - 1));
+}
+
+// Convert an unfiltered scanline to straight (not yet premultiplied) RGBA
+static void expandPngRow(const PngHeader& header, const PngColors& colors, const std::uint8_t* const row, std::uint8_t* const rgba) {
+	// The common case is copied as is
+	if (header.colorType == PngColorType::TruecolorAlpha && header.bitDepth == 8) {
+		std::memcpy(rgba, row, static_cast<std::size_t>(header.width) * 4);
+		return;
+	}
+
+	for (std::size_t x = 0; x < header.width; ++x) {
+		auto* const pixel = rgba + x * 4;
+		const auto sample = [&header, row, x](const std::uint32_t channel) {
+			return readPngSample(row, x * header.channelCount + channel, header.bitDepth);
+		};
+
+		switch (header.colorType) {
+			case PngColorType::Grayscale:
+			{
+				const auto gray = sample(0);
+				const auto isTransparent = colors.transparentColor.has_value() && colors.transparentColor.value()[0] == gray;
+
+				pixel[0] = pixel[1] = pixel[2] = toEightBits(gray, header.bitDepth);
+				pixel[3] = isTransparent ? 0 : 255;
+				break;
+			}
+
+			case PngColorType::Truecolor:
+			{
+				const std::array<std::uint32_t, 3> color = { sample(0), sample(1), sample(2) };
+				const auto isTransparent = colors.transparentColor.has_value() && colors.transparentColor.value() == color;
+
+				pixel[0] = toEightBits(color[0], header.bitDepth);
+				pixel[1] = toEightBits(color[1], header.bitDepth);
+				pixel[2] = toEightBits(color[2], header.bitDepth);
+				pixel[3] = isTransparent ? 0 : 255;
+				break;
+			}
+
+			case PngColorType::Indexed:
+			{
+				// Indices beyond the palette are an error in the file, they are shown as transparent
+				const auto index = static_cast<std::size_t>(sample(0)) * 4;
+
+				if (index + 4 <= colors.palette.size()) {
+					std::memcpy(pixel, colors.palette.data() + index, 4);
+				} else {
+					std::memset(pixel, 0, 4);
+				}
+
+				break;
+			}
+
+			case PngColorType::GrayscaleAlpha:
+				pixel[0] = pixel[1] = pixel[2] = toEightBits(sample(0), header.bitDepth);
+				pixel[3] = toEightBits(sample(1), header.bitDepth);
+				break;
+
+			case PngColorType::TruecolorAlpha:
+				pixel[0] = toEightBits(sample(0), header.bitDepth);
+				pixel[1] = toEightBits(sample(1), header.bitDepth);
+				pixel[2] = toEightBits(sample(2), header.bitDepth);
+				pixel[3] = toEightBits(sample(3), header.bitDepth);
+				break;
+		}
+	}
+}
+
+static std::uint8_t paethPredictor(const std::uint8_t left, const std::uint8_t above, const std::uint8_t aboveLeft) {
+	const auto estimate = static_cast<int>(left) + above - aboveLeft;
+	const auto distanceLeft = std::abs(estimate - left);
+	const auto distanceAbove = std::abs(estimate - above);
+	const auto distanceAboveLeft = std::abs(estimate - aboveLeft);
+
+	if (distanceLeft <= distanceAbove && distanceLeft <= distanceAboveLeft) {
+		return left;
+	}
+
+	return distanceAbove <= distanceAboveLeft ? above : aboveLeft;
+}
+
+// Undo the filter of a scanline in place, "previous" is the unfiltered scanline above it (zeros for the first one)
+// Reference: https://www.w3.org/TR/png/#9Filters
+static bool unfilterPngRow(const std::uint8_t filter, std::uint8_t* const row, const std::uint8_t* const previous, const std::size_t rowSize, const std::size_t bytesPerPixel) {
+	switch (filter) {
+		case 0:
+			return true;
+
+		case 1:
+			for (auto i = bytesPerPixel; i < rowSize; ++i) {
+				row[i] = static_cast<std::uint8_t>(row[i] + row[i - bytesPerPixel]);
+			}
+
+			return true;
+
+		case 2:
+			for (std::size_t i = 0; i < rowSize; ++i) {
+				row[i] = static_cast<std::uint8_t>(row[i] + previous[i]);
+			}
+
+			return true;
+
+		case 3:
+			for (std::size_t i = 0; i < rowSize; ++i) {
+				const auto left = i >= bytesPerPixel ? row[i - bytesPerPixel] : 0;
+				row[i] = static_cast<std::uint8_t>(row[i] + (left + previous[i]) / 2);
+			}
+
+			return true;
+
+		case 4:
+			for (std::size_t i = 0; i < rowSize; ++i) {
+				const auto left = i >= bytesPerPixel ? row[i - bytesPerPixel] : std::uint8_t{ 0 };
+				const auto aboveLeft = i >= bytesPerPixel ? previous[i - bytesPerPixel] : std::uint8_t{ 0 };
+				row[i] = static_cast<std::uint8_t>(row[i] + paethPredictor(left, previous[i], aboveLeft));
+			}
+
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+static bool readPngHeader(const std::span<const std::uint8_t> chunk, PngHeader& header) {
+	if (chunk.size() != 13) {
+		return false;
+	}
+
+	header.width = readBigEndian32(chunk, 0);
+	header.height = readBigEndian32(chunk, 4);
+	header.bitDepth = chunk[8];
+	header.colorType = static_cast<PngColorType>(chunk[9]);
+	header.isInterlaced = chunk[12] == 1;
+
+	const auto compressionMethod = chunk[10];
+	const auto filterMethod = chunk[11];
+
+	if (compressionMethod != 0 || filterMethod != 0 || chunk[12] > 1) {
+		return false;
+	}
+
+	const auto isBitDepth = [&header](const std::initializer_list<std::uint32_t> depths) {
+		return std::find(depths.begin(), depths.end(), header.bitDepth) != depths.end();
+	};
+
+	switch (header.colorType) {
+		case PngColorType::Grayscale:
+			header.channelCount = 1;
+			return isBitDepth({ 1, 2, 4, 8, 16 });
+
+		case PngColorType::Truecolor:
+			header.channelCount = 3;
+			return isBitDepth({ 8, 16 });
+
+		case PngColorType::Indexed:
+			header.channelCount = 1;
+			return isBitDepth({ 1, 2, 4, 8 });
+
+		case PngColorType::GrayscaleAlpha:
+			header.channelCount = 2;
+			return isBitDepth({ 8, 16 });
+
+		case PngColorType::TruecolorAlpha:
+			header.channelCount = 4;
+			return isBitDepth({ 8, 16 });
+
+		default:
+			return false;
+	}
+}
+
+static std::optional<DecodedImage> decodePng(const std::span<const std::uint8_t> data, const std::uint32_t maxWidth, const std::uint32_t maxHeight) {
+	PngHeader header{};
+	PngColors colors{};
+
+	// The image data is decompressed straight from the chunks, which are never joined into one buffer
+	std::vector<std::span<const std::uint8_t>> compressed;
+
+	auto hasHeader = false;
+	auto hasEnd = false;
+
+	// Chunks are a length, a type, the data, and a checksum
+	for (auto offset = PNG_SIGNATURE.size(); !hasEnd && offset + 12 <= data.size();) {
+		const auto length = readBigEndian32(data, offset);
+
+		if (length > data.size() - offset - 12) {
+			spdlog::error("Unable to decode PNG image, a chunk runs past the end of the file");
+			return std::nullopt;
+		}
+
+		const std::string_view type(reinterpret_cast<const char*>(data.data() + offset + 4), 4);
+		const auto chunk = data.subspan(offset + 8, length);
+		offset += 12 + static_cast<std::size_t>(length);
+
+		if (type == "IHDR") {
+			hasHeader = readPngHeader(chunk, header);
+
+			if (!hasHeader) {
+				spdlog::error("Unable to decode PNG image, its header is invalid");
+				return std::nullopt;
+			}
+		} else if (type == "PLTE") {
+			colors.palette.clear();
+
+			for (std::size_t i = 0; i + 3 <= chunk.size() && colors.palette.size() < 256 * 4; i += 3) {
+				colors.palette.insert(colors.palette.end(), { chunk[i], chunk[i + 1], chunk[i + 2], 255 });
+			}
+		} else if (type == "tRNS") {
+			if (header.colorType == PngColorType::Indexed) {
+				for (std::size_t i = 0; i < chunk.size() && i * 4 + 3 < colors.palette.size(); ++i) {
+					colors.palette[i * 4 + 3] = chunk[i];
+				}
+			} else if (header.colorType == PngColorType::Grayscale && chunk.size() >= 2) {
+				const auto gray = readBigEndian16(chunk, 0);
+				colors.transparentColor = { gray, gray, gray };
+			} else if (header.colorType == PngColorType::Truecolor && chunk.size() >= 6) {
+				colors.transparentColor = { readBigEndian16(chunk, 0), readBigEndian16(chunk, 2), readBigEndian16(chunk, 4) };
+			}
+		} else if (type == "IDAT") {
+			compressed.push_back(chunk);
+		} else if (type == "IEND") {
+			hasEnd = true;
+		}
+	}
+
+	if (!hasHeader || compressed.empty()) {
+		spdlog::error("Unable to decode PNG image, it has no header or no image data");
+		return std::nullopt;
+	}
+
+	if (isTooLarge(header.width, header.height)) {
+		spdlog::error("Unable to decode {}x{} PNG image, it is empty or too large", header.width, header.height);
+		return std::nullopt;
+	}
+
+	if (header.isInterlaced) {
+		spdlog::error("Unable to decode {}x{} PNG image, interlaced images are not supported", header.width, header.height);
+		return std::nullopt;
+	}
+
+	if (header.colorType == PngColorType::Indexed && colors.palette.empty()) {
+		spdlog::error("Unable to decode PNG image, it uses a palette but has none");
+		return std::nullopt;
+	}
+
+	const auto bitsPerPixel = static_cast<std::size_t>(header.bitDepth) * header.channelCount;
+	const auto rowSize = (static_cast<std::size_t>(header.width) * bitsPerPixel + 7) / 8;
+	const auto bytesPerPixel = std::max<std::size_t>(1, bitsPerPixel / 8);
+
+	DecodedImage image{ getTargetSize(header.width, maxWidth), getTargetSize(header.height, maxHeight), header.width, header.height, {} };
+	RowScaler scaler(header.width, header.height, image.width, image.height);
+
+	// Scanlines are decompressed one at a time, unfiltering only needs the one above it (zeros for the first one)
+	// Every scanline starts with the type of its filter
+	Inflater inflater(std::move(compressed));
+	std::vector<std::uint8_t> row(rowSize + 1, 0);
+	std::vector<std::uint8_t> previous(rowSize + 1, 0);
+	std::vector<std::uint8_t> rgba(static_cast<std::size_t>(header.width) * 4);
+
+	for (std::uint32_t y = 0; y < header.height; ++y) {
+		const auto readSize = inflater.read(row);
+
+		if (!readSize.has_value() || readSize.value() != row.size()) {
+			spdlog::error("Unable to decode {}x{} PNG image, its image data is corrupt", header.width, header.height);
+			return std::nullopt;
+		}
+
+		if (!unfilterPngRow(row[0], row.data() + 1, previous.data() + 1, rowSize, bytesPerPixel)) {
+			spdlog::error("Unable to decode {}x{} PNG image, scanline {} uses unknown filter {}", header.width, header.height, y, row[0]);
+			return std::nullopt;
+		}
+
+		expandPngRow(header, colors, row.data() + 1, rgba.data());
+		premultiplyRow(rgba.data(), header.width);
+		scaler.addRow(rgba.data());
+
+		std::swap(row, previous);
+	}
+
+	// Data past the last scanline means the image data does not match the header
+	std::uint8_t excess = 0;
+	const auto excessSize = inflater.read(std::span(&excess, 1));
+
+	if (!excessSize.has_value() || excessSize.value() != 0) {
+		spdlog::error("Unable to decode {}x{} PNG image, its image data is corrupt", header.width, header.height);
+		return std::nullopt;
+	}
+
+	image.pixels = scaler.takePixels();
+	return image;
+}
+
+// Skip whitespace and comments, then read a decimal number
+static std::optional<std::uint32_t> readPpmNumber(const std::span<const std::uint8_t> data, std::size_t& offset) {
+	while (offset < data.size()) {
+		if (data[offset] == '#') {
+			while (offset < data.size() && data[offset] != '\n') {
+				++offset;
+			}
+		} else if (std::isspace(data[offset]) != 0) {
+			++offset;
+		} else {
+			break;
+		}
+	}
+
+	constexpr std::uint64_t maxValue = std::numeric_limits<std::uint32_t>::max();
+
+	std::uint64_t value = 0;
+	const auto start = offset;
+
+	while (offset < data.size() && data[offset] >= '0' && data[offset] <= '9' && value <= maxValue) {
+		value = value * 10 + static_cast<std::uint64_t>(data[offset++] - '0');
+	}
+
+	if (offset == start || value > maxValue) {
+		return std::nullopt;
+	}
+
+	return static_cast<std::uint32_t>(value);
+}
+
+// Binary PPM, as written by saveFrame(), with 8 or 16 bits per sample
+static std::optional<DecodedImage> decodePpm(const std::span<const std::uint8_t> data, const std::uint32_t maxWidth, const std::uint32_t maxHeight) {
+	std::size_t offset = 2;
+
+	const auto width = readPpmNumber(data, offset);
+	const auto height = readPpmNumber(data, offset);
+	const auto maxValue = readPpmNumber(data, offset);
+
+	// A single whitespace character separates the header from the samples
+	if (!width.has_value() || !height.has_value() || !maxValue.has_value() || maxValue.value() == 0 || maxValue.value() > 65'535 || offset >= data.size()) {
+		spdlog::error("Unable to decode PPM image, its header is invalid");
+		return std::nullopt;
+	}
+
+	++offset;
+
+	if (isTooLarge(width.value(), height.value())) {
+		spdlog::error("Unable to decode {}x{} PPM image, it is empty or too large", width.value(), height.value());
+		return std::nullopt;
+	}
+
+	const std::size_t bytesPerSample = maxValue.value() < 256 ? 1 : 2;
+	const auto rowSize = static_cast<std::size_t>(width.value()) * 3 * bytesPerSample;
+
+	if (data.size() - offset < rowSize * height.value()) {
+		spdlog::error("Unable to decode {}x{} PPM image, the file is truncated", width.value(), height.value());
+		return std::nullopt;
+	}
+
+	DecodedImage image{ getTargetSize(width.value(), maxWidth), getTargetSize(height.value(), maxHeight), width.value(), height.value(), {} };
+	RowScaler scaler(width.value(), height.value(), image.width, image.height);
+
+	// Every pixel is opaque, so there is nothing to premultiply
+	std::vector<std::uint8_t> rgba(static_cast<std::size_t>(width.value()) * 4, 255);
+
+	for (std::uint32_t y = 0; y < height.value(); ++y) {
+		const auto row = data.subspan(offset + y * rowSize, rowSize);
+
+		for (std::size_t i = 0; i < static_cast<std::size_t>(width.value()) * 3; ++i) {
+			const auto sample = bytesPerSample == 1 ? row[i] : readBigEndian16(row, i * 2);
+			rgba[i / 3 * 4 + i % 3] = static_cast<std::uint8_t>(sample * 255 / maxValue.value());
+		}
+
+		scaler.addRow(rgba.data());
+	}
+
+	image.pixels = scaler.takePixels();
+	return image;
+}
+
+ImageFormat graphics::image::detectImageFormat(const std::span<const std::uint8_t> data) {
+	const auto startsWith = [data](const std::initializer_list<std::uint8_t> signature, const std::size_t offset = 0) {
+		return data.size() >= offset + signature.size() && std::equal(signature.begin(), signature.end(), data.begin() + static_cast<std::ptrdiff_t>(offset));
+	};
+
+	if (data.size() >= PNG_SIGNATURE.size() && std::equal(PNG_SIGNATURE.begin(), PNG_SIGNATURE.end(), data.begin())) {
+		return ImageFormat::Png;
+	}
+
+	if (startsWith({ 'P', '6' })) {
+		return ImageFormat::Ppm;
+	}
+
+	if (startsWith({ 0xFF, 0xD8, 0xFF })) {
+		return ImageFormat::Jpeg;
+	}
+
+	if (startsWith({ 'R', 'I', 'F', 'F' }) && startsWith({ 'W', 'E', 'B', 'P' }, 8)) {
+		return ImageFormat::WebP;
+	}
+
+	if (startsWith({ 'G', 'I', 'F', '8' })) {
+		return ImageFormat::Gif;
+	}
+
+	return ImageFormat::Unknown;
+}
+
+std::optional<DecodedImage> graphics::image::decodeImage(const std::span<const std::uint8_t> data, const std::uint32_t maxWidth, const std::uint32_t maxHeight) {
+	switch (detectImageFormat(data)) {
+		case ImageFormat::Png:
+			return decodePng(data, maxWidth, maxHeight);
+
+		case ImageFormat::Ppm:
+			return decodePpm(data, maxWidth, maxHeight);
+
+		case ImageFormat::Jpeg:
+		case ImageFormat::WebP:
+		case ImageFormat::Gif:
+			spdlog::error("Unable to decode image, there is no decoder for its format yet");
+			return std::nullopt;
+
+		default:
+			spdlog::error("Unable to decode image, its format is not recognized");
+			return std::nullopt;
+	}
+}
+
+std::optional<DecodedImage> graphics::image::decodeImageFile(const std::string_view& path, const std::uint32_t maxWidth, const std::uint32_t maxHeight) {
+	std::ifstream file(std::string(path), std::ios::binary);
+
+	if (!file.is_open()) {
+		spdlog::error("Unable to open image \"{}\"", path);
+		return std::nullopt;
+	}
+
+	const std::vector<std::uint8_t> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	return decodeImage(data, maxWidth, maxHeight);
+}
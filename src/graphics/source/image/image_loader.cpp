@@ -0,0 +1,192 @@
+#include "graphics/image/image_loader.hpp"
+
+#include "core/threading/thread_pool.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+using namespace graphics::image;
+using namespace graphics::renderer;
+
+// Decoded bitmaps that wait to come into view may take up this much memory by default
+constexpr std::size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+// Images within this many viewports of the visible area are decoded ahead of time, so they are ready when scrolled to
+constexpr float PREFETCH_DISTANCE = 1.0f;
+
+static std::uint32_t toPixels(const float length) {
+	return static_cast<std::uint32_t>(std::max(1.0f, std::ceil(length)));
+}
+
+static float getSquaredDistance(const Rectangle& a, const Rectangle& b) {
+	const auto x = (a.x + a.width * 0.5f) - (b.x + b.width * 0.5f);
+	const auto y = (a.y + a.height * 0.5f) - (b.y + b.height * 0.5f);
+
+	return x * x + y * y;
+}
+
+// Deferred futures (decodes without a thread pool) are ready as well, get() runs them
+template<typename Result>
+static bool isReady(const std::future<Result>& future) {
+	return future.wait_for(std::chrono::seconds{ 0 }) != std::future_status::timeout;
+}
+
+ImageLoader::ImageLoader(core::threading::ThreadPool* threadPool, CreateTextureFunction createTexture, std::function<void()> onProgress) :
+	threadPool(threadPool),
+	createTexture(std::move(createTexture)),
+	onProgress(std::move(onProgress)),
+	images{},
+	memoryBudget{ DEFAULT_MEMORY_BUDGET },
+	decodedBytes{ 0 },
+	pendingBytes{ 0 } {}
+
+ImageId ImageLoader::add(std::string path, const Rectangle& bounds) {
+	images.push_back({ std::move(path), bounds, State::Unloaded, 0, 0, {}, std::nullopt, {}, NO_TEXTURE });
+	return static_cast<ImageId>(images.size() - 1);
+}
+
+void ImageLoader::setBounds(const ImageId image, const Rectangle& bounds) {
+	auto& entry = images[image];
+	entry.bounds = bounds;
+
+	// Uploaded images keep their texture and are stretched, a decode in progress is checked once it completes
+	if (entry.state == State::Decoded && (entry.decodeWidth != toPixels(bounds.width) || entry.decodeHeight != toPixels(bounds.height))) {
+		discardBitmap(entry);
+	}
+}
+
+TextureId ImageLoader::getTexture(const ImageId image) const {
+	return image < images.size() ? images[image].texture : NO_TEXTURE;
+}
+
+bool ImageLoader::update(const Rectangle& viewport) {
+	const Rectangle prefetchArea = {
+		viewport.x - viewport.width * PREFETCH_DISTANCE,
+		viewport.y - viewport.height * PREFETCH_DISTANCE,
+		viewport.width * (1.0f + 2.0f * PREFETCH_DISTANCE),
+		viewport.height * (1.0f + 2.0f * PREFETCH_DISTANCE)
+	};
+
+	auto hasNewTextures = false;
+
+	for (auto& image : images) {
+		if (image.state == State::Decoding && isReady(image.decode)) {
+			image.bitmap = image.decode.get();
+			pendingBytes -= static_cast<std::size_t>(image.decodeWidth) * image.decodeHeight * 4;
+
+			if (!image.bitmap.has_value()) {
+				spdlog::warn("Image \"{}\" could not be decoded and will not be shown", image.path);
+				image.state = State::Failed;
+				continue;
+			}
+
+			image.state = State::Decoded;
+			decodedBytes += image.bitmap->pixels.size();
+
+			// Layout changed while the image was being decoded
+			if (image.decodeWidth != toPixels(image.bounds.width) || image.decodeHeight != toPixels(image.bounds.height)) {
+				discardBitmap(image);
+			}
+		}
+
+		// Visible images are always decoded, images that are merely close only while their bitmaps would fit the budget
+		if (image.state == State::Unloaded && image.bounds.intersects(prefetchArea)) {
+			const auto bitmapSize = static_cast<std::size_t>(toPixels(image.bounds.width)) * toPixels(image.bounds.height) * 4;
+
+			if (image.bounds.intersects(viewport) || decodedBytes + pendingBytes + bitmapSize <= memoryBudget) {
+				startDecode(image);
+			}
+		}
+
+		if (image.state == State::Decoded && image.bounds.intersects(viewport)) {
+			auto& bitmap = image.bitmap.value();
+			decodedBytes -= bitmap.pixels.size();
+
+			// The renderer streams the pixels to the GPU and releases them once they are copied
+			image.upload = createTexture(bitmap.width, bitmap.height, std::move(bitmap.pixels), onProgress);
+			image.bitmap.reset();
+			image.state = State::Uploading;
+		}
+
+		// Checked after the upload started, a renderer owned by this thread creates the texture right away
+		if (image.state == State::Uploading && isReady(image.upload)) {
+			image.texture = image.upload.get();
+			image.state = image.texture != NO_TEXTURE ? State::Uploaded : State::Failed;
+
+			hasNewTextures = hasNewTextures || image.texture != NO_TEXTURE;
+		}
+	}
+
+	if (decodedBytes > memoryBudget) {
+		enforceMemoryBudget(viewport);
+	}
+
+	return hasNewTextures;
+}
+
+void ImageLoader::setMemoryBudget(const std::size_t bytes) {
+	memoryBudget = bytes;
+}
+
+std::size_t ImageLoader::getDecodedBytes() const {
+	return decodedBytes;
+}
+
+void ImageLoader::startDecode(Image& image) {
+	image.decodeWidth = toPixels(image.bounds.width);
+	image.decodeHeight = toPixels(image.bounds.height);
+	image.state = State::Decoding;
+
+	// Images are never scaled up, so this is an upper limit of the bitmap size
+	pendingBytes += static_cast<std::size_t>(image.decodeWidth) * image.decodeHeight * 4;
+
+	// Everything the decode needs is copied, so it may outlive the loader
+	auto task = [path = image.path, width = image.decodeWidth, height = image.decodeHeight, callback = onProgress]() {
+		auto decoded = decodeImageFile(path, width, height);
+
+		if (callback) {
+			callback();
+		}
+
+		return decoded;
+	};
+
+	image.decode = threadPool != nullptr ? threadPool->submit(std::move(task)) : std::async(std::launch::deferred, std::move(task));
+}
+
+void ImageLoader::discardBitmap(Image& image) {
+	decodedBytes -= image.bitmap->pixels.size();
+
+	image.bitmap.reset();
+	image.state = State::Unloaded;
+}
+
+void ImageLoader::enforceMemoryBudget(const Rectangle& viewport) {
+	std::vector<Image*> decoded;
+
+	for (auto& image : images) {
+		if (image.state == State::Decoded) {
+			decoded.push_back(&image);
+		}
+	}
+
+	std::sort(decoded.begin(), decoded.end(), [&viewport](const Image* a, const Image* b) {
+		return getSquaredDistance(a->bounds, viewport) > getSquaredDistance(b->bounds, viewport);
+	});
+
+	const auto previousBytes = decodedBytes;
+
+	for (auto* image : decoded) {
+		if (decodedBytes <= memoryBudget) {
+			break;
+		}
+
+		discardBitmap(*image);
+	}
+
+	spdlog::debug("Discarded {}KB of decoded images to stay within the {}KB budget", (previousBytes - decodedBytes) / 1024, memoryBudget / 1024);
+}
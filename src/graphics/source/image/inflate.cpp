@@ -0,0 +1,412 @@
+#include "graphics/image/inflate.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace graphics::image;
+
+constexpr std::size_t DISTANCE_CODE_COUNT = 32;
+constexpr std::size_t CODE_LENGTH_CODE_COUNT = 19;
+
+constexpr std::uint32_t END_OF_BLOCK = 256;
+
+// Reference: https://www.rfc-editor.org/rfc/rfc1951#section-3.2.5
+constexpr std::array<std::uint16_t, 29> LENGTH_BASES = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+constexpr std::array<std::uint8_t, 29> LENGTH_EXTRA_BITS = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+constexpr std::array<std::uint16_t, 30> DISTANCE_BASES = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+constexpr std::array<std::uint8_t, 30> DISTANCE_EXTRA_BITS = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Order in which the code lengths of the code length alphabet are stored in a dynamic block
+constexpr std::array<std::uint8_t, CODE_LENGTH_CODE_COUNT> CODE_LENGTH_ORDER = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+std::uint32_t Inflater::BitReader::peek(const std::uint32_t bitCount) {
+	while (count <= 56) {
+		std::uint64_t byte = 0;
+
+		// Empty parts are skipped, they contribute nothing to the stream
+		while (partIndex < parts.size() && position == parts[partIndex].size()) {
+			++partIndex;
+			position = 0;
+		}
+
+		if (partIndex < parts.size()) {
+			byte = parts[partIndex][position++];
+		} else {
+			++paddingBytes;
+		}
+
+		buffer |= byte << count;
+		count += 8;
+	}
+
+	return static_cast<std::uint32_t>(buffer & ((std::uint64_t{ 1 } << bitCount) - 1));
+}
+
+void Inflater::BitReader::consume(const std::uint32_t bitCount) {
+	buffer >>= bitCount;
+	count -= bitCount;
+}
+
+std::uint32_t Inflater::BitReader::read(const std::uint32_t bitCount) {
+	const auto value = peek(bitCount);
+	consume(bitCount);
+	return value;
+}
+
+void Inflater::BitReader::alignToByte() {
+	consume(count % 8);
+}
+
+bool Inflater::BitReader::isOverrun() const {
+	return paddingBytes > count / 8;
+}
+
+static std::uint32_t reverseBits(std::uint32_t value, const std::uint32_t bitCount) {
+	std::uint32_t reversed = 0;
+
+	for (std::uint32_t i = 0; i < bitCount; ++i) {
+		reversed = (reversed << 1) | (value & 1);
+		value >>= 1;
+	}
+
+	return reversed;
+}
+
+// Incomplete codes are allowed (a single distance code is common), over-subscribed codes are not
+bool Inflater::buildTable(HuffmanTable& table, const std::span<const std::uint8_t> lengths) {
+	table.counts.fill(0);
+	table.fast.fill(0);
+
+	for (const auto length : lengths) {
+		++table.counts[length];
+	}
+
+	table.counts[0] = 0;
+
+	std::int32_t remaining = 1;
+
+	for (std::uint32_t length = 1; length <= MAX_CODE_LENGTH; ++length) {
+		remaining = (remaining << 1) - table.counts[length];
+
+		if (remaining < 0) {
+			return false;
+		}
+	}
+
+	std::array<std::uint16_t, MAX_CODE_LENGTH + 1> offsets{};
+	std::array<std::uint32_t, MAX_CODE_LENGTH + 1> nextCodes{};
+	std::uint32_t code = 0;
+
+	for (std::uint32_t length = 1; length <= MAX_CODE_LENGTH; ++length) {
+		offsets[length] = static_cast<std::uint16_t>(offsets[length - 1] + table.counts[length - 1]);
+
+		code = (code + table.counts[length - 1]) << 1;
+		nextCodes[length] = code;
+	}
+
+	for (std::size_t symbol = 0; symbol < lengths.size(); ++symbol) {
+		const auto length = lengths[symbol];
+
+		if (length == 0) {
+			continue;
+		}
+
+		table.symbols[offsets[length]++] = static_cast<std::uint16_t>(symbol);
+
+		const auto symbolCode = nextCodes[length]++;
+
+		if (length <= FAST_BITS) {
+			// Codes are stored most significant bit first, while the lookup index is in stream order
+			for (auto index = reverseBits(symbolCode, length); index < table.fast.size(); index += 1u << length) {
+				table.fast[index] = static_cast<std::uint16_t>(symbol << 4 | length);
+			}
+		}
+	}
+
+	return true;
+}
+
+std::optional<std::uint32_t> Inflater::decodeSymbol(BitReader& reader, const HuffmanTable& table) {
+	const auto entry = table.fast[reader.peek(FAST_BITS)];
+
+	if (entry != 0) {
+		reader.consume(entry & 0xF);
+		return entry >> 4;
+	}
+
+	std::int32_t code = 0;
+	std::int32_t first = 0;
+	std::int32_t index = 0;
+
+	for (std::uint32_t length = 1; length <= MAX_CODE_LENGTH; ++length) {
+		code |= static_cast<std::int32_t>(reader.read(1));
+
+		const auto count = static_cast<std::int32_t>(table.counts[length]);
+
+		if (code - count < first) {
+			return table.symbols[static_cast<std::size_t>(index + (code - first))];
+		}
+
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+
+	return std::nullopt;
+}
+
+bool Inflater::readDynamicTables(BitReader& reader, HuffmanTable& literals, HuffmanTable& distances) {
+	const auto literalCount = reader.read(5) + 257;
+	const auto distanceCount = reader.read(5) + 1;
+	const auto codeLengthCount = reader.read(4) + 4;
+
+	std::array<std::uint8_t, CODE_LENGTH_CODE_COUNT> codeLengthLengths{};
+
+	for (std::uint32_t i = 0; i < codeLengthCount; ++i) {
+		codeLengthLengths[CODE_LENGTH_ORDER[i]] = static_cast<std::uint8_t>(reader.read(3));
+	}
+
+	HuffmanTable codeLengths{};
+
+	if (!buildTable(codeLengths, codeLengthLengths)) {
+		return false;
+	}
+
+	// Literal/length and distance code lengths form a single sequence, repeats may cross from one into the other
+	std::array<std::uint8_t, LITERAL_LENGTH_CODE_COUNT + DISTANCE_CODE_COUNT> lengths{};
+	std::uint32_t index = 0;
+
+	while (index < literalCount + distanceCount) {
+		const auto symbol = decodeSymbol(reader, codeLengths);
+
+		if (!symbol.has_value() || reader.isOverrun()) {
+			return false;
+		}
+
+		if (symbol.value() < 16) {
+			lengths[index++] = static_cast<std::uint8_t>(symbol.value());
+			continue;
+		}
+
+		std::uint8_t repeatedLength = 0;
+		std::uint32_t repeatCount = 0;
+
+		if (symbol.value() == 16) {
+			if (index == 0) {
+				return false;
+			}
+
+			repeatedLength = lengths[index - 1];
+			repeatCount = 3 + reader.read(2);
+		} else if (symbol.value() == 17) {
+			repeatCount = 3 + reader.read(3);
+		} else {
+			repeatCount = 11 + reader.read(7);
+		}
+
+		if (index + repeatCount > literalCount + distanceCount) {
+			return false;
+		}
+
+		for (std::uint32_t i = 0; i < repeatCount; ++i) {
+			lengths[index++] = repeatedLength;
+		}
+	}
+
+	// Without an end-of-block code the block could never end
+	if (lengths[END_OF_BLOCK] == 0) {
+		return false;
+	}
+
+	return buildTable(literals, std::span(lengths).subspan(0, literalCount)) && buildTable(distances, std::span(lengths).subspan(literalCount, distanceCount));
+}
+
+void Inflater::buildFixedTables(HuffmanTable& literals, HuffmanTable& distances) {
+	std::array<std::uint8_t, LITERAL_LENGTH_CODE_COUNT> literalLengths{};
+	std::array<std::uint8_t, DISTANCE_CODE_COUNT> distanceLengths{};
+
+	for (std::size_t symbol = 0; symbol < literalLengths.size(); ++symbol) {
+		literalLengths[symbol] = symbol < 144 ? 8 : symbol < 256 ? 9 : symbol < 280 ? 7 : 8;
+	}
+
+	distanceLengths.fill(5);
+
+	buildTable(literals, literalLengths);
+	buildTable(distances, distanceLengths);
+}
+
+Inflater::Inflater(std::vector<std::span<const std::uint8_t>> parts) :
+	reader{ std::move(parts), 0, 0, 0, 0, 0 },
+	literals{},
+	distances{},
+	state{ State::BlockHeader },
+	isFinalBlock{ false },
+	storedRemaining{ 0 },
+	copyLength{ 0 },
+	copyDistance{ 0 },
+	window(WINDOW_SIZE, 0),
+	totalOutput{ 0 } {
+	const auto compressionMethod = reader.read(4);
+	const auto windowBits = reader.read(4);
+	const auto flags = reader.read(8);
+	const auto hasPresetDictionary = (flags & 0x20) != 0;
+
+	// Deflate compression with a window that fits into ours, a checksum in the header, and no preset dictionary
+	if (compressionMethod != 8 || windowBits > 7 || ((windowBits << 4 | compressionMethod) << 8 | flags) % 31 != 0 || hasPresetDictionary || reader.isOverrun()) {
+		state = State::Failed;
+	}
+}
+
+std::optional<std::size_t> Inflater::read(const std::span<std::uint8_t> output) {
+	std::size_t written = 0;
+
+	// The trailing Adler-32 checksum is not verified, corrupt data fails to decode or results in wrong pixels - never in out of bounds access
+	while (written < output.size()) {
+		if (state == State::Failed) {
+			return std::nullopt;
+		}
+
+		if (state == State::Finished) {
+			break;
+		}
+
+		if (state == State::BlockHeader) {
+			if (isFinalBlock) {
+				state = State::Finished;
+			} else if (!beginBlock()) {
+				state = State::Failed;
+			}
+
+			continue;
+		}
+
+		if (state == State::StoredBlock) {
+			if (storedRemaining == 0) {
+				state = State::BlockHeader;
+				continue;
+			}
+
+			emit(static_cast<std::uint8_t>(reader.read(8)), output.data() + written++);
+			--storedRemaining;
+
+			if (reader.isOverrun()) {
+				state = State::Failed;
+			}
+
+			continue;
+		}
+
+		// The source of a back-reference may overlap the bytes being written, which repeats them, so copy one byte at a time
+		if (copyLength > 0) {
+			const auto count = std::min<std::size_t>(copyLength, output.size() - written);
+
+			for (std::size_t i = 0; i < count; ++i) {
+				emit(window[(totalOutput - copyDistance) % WINDOW_SIZE], output.data() + written++);
+			}
+
+			copyLength -= static_cast<std::uint32_t>(count);
+			continue;
+		}
+
+		const auto symbol = decodeSymbol(reader, literals);
+
+		if (!symbol.has_value() || reader.isOverrun()) {
+			state = State::Failed;
+			continue;
+		}
+
+		if (symbol.value() < END_OF_BLOCK) {
+			emit(static_cast<std::uint8_t>(symbol.value()), output.data() + written++);
+			continue;
+		}
+
+		if (symbol.value() == END_OF_BLOCK) {
+			state = State::BlockHeader;
+			continue;
+		}
+
+		const auto lengthCode = symbol.value() - 257;
+
+		if (lengthCode >= LENGTH_BASES.size()) {
+			state = State::Failed;
+			continue;
+		}
+
+		const auto length = LENGTH_BASES[lengthCode] + reader.read(LENGTH_EXTRA_BITS[lengthCode]);
+		const auto distanceCode = decodeSymbol(reader, distances);
+
+		if (!distanceCode.has_value() || distanceCode.value() >= DISTANCE_BASES.size()) {
+			state = State::Failed;
+			continue;
+		}
+
+		const auto distance = DISTANCE_BASES[distanceCode.value()] + reader.read(DISTANCE_EXTRA_BITS[distanceCode.value()]);
+
+		if (distance > totalOutput) {
+			state = State::Failed;
+			continue;
+		}
+
+		copyLength = length;
+		copyDistance = distance;
+	}
+
+	return written;
+}
+
+bool Inflater::beginBlock() {
+	isFinalBlock = reader.read(1) != 0;
+
+	switch (reader.read(2)) {
+		case 0:
+		{
+			reader.alignToByte();
+
+			const auto length = reader.read(16);
+			const auto complement = reader.read(16);
+
+			if ((length ^ 0xFFFF) != complement || reader.isOverrun()) {
+				return false;
+			}
+
+			storedRemaining = length;
+			state = State::StoredBlock;
+			return true;
+		}
+
+		case 1:
+			buildFixedTables(literals, distances);
+			state = State::CompressedBlock;
+			return true;
+
+		case 2:
+			if (!readDynamicTables(reader, literals, distances)) {
+				return false;
+			}
+
+			state = State::CompressedBlock;
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+void Inflater::emit(const std::uint8_t byte, std::uint8_t* const output) {
+	*output = byte;
+	window[totalOutput % WINDOW_SIZE] = byte;
+	++totalOutput;
+}
@@ -0,0 +1,79 @@
+#include "graphics/renderer/cache_file.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <fstream>
+#include <ios>
+#include <system_error>
+
+constexpr std::uint64_t FNV_PRIME = 1'099'511'628'211ull;
+
+std::uint64_t graphics::renderer::hashBytes(const std::span<const std::uint8_t> bytes, const std::uint64_t seed) {
+	auto hash = seed;
+
+	for (const auto byte : bytes) {
+		hash ^= byte;
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+std::optional<std::vector<std::uint8_t>> graphics::renderer::readCacheFile(const std::filesystem::path& path) {
+	std::ifstream file{ path, std::ios::binary | std::ios::ate };
+
+	if (!file.is_open()) {
+		return std::nullopt;
+	}
+
+	const auto size = file.tellg();
+
+	if (size < 0) {
+		return std::nullopt;
+	}
+
+	std::vector<std::uint8_t> bytes(static_cast<std::size_t>(size));
+	file.seekg(0);
+
+	if (!file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+		spdlog::warn("Failed to read cache file: {}", path.string());
+		return std::nullopt;
+	}
+
+	return bytes;
+}
+
+bool graphics::renderer::writeCacheFile(const std::filesystem::path& path, const std::span<const std::uint8_t> bytes) {
+	std::error_code error{};
+
+	if (path.has_parent_path()) {
+		std::filesystem::create_directories(path.parent_path(), error);
+
+		if (error) {
+			spdlog::warn("Failed to create cache directory {}: {}", path.parent_path().string(), error.message());
+			return false;
+		}
+	}
+
+	auto temporaryPath = path;
+	temporaryPath += ".tmp";
+
+	{
+		std::ofstream file{ temporaryPath, std::ios::binary | std::ios::trunc };
+
+		if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+			spdlog::warn("Failed to write cache file: {}", temporaryPath.string());
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, path, error);
+
+	if (error) {
+		spdlog::warn("Failed to replace cache file {}: {}", path.string(), error.message());
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,353 @@
+#include "graphics/renderer/compositor.hpp"
+#include "graphics/renderer/renderer.hpp"
+#include "graphics/window/window.hpp"
+
+#include "core/profiling/trace.hpp"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+using namespace graphics::renderer;
+
+// Upper limit of how long the compositor sleeps when there is nothing to draw, anything the main thread hands over wakes it right away
+constexpr std::chrono::milliseconds IDLE_WAIT_TIMEOUT{ 1'000 };
+
+// Time it takes smooth scrolling to cover about two thirds of the remaining distance
+constexpr std::chrono::duration<float> SCROLL_SMOOTHING_TIME{ 0.05f };
+
+// Smooth scrolling snaps to its target once it is closer than this many pixels
+constexpr float SCROLL_SNAP_DISTANCE = 0.5f;
+
+// Linear interpolation between the properties of two layers
+static LayerProperties mix(const LayerProperties& from, const LayerProperties& to, const float progress) {
+	return {
+		glm::mix(from.translateX, to.translateX, progress),
+		glm::mix(from.translateY, to.translateY, progress),
+		glm::mix(from.scale, to.scale, progress),
+		glm::mix(from.rotation, to.rotation, progress),
+		glm::mix(from.opacity, to.opacity, progress)
+	};
+}
+
+// Position along an animation curve at a point in time between 0 and 1
+static float ease(const Easing easing, const float time) {
+	switch (easing) {
+		case Easing::EaseInOut:
+			return time * time * (3.0f - 2.0f * time);
+		default:
+			return time;
+	}
+}
+
+// Matrix that applies the transform of a layer around the center of the viewport
+static std::array<float, 16> createTransform(const LayerProperties& properties, const float viewportWidth, const float viewportHeight) {
+	const auto center = glm::vec3(viewportWidth * 0.5f, viewportHeight * 0.5f, 0.0f);
+
+	// Vulkan's y-axis points down, so a positive rotation around the z-axis turns the layer clockwise on screen
+	auto matrix = glm::translate(glm::mat4(1.0f), center + glm::vec3(properties.translateX, properties.translateY, 0.0f));
+	matrix = glm::rotate(matrix, properties.rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+	matrix = glm::scale(matrix, glm::vec3(properties.scale, properties.scale, 1.0f));
+	matrix = glm::translate(matrix, -center);
+
+	std::array<float, 16> transform{};
+	std::memcpy(transform.data(), glm::value_ptr(matrix), sizeof(transform));
+
+	return transform;
+}
+
+Compositor::Compositor(Renderer& renderer, const window::Window& window) :
+	renderer(renderer),
+	window(window),
+	thread{},
+	frameInterval{ std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double>(1.0 / window.getRefreshRate())) },
+	mutex{},
+	wakeCondition{},
+	pendingTree{},
+	pendingScrollX{ 0.0f },
+	pendingScrollY{ 0.0f },
+	isResizePending{ false },
+	isInputPending{ false },
+	isStopping{ false },
+	pendingTextures{},
+	contentWidth{ 0.0f },
+	contentHeight{ 0.0f },
+	targetScrollX{ 0.0f },
+	targetScrollY{ 0.0f },
+	currentScrollX{ 0.0f },
+	currentScrollY{ 0.0f },
+	layerProperties{ DEFAULT_LAYER_PROPERTIES },
+	animation{},
+	animationStart{},
+	previousTick{},
+	scrollX{ 0.0f },
+	scrollY{ 0.0f } {}
+
+Compositor::~Compositor() {
+	stop();
+}
+
+bool Compositor::start() {
+	if (thread.joinable()) {
+		spdlog::error("The compositor was already started");
+		return false;
+	}
+
+	isStopping = false;
+	previousTick = FramePacer::Clock::now();
+
+	try {
+		thread = std::thread(&Compositor::run, this);
+	} catch (const std::system_error& error) {
+		spdlog::error("Failed to start the compositor thread: {}", error.what());
+		return false;
+	}
+
+	return true;
+}
+
+void Compositor::stop() {
+	if (!thread.joinable()) {
+		return;
+	}
+
+	{
+		std::lock_guard lock(mutex);
+		isStopping = true;
+	}
+
+	wakeCondition.notify_one();
+	thread.join();
+
+	// The renderer belongs to this thread again, requests that came in after the last frame are handled here
+	createTextures(pendingTextures);
+}
+
+void Compositor::commit(LayerTree layerTree) {
+	{
+		std::lock_guard lock(mutex);
+		pendingTree = std::make_unique<LayerTree>(std::move(layerTree));
+	}
+
+	wakeCondition.notify_one();
+}
+
+void Compositor::scrollBy(const float deltaX, const float deltaY) {
+	{
+		std::lock_guard lock(mutex);
+		pendingScrollX += deltaX;
+		pendingScrollY += deltaY;
+	}
+
+	wakeCondition.notify_one();
+}
+
+void Compositor::resize() {
+	{
+		std::lock_guard lock(mutex);
+		isResizePending = true;
+	}
+
+	wakeCondition.notify_one();
+}
+
+void Compositor::notifyInput() {
+	{
+		std::lock_guard lock(mutex);
+		isInputPending = true;
+	}
+
+	wakeCondition.notify_one();
+}
+
+std::future<TextureId> Compositor::createTexture(const std::uint32_t width, const std::uint32_t height, std::vector<std::uint8_t> pixels, std::function<void()> onCreated) {
+	TextureRequest request{ width, height, std::move(pixels), std::move(onCreated), {} };
+	auto texture = request.texture.get_future();
+
+	if (!thread.joinable()) {
+		std::vector<TextureRequest> requests;
+		requests.push_back(std::move(request));
+		createTextures(requests);
+
+		return texture;
+	}
+
+	{
+		std::lock_guard lock(mutex);
+		pendingTextures.push_back(std::move(request));
+	}
+
+	wakeCondition.notify_one();
+	return texture;
+}
+
+float Compositor::getScrollX() const {
+	return scrollX;
+}
+
+float Compositor::getScrollY() const {
+	return scrollY;
+}
+
+void Compositor::run() {
+	core::profiling::setThreadName("Compositor");
+
+	std::optional<FramePacer::Clock::duration> waitTimeout;
+	auto isIdle = false;
+
+	while (true) {
+		std::unique_ptr<LayerTree> layerTree;
+		auto scrollDeltaX = 0.0f;
+		auto scrollDeltaY = 0.0f;
+		auto isResized = false;
+		auto hasInput = false;
+		std::vector<TextureRequest> textureRequests;
+
+		{
+			std::unique_lock lock(mutex);
+
+			if (waitTimeout.has_value()) {
+				wakeCondition.wait_for(lock, waitTimeout.value(), [this] { return hasPendingWork(); });
+			}
+
+			if (isStopping) {
+				return;
+			}
+
+			layerTree = std::move(pendingTree);
+			std::swap(scrollDeltaX, pendingScrollX);
+			std::swap(scrollDeltaY, pendingScrollY);
+			std::swap(isResized, isResizePending);
+			std::swap(hasInput, isInputPending);
+			std::swap(textureRequests, pendingTextures);
+		}
+
+		PLAIN_TRACE_SCOPE("Compositor::frame");
+
+		if (isResized) {
+			renderer.resize();
+		}
+
+		if (hasInput) {
+			renderer.notifyInput();
+		}
+
+		createTextures(textureRequests);
+
+		const auto now = FramePacer::Clock::now();
+
+		if (layerTree != nullptr) {
+			renderer.setDisplayList(std::move(layerTree->displayList));
+
+			contentWidth = layerTree->contentWidth;
+			contentHeight = layerTree->contentHeight;
+			layerProperties = layerTree->properties;
+			animation = layerTree->animation;
+			animationStart = now;
+		}
+
+		targetScrollX += scrollDeltaX;
+		targetScrollY += scrollDeltaY;
+
+		const auto isAnimating = animate(now);
+
+		if (renderer.needsRedraw()) {
+			// Mailbox presentation would render frames faster than the display shows them
+			std::this_thread::sleep_for(renderer.getTimeUntilNextFrame());
+			renderer.render();
+
+			waitTimeout.reset();
+			isIdle = false;
+		} else if (isAnimating) {
+			// The animation moved less than a pixel, try again once the display refreshes
+			waitTimeout = frameInterval;
+			isIdle = false;
+		} else {
+			// Nothing changed, a good moment to release memory blocks that are barely used
+			if (!isIdle) {
+				renderer.compactMemory();
+			}
+
+			waitTimeout = IDLE_WAIT_TIMEOUT;
+			isIdle = true;
+		}
+	}
+}
+
+void Compositor::createTextures(std::vector<TextureRequest>& requests) {
+	for (auto& request : requests) {
+		request.texture.set_value(renderer.createTexture(request.width, request.height, std::move(request.pixels)));
+
+		if (request.onCreated) {
+			request.onCreated();
+		}
+	}
+
+	requests.clear();
+}
+
+bool Compositor::hasPendingWork() const {
+	return isStopping || pendingTree != nullptr || pendingScrollX != 0.0f || pendingScrollY != 0.0f || isResizePending || isInputPending || !pendingTextures.empty();
+}
+
+bool Compositor::animate(const FramePacer::Clock::time_point now) {
+	// Capped at a single frame, so scrolling after a long idle period still eases in instead of jumping
+	const auto elapsed = std::chrono::duration<float>(std::min(now - previousTick, frameInterval));
+	previousTick = now;
+
+	const auto viewportWidth = static_cast<float>(window.getWidth());
+	const auto viewportHeight = static_cast<float>(window.getHeight());
+
+	// Content that changed size, or a larger window, may have moved the end of the page above the target
+	targetScrollX = std::clamp(targetScrollX, 0.0f, std::max(0.0f, contentWidth - viewportWidth));
+	targetScrollY = std::clamp(targetScrollY, 0.0f, std::max(0.0f, contentHeight - viewportHeight));
+
+	// Exponential smoothing covers the same share of the remaining distance in the same time, regardless of the frame rate
+	const auto blend = 1.0f - std::exp(-elapsed / SCROLL_SMOOTHING_TIME);
+	const auto previousScrollX = currentScrollX;
+	const auto previousScrollY = currentScrollY;
+
+	currentScrollX = std::abs(targetScrollX - currentScrollX) < SCROLL_SNAP_DISTANCE ? targetScrollX : glm::mix(currentScrollX, targetScrollX, blend);
+	currentScrollY = std::abs(targetScrollY - currentScrollY) < SCROLL_SNAP_DISTANCE ? targetScrollY : glm::mix(currentScrollY, targetScrollY, blend);
+
+	renderer.setScrollOffset(currentScrollX, currentScrollY);
+	scrollX = currentScrollX;
+	scrollY = currentScrollY;
+
+	// The page moved under the cursor, the main thread finds what it points at once scrolling comes to rest
+	const auto hasScrolled = currentScrollX != previousScrollX || currentScrollY != previousScrollY;
+
+	if (hasScrolled && currentScrollX == targetScrollX && currentScrollY == targetScrollY) {
+		window::Window::wake();
+	}
+
+	auto properties = layerProperties;
+	auto isAnimationRunning = false;
+
+	if (animation.has_value()) {
+		const auto duration = std::chrono::duration<float>(animation->duration);
+		const auto time = duration.count() > 0.0f ? std::min(std::chrono::duration<float>(now - animationStart) / duration, 1.0f) : 1.0f;
+
+		properties = mix(animation->from, animation->to, ease(animation->easing, time));
+		isAnimationRunning = time < 1.0f;
+
+		// The layer holds on to where the animation ended
+		if (!isAnimationRunning) {
+			layerProperties = properties;
+			animation.reset();
+		}
+	}
+
+	renderer.setPageLayer(createTransform(properties, viewportWidth, viewportHeight), properties.opacity);
+
+	return isAnimationRunning || currentScrollX != targetScrollX || currentScrollY != targetScrollY;
+}
@@ -0,0 +1,122 @@
+#include "graphics/renderer/damage_tracker.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+using namespace graphics::renderer;
+
+// Edits beyond which the lists are treated as entirely different, bounds the time and memory spent on diffing
+constexpr std::ptrdiff_t MAX_EDIT_DISTANCE = 128;
+
+// Returns whether two items paint exactly the same pixels
+static bool isSameItem(const DisplayList& lhsList, const DisplayItem& lhs, const DisplayList& rhsList, const DisplayItem& rhs) {
+	if (lhs.type != rhs.type || lhs.bounds != rhs.bounds || lhs.color != rhs.color) {
+		return false;
+	}
+
+	switch (lhs.type) {
+		case DisplayItemType::Rectangle:
+			return true;
+
+		case DisplayItemType::Border:
+			return lhs.borderWidth == rhs.borderWidth;
+
+		case DisplayItemType::Image:
+			return lhs.texture == rhs.texture;
+
+		case DisplayItemType::GlyphRun:
+			return lhs.font == rhs.font && lhs.pixelSize == rhs.pixelSize && lhs.baseline == rhs.baseline && lhsList.getText(lhs) == rhsList.getText(rhs);
+	}
+
+	return false;
+}
+
+void graphics::renderer::computeDamage(const DisplayList& previous, const DisplayList& next, std::vector<Rectangle>& damage) {
+	const auto previousItems = previous.getItems();
+	const auto nextItems = next.getItems();
+	const auto sharedCount = std::min(previousItems.size(), nextItems.size());
+
+	// Most updates touch a small part of the page, which leaves long runs of identical items at both ends
+	std::size_t prefix = 0;
+
+	while (prefix < sharedCount && isSameItem(previous, previousItems[prefix], next, nextItems[prefix])) {
+		++prefix;
+	}
+
+	std::size_t suffix = 0;
+
+	while (suffix < sharedCount - prefix && isSameItem(previous, previousItems[previousItems.size() - 1 - suffix], next, nextItems[nextItems.size() - 1 - suffix])) {
+		++suffix;
+	}
+
+	const auto removedItems = previousItems.subspan(prefix, previousItems.size() - suffix - prefix);
+	const auto addedItems = nextItems.subspan(prefix, nextItems.size() - suffix - prefix);
+
+	// Edits far apart leave identical items in between, which are found with Myers' shortest edit script
+	// Items that keep their relative order paint the same pixels, so only the ones outside the longest common subsequence are damaged
+	const auto removedCount = static_cast<std::ptrdiff_t>(removedItems.size());
+	const auto addedCount = static_cast<std::ptrdiff_t>(addedItems.size());
+	const auto maxDistance = std::min(removedCount + addedCount, MAX_EDIT_DISTANCE);
+
+	// Furthest position in "removedItems" reached on every diagonal "k = x - y", offset so negative diagonals can be indexed
+	std::vector<std::ptrdiff_t> furthest(static_cast<std::size_t>(2 * maxDistance + 3), 0);
+	std::vector<std::vector<std::ptrdiff_t>> trace;
+
+	const auto at = [maxDistance](std::vector<std::ptrdiff_t>& diagonals, const std::ptrdiff_t k) -> std::ptrdiff_t& {
+		return diagonals[static_cast<std::size_t>(k + maxDistance + 1)];
+	};
+
+	// A path of "distance" edits moves down (an added item) from the neighbor that reached further, or right (a removed item) otherwise
+	const auto isDownward = [&at](std::vector<std::ptrdiff_t>& diagonals, const std::ptrdiff_t k, const std::ptrdiff_t distance) {
+		return k == -distance || (k != distance && at(diagonals, k - 1) < at(diagonals, k + 1));
+	};
+
+	for (std::ptrdiff_t distance = 0; distance <= maxDistance; ++distance) {
+		trace.push_back(furthest);
+
+		for (auto k = -distance; k <= distance; k += 2) {
+			auto x = isDownward(furthest, k, distance) ? at(furthest, k + 1) : at(furthest, k - 1) + 1;
+			auto y = x - k;
+
+			while (x < removedCount && y < addedCount && isSameItem(previous, removedItems[static_cast<std::size_t>(x)], next, addedItems[static_cast<std::size_t>(y)])) {
+				++x;
+				++y;
+			}
+
+			at(furthest, k) = x;
+
+			if (x < removedCount || y < addedCount) {
+				continue;
+			}
+
+			// Walk the edit script back from the end, every step off the diagonals is an item that was removed or added
+			for (auto step = distance; step > 0; --step) {
+				auto& diagonals = trace[static_cast<std::size_t>(step)];
+				const auto stepK = x - y;
+				const auto previousK = isDownward(diagonals, stepK, step) ? stepK + 1 : stepK - 1;
+				const auto previousX = at(diagonals, previousK);
+				const auto previousY = previousX - previousK;
+
+				if (previousK == stepK + 1) {
+					damage.push_back(getPaintBounds(addedItems[static_cast<std::size_t>(previousY)]));
+				} else {
+					damage.push_back(getPaintBounds(removedItems[static_cast<std::size_t>(previousX)]));
+				}
+
+				x = previousX;
+				y = previousY;
+			}
+
+			return;
+		}
+	}
+
+	// The lists differ too much for matching items to be worth it, whatever the old items covered has to be repainted, as does everything the new items cover
+	for (const auto& item : removedItems) {
+		damage.push_back(getPaintBounds(item));
+	}
+
+	for (const auto& item : addedItems) {
+		damage.push_back(getPaintBounds(item));
+	}
+}
@@ -0,0 +1,73 @@
+#include "graphics/renderer/display_list.hpp"
+
+using namespace graphics::renderer;
+
+Rectangle graphics::renderer::getPaintBounds(const DisplayItem& item) {
+	if (item.type != DisplayItemType::GlyphRun) {
+		return item.bounds;
+	}
+
+	// Accents, italics, and the difference between measured and shaped widths can all push ink past the line box
+	const auto overhang = static_cast<float>(item.pixelSize);
+	return { item.bounds.x - overhang, item.bounds.y - overhang, item.bounds.width + overhang * 2.0f, item.bounds.height + overhang * 2.0f };
+}
+
+void DisplayList::pushRectangle(const Rectangle& bounds, const std::uint32_t color) {
+	DisplayItem item{};
+	item.type = DisplayItemType::Rectangle;
+	item.bounds = bounds;
+	item.color = color;
+	item.texture = NO_TEXTURE;
+
+	items.push_back(item);
+}
+
+void DisplayList::pushBorder(const Rectangle& bounds, const float width, const std::uint32_t color) {
+	DisplayItem item{};
+	item.type = DisplayItemType::Border;
+	item.bounds = bounds;
+	item.color = color;
+	item.borderWidth = width;
+	item.texture = NO_TEXTURE;
+
+	items.push_back(item);
+}
+
+void DisplayList::pushImage(const Rectangle& bounds, const TextureId texture) {
+	DisplayItem item{};
+	item.type = DisplayItemType::Image;
+	item.bounds = bounds;
+	item.color = 0xFFFFFFFF;
+	item.texture = texture;
+
+	items.push_back(item);
+}
+
+void DisplayList::pushGlyphRun(const Rectangle& bounds, const float baseline, const text::FontId font, const std::uint32_t pixelSize, const std::string_view& glyphText, const std::uint32_t color) {
+	DisplayItem item{};
+	item.type = DisplayItemType::GlyphRun;
+	item.bounds = bounds;
+	item.color = color;
+	item.texture = NO_TEXTURE;
+	item.font = font;
+	item.pixelSize = pixelSize;
+	item.baseline = baseline;
+	item.textOffset = static_cast<std::uint32_t>(text.size());
+	item.textLength = static_cast<std::uint32_t>(glyphText.size());
+
+	text += glyphText;
+	items.push_back(item);
+}
+
+void DisplayList::clear() {
+	items.clear();
+	text.clear();
+}
+
+std::span<const DisplayItem> DisplayList::getItems() const {
+	return items;
+}
+
+std::string_view DisplayList::getText(const DisplayItem& item) const {
+	return std::string_view(text).substr(item.textOffset, item.textLength);
+}
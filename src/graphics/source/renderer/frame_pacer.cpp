@@ -0,0 +1,139 @@
+#include "graphics/renderer/frame_pacer.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+
+using namespace graphics::renderer;
+
+// How long after the last input frames still favor latency in adaptive mode
+// Long enough that short pauses while scrolling or typing do not recreate the swapchain back and forth
+constexpr std::chrono::seconds ADAPTIVE_INTERACTION_WINDOW{ 2 };
+
+// Weight of a new sample in the moving averages
+constexpr double STATISTICS_SMOOTHING = 0.1;
+
+// How often the statistics are logged while frames are being presented
+constexpr std::chrono::seconds STATISTICS_LOG_INTERVAL{ 5 };
+
+static double toMilliseconds(const FramePacer::Clock::duration duration) {
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static void addSample(double& average, const double sample) {
+	// The first sample is taken as is, so the average does not start out at zero
+	average = average == 0.0 ? sample : average + (sample - average) * STATISTICS_SMOOTHING;
+}
+
+FramePacer::FramePacer(const PacingPolicy policy, const std::uint32_t framesInFlight) :
+	policy(policy),
+	refreshInterval{ 0 },
+	presentModes{},
+	frameStart{},
+	previousPresent{},
+	lastInput{},
+	pendingInput{},
+	submissionTimes(framesInFlight),
+	statistics{},
+	lastStatisticsLog{ Clock::now() } {}
+
+void FramePacer::setPolicy(const PacingPolicy newPolicy) {
+	policy = newPolicy;
+}
+
+PacingPolicy FramePacer::getPolicy() const {
+	return policy;
+}
+
+void FramePacer::setRefreshRate(const std::uint32_t hertz) {
+	refreshInterval = hertz > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hertz)) : Clock::duration{ 0 };
+}
+
+VkPresentModeKHR FramePacer::choosePresentMode(const std::vector<VkPresentModeKHR>& availableModes) {
+	presentModes = availableModes;
+	return getPreferredPresentMode();
+}
+
+bool FramePacer::shouldChangePresentMode(const VkPresentModeKHR currentMode) const {
+	return !presentModes.empty() && getPreferredPresentMode() != currentMode;
+}
+
+void FramePacer::notifyInput() {
+	lastInput = Clock::now();
+
+	if (!pendingInput.has_value()) {
+		pendingInput = lastInput;
+	}
+}
+
+void FramePacer::retireFrame(const std::uint32_t frameSlot, const bool hasWaited) {
+	auto& submissionTime = submissionTimes[frameSlot];
+
+	// A fence that was already signaled only tells the GPU finished some time ago, which says nothing about its frame time
+	if (submissionTime.has_value() && hasWaited) {
+		addSample(statistics.gpuTime, toMilliseconds(Clock::now() - submissionTime.value()));
+	}
+
+	submissionTime.reset();
+}
+
+void FramePacer::beginFrame() {
+	frameStart = Clock::now();
+}
+
+void FramePacer::cancelFrame() {
+	frameStart.reset();
+}
+
+void FramePacer::endFrame(const std::uint32_t frameSlot) {
+	const auto now = Clock::now();
+
+	addSample(statistics.cpuTime, toMilliseconds(now - frameStart.value_or(now)));
+	submissionTimes[frameSlot] = now;
+}
+
+void FramePacer::present() {
+	const auto now = Clock::now();
+
+	if (previousPresent.has_value()) {
+		addSample(statistics.frameInterval, toMilliseconds(now - previousPresent.value()));
+	}
+
+	if (pendingInput.has_value()) {
+		addSample(statistics.inputLatency, toMilliseconds(now - pendingInput.value()));
+		pendingInput.reset();
+	}
+
+	previousPresent = now;
+
+	if (now - lastStatisticsLog >= STATISTICS_LOG_INTERVAL) {
+		spdlog::debug("Frame times: CPU {:.2f}ms, GPU {:.2f}ms, input latency {:.2f}ms, interval {:.2f}ms", statistics.cpuTime, statistics.gpuTime, statistics.inputLatency, statistics.frameInterval);
+		lastStatisticsLog = now;
+	}
+}
+
+FramePacer::Clock::duration FramePacer::getTimeUntilNextFrame() const {
+	// FIFO presentation already blocks on the display, mailbox would otherwise render frames that are never shown
+	if (getPreferredPresentMode() != VK_PRESENT_MODE_MAILBOX_KHR || refreshInterval == Clock::duration{ 0 } || !frameStart.has_value()) {
+		return Clock::duration{ 0 };
+	}
+
+	const auto nextFrameStart = frameStart.value() + refreshInterval;
+	return std::max(nextFrameStart - Clock::now(), Clock::duration{ 0 });
+}
+
+FrameStatistics FramePacer::getStatistics() const {
+	return statistics;
+}
+
+bool FramePacer::isInteractive() const {
+	return lastInput.has_value() && Clock::now() - lastInput.value() < ADAPTIVE_INTERACTION_WINDOW;
+}
+
+VkPresentModeKHR FramePacer::getPreferredPresentMode() const {
+	const auto prefersMailbox = policy == PacingPolicy::LowLatency || (policy == PacingPolicy::Adaptive && isInteractive());
+	const auto hasMailbox = std::find(presentModes.begin(), presentModes.end(), VK_PRESENT_MODE_MAILBOX_KHR) != presentModes.end();
+
+	// FIFO is always available as per the Vulkan specification
+	return prefersMailbox && hasMailbox ? VK_PRESENT_MODE_MAILBOX_KHR : VK_PRESENT_MODE_FIFO_KHR;
+}
@@ -0,0 +1,184 @@
+#include "graphics/renderer/gpu_profiler.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace graphics::renderer;
+
+// Upper limit of passes measured per frame, passes beyond it are not measured
+constexpr std::uint32_t MAX_PASS_COUNT = 32;
+
+// One timestamp before and one after the commands of a pass
+constexpr std::uint32_t QUERIES_PER_PASS = 2;
+
+// Marks an open pass that did not fit the query pool
+constexpr std::size_t UNMEASURED_PASS = std::numeric_limits<std::size_t>::max();
+
+// Weight of a new sample in the moving averages
+constexpr double TIMING_SMOOTHING = 0.1;
+
+// How often the timings are logged while frames are being rendered
+constexpr std::chrono::seconds TIMING_LOG_INTERVAL{ 5 };
+
+GpuProfiler::GpuProfiler(const VkDevice& device) :
+	device(device),
+	frames{},
+	currentFrame{ 0 },
+	openPasses{},
+	results{},
+	timings{},
+	timestampPeriod{ 1.0 },
+	timestampMask{ 0 },
+	lastLog{ std::chrono::steady_clock::now() } {}
+
+bool GpuProfiler::create(const VkPhysicalDevice& physicalDevice, const std::uint32_t queueFamily, const std::uint32_t framesInFlight) {
+	std::uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+	if (queueFamily >= queueFamilyCount) {
+		spdlog::error("Unable to profile queue family {}, the device has {} queue families", queueFamily, queueFamilyCount);
+		return false;
+	}
+
+	const auto validBits = queueFamilies[queueFamily].timestampValidBits;
+
+	if (validBits == 0) {
+		spdlog::warn("The graphics queue cannot write timestamps, GPU profiling is disabled");
+		return true;
+	}
+
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	timestampPeriod = static_cast<double>(properties.limits.timestampPeriod);
+	timestampMask = validBits >= 64 ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t{ 1 } << validBits) - 1;
+
+	VkQueryPoolCreateInfo queryPoolCreateInfo{};
+	queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	queryPoolCreateInfo.queryCount = MAX_PASS_COUNT * QUERIES_PER_PASS;
+
+	frames.resize(framesInFlight);
+
+	for (auto& frame : frames) {
+		if (vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &frame.queryPool) != VK_SUCCESS) {
+			spdlog::error("Failed to create timestamp query pool");
+			return false;
+		}
+	}
+
+	results.resize(MAX_PASS_COUNT * QUERIES_PER_PASS);
+
+	spdlog::debug("GPU profiler created ({:.2f}ns per tick, {} valid bits)", timestampPeriod, validBits);
+	return true;
+}
+
+void GpuProfiler::beginFrame(const VkCommandBuffer& commandBuffer, const std::uint32_t frameSlot) {
+	if (!isEnabled()) {
+		return;
+	}
+
+	currentFrame = frameSlot;
+
+	auto& frame = frames[currentFrame];
+	collect(frame);
+
+	frame.passes.clear();
+	openPasses.clear();
+
+	vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, MAX_PASS_COUNT * QUERIES_PER_PASS);
+}
+
+void GpuProfiler::beginPass(const VkCommandBuffer& commandBuffer, const std::string_view& name) {
+	if (!isEnabled()) {
+		return;
+	}
+
+	auto& frame = frames[currentFrame];
+
+	if (frame.passes.size() == MAX_PASS_COUNT) {
+		openPasses.push_back(UNMEASURED_PASS);
+		return;
+	}
+
+	const auto pass = frame.passes.size();
+	frame.passes.push_back(name);
+	openPasses.push_back(pass);
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, static_cast<std::uint32_t>(pass * QUERIES_PER_PASS));
+}
+
+void GpuProfiler::endPass(const VkCommandBuffer& commandBuffer) {
+	if (!isEnabled() || openPasses.empty()) {
+		return;
+	}
+
+	const auto pass = openPasses.back();
+	openPasses.pop_back();
+
+	if (pass == UNMEASURED_PASS) {
+		return;
+	}
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frames[currentFrame].queryPool, static_cast<std::uint32_t>(pass * QUERIES_PER_PASS + 1));
+}
+
+std::span<const PassTiming> GpuProfiler::getTimings() const {
+	return timings;
+}
+
+bool GpuProfiler::isEnabled() const {
+	return !frames.empty();
+}
+
+void GpuProfiler::destroy() {
+	for (const auto& frame : frames) {
+		vkDestroyQueryPool(device, frame.queryPool, nullptr);
+	}
+
+	frames.clear();
+	timings.clear();
+}
+
+void GpuProfiler::collect(FrameQueries& frame) {
+	if (frame.passes.empty()) {
+		return;
+	}
+
+	const auto queryCount = static_cast<std::uint32_t>(frame.passes.size() * QUERIES_PER_PASS);
+
+	// Without the wait flag this never blocks, the frame is skipped when any of its results is not available
+	if (vkGetQueryPoolResults(device, frame.queryPool, 0, queryCount, queryCount * sizeof(std::uint64_t), results.data(), sizeof(std::uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+		return;
+	}
+
+	for (std::size_t i = 0; i < frame.passes.size(); ++i) {
+		const auto ticks = (results[i * QUERIES_PER_PASS + 1] - results[i * QUERIES_PER_PASS]) & timestampMask;
+		const auto milliseconds = static_cast<double>(ticks) * timestampPeriod / 1'000'000.0;
+
+		const auto timing = std::find_if(timings.begin(), timings.end(), [&frame, i](const PassTiming& candidate) {
+			return candidate.name == frame.passes[i];
+		});
+
+		if (timing == timings.end()) {
+			timings.push_back({ frame.passes[i], milliseconds });
+		} else {
+			timing->milliseconds += (milliseconds - timing->milliseconds) * TIMING_SMOOTHING;
+		}
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+
+	if (now - lastLog >= TIMING_LOG_INTERVAL) {
+		for (const auto& timing : timings) {
+			spdlog::debug("GPU {}: {:.3f}ms", timing.name, timing.milliseconds);
+		}
+
+		lastLog = now;
+	}
+}
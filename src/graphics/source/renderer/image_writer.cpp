@@ -0,0 +1,156 @@
+#include "graphics/renderer/image_writer.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace graphics::renderer;
+
+// Largest payload of a single uncompressed deflate block
+constexpr std::size_t MAX_STORED_BLOCK_SIZE = 65'535;
+
+// Lookup table of the CRC-32 used by PNG chunks
+static const std::array<std::uint32_t, 256> CRC_TABLE = [] {
+	std::array<std::uint32_t, 256> table{};
+
+	for (std::uint32_t i = 0; i < table.size(); ++i) {
+		auto value = i;
+
+		for (auto bit = 0; bit < 8; ++bit) {
+			value = (value & 1) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+		}
+
+		table[i] = value;
+	}
+
+	return table;
+}();
+
+static void appendBigEndian(std::vector<std::uint8_t>& destination, const std::uint32_t value) {
+	destination.push_back(static_cast<std::uint8_t>(value >> 24));
+	destination.push_back(static_cast<std::uint8_t>(value >> 16));
+	destination.push_back(static_cast<std::uint8_t>(value >> 8));
+	destination.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Append a chunk with its length, type, data, and checksum
+static void appendChunk(std::vector<std::uint8_t>& destination, const char (&type)[5], const std::vector<std::uint8_t>& data) {
+	appendBigEndian(destination, static_cast<std::uint32_t>(data.size()));
+
+	const auto checksumStart = destination.size();
+	destination.insert(destination.end(), type, type + 4);
+	destination.insert(destination.end(), data.begin(), data.end());
+
+	auto crc = 0xFFFFFFFFu;
+
+	for (auto i = checksumStart; i < destination.size(); ++i) {
+		crc = CRC_TABLE[(crc ^ destination[i]) & 0xFF] ^ (crc >> 8);
+	}
+
+	appendBigEndian(destination, crc ^ 0xFFFFFFFFu);
+}
+
+static bool writePng(std::ofstream& file, const std::uint32_t width, const std::uint32_t height, const std::span<const std::uint8_t> pixels) {
+	const auto rowSize = static_cast<std::size_t>(width) * 4;
+
+	// Every scanline starts with its filter type, zero means the row is stored as is
+	std::vector<std::uint8_t> scanlines;
+	scanlines.reserve((rowSize + 1) * height);
+
+	for (std::uint32_t row = 0; row < height; ++row) {
+		scanlines.push_back(0);
+		scanlines.insert(scanlines.end(), pixels.begin() + row * rowSize, pixels.begin() + (row + 1) * rowSize);
+	}
+
+	// A zlib stream made of stored (uncompressed) deflate blocks
+	std::vector<std::uint8_t> imageData = { 0x78, 0x01 };
+	std::uint32_t adlerA = 1;
+	std::uint32_t adlerB = 0;
+
+	for (std::size_t offset = 0; offset < scanlines.size() || offset == 0; offset += MAX_STORED_BLOCK_SIZE) {
+		const auto blockSize = std::min(MAX_STORED_BLOCK_SIZE, scanlines.size() - offset);
+		const auto isFinalBlock = offset + blockSize >= scanlines.size();
+
+		imageData.push_back(isFinalBlock ? 1 : 0);
+		imageData.push_back(static_cast<std::uint8_t>(blockSize));
+		imageData.push_back(static_cast<std::uint8_t>(blockSize >> 8));
+		imageData.push_back(static_cast<std::uint8_t>(~blockSize));
+		imageData.push_back(static_cast<std::uint8_t>(~blockSize >> 8));
+		imageData.insert(imageData.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+
+		for (auto i = offset; i < offset + blockSize; ++i) {
+			adlerA = (adlerA + scanlines[i]) % 65'521;
+			adlerB = (adlerB + adlerA) % 65'521;
+		}
+
+		if (isFinalBlock) {
+			break;
+		}
+	}
+
+	appendBigEndian(imageData, adlerB << 16 | adlerA);
+
+	// 8 bits per channel, truecolor with alpha, no interlacing
+	std::vector<std::uint8_t> header;
+	appendBigEndian(header, width);
+	appendBigEndian(header, height);
+	header.insert(header.end(), { 8, 6, 0, 0, 0 });
+
+	std::vector<std::uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	appendChunk(png, "IHDR", header);
+	appendChunk(png, "IDAT", imageData);
+	appendChunk(png, "IEND", {});
+
+	file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+	return file.good();
+}
+
+static bool writePpm(std::ofstream& file, const std::uint32_t width, const std::uint32_t height, const std::span<const std::uint8_t> pixels) {
+	file << "P6\n" << width << ' ' << height << "\n255\n";
+
+	// PPM has no alpha channel
+	std::vector<std::uint8_t> rgb;
+	rgb.reserve(static_cast<std::size_t>(width) * height * 3);
+
+	for (std::size_t i = 0; i < pixels.size(); i += 4) {
+		rgb.insert(rgb.end(), { pixels[i], pixels[i + 1], pixels[i + 2] });
+	}
+
+	file.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+	return file.good();
+}
+
+bool graphics::renderer::writeImage(const std::string_view& path, const std::uint32_t width, const std::uint32_t height, const std::span<const std::uint8_t> pixels) {
+	if (pixels.size() != static_cast<std::size_t>(width) * height * 4) {
+		spdlog::error("Unable to write image \"{}\", the pixel data does not match its dimensions", path);
+		return false;
+	}
+
+	const auto extension = std::filesystem::path(path).extension().string();
+
+	if (extension != ".png" && extension != ".ppm") {
+		spdlog::error("Unable to write image \"{}\", only PNG and PPM files are supported", path);
+		return false;
+	}
+
+	std::ofstream file(std::string(path), std::ios::binary);
+
+	if (!file.is_open()) {
+		spdlog::error("Unable to open \"{}\" for writing", path);
+		return false;
+	}
+
+	const auto isWritten = extension == ".png" ? writePng(file, width, height, pixels) : writePpm(file, width, height, pixels);
+
+	if (!isWritten) {
+		spdlog::error("Failed to write image \"{}\"", path);
+		return false;
+	}
+
+	spdlog::debug("Image written to \"{}\" ({}x{})", path, width, height);
+	return true;
+}
@@ -0,0 +1,376 @@
+#include "graphics/renderer/memory_allocator.hpp"
+#include "graphics/renderer/memory_utility.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace graphics::renderer;
+
+// Size of the blocks ranges are sub-allocated from, smaller heaps use an eighth of their size instead
+constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+// Requests larger than this fraction of a block get a block of their own, so they cannot fragment the pool
+constexpr VkDeviceSize DEDICATED_BLOCK_DIVISOR = 2;
+
+// Blocks that use less than this fraction of their size are candidates for defragmentation
+constexpr VkDeviceSize SPARSE_BLOCK_DIVISOR = 4;
+
+static VkDeviceSize alignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+MemoryAllocator::MemoryAllocator(const VkDevice& device) :
+	device(device),
+	memoryProperties{},
+	pools{},
+	mutex{} {}
+
+bool MemoryAllocator::initialize(const VkPhysicalDevice& physicalDevice) {
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	for (std::uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+		const auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+		const auto blockSize = std::min(DEFAULT_BLOCK_SIZE, heapSize / 8);
+
+		pools.push_back({ i, ResourceKind::Buffer, blockSize, {} });
+		pools.push_back({ i, ResourceKind::Image, blockSize, {} });
+	}
+
+	return true;
+}
+
+std::optional<Allocation> MemoryAllocator::allocate(const VkMemoryRequirements& requirements, const VkMemoryPropertyFlags properties, const ResourceKind kind) {
+	const auto memoryType = findMemoryType(memoryProperties, requirements.memoryTypeBits, properties);
+
+	if (!memoryType.has_value()) {
+		spdlog::error("No suitable memory type found for an allocation of {} bytes", requirements.size);
+		return std::nullopt;
+	}
+
+	const auto poolIndex = memoryType.value() * 2 + static_cast<std::uint32_t>(kind);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto& pool = pools[poolIndex];
+
+	const auto alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+	// Large resources are not worth sharing a block with
+	if (requirements.size > pool.blockSize / DEDICATED_BLOCK_DIVISOR) {
+		const auto blockIndex = createBlock(pool, requirements.size, true);
+
+		if (!blockIndex.has_value()) {
+			return std::nullopt;
+		}
+
+		auto& block = pool.blocks[blockIndex.value()];
+		const auto offset = allocateFromBlock(block, requirements.size, alignment);
+
+		return Allocation{ block.memory, offset.value(), requirements.size, block.mappedData, poolIndex, blockIndex.value() };
+	}
+
+	// Prefer the fullest block that still has room, so sparsely used blocks get a chance to become empty
+	std::vector<std::uint32_t> candidates{};
+
+	for (std::uint32_t i = 0; i < pool.blocks.size(); ++i) {
+		const auto& block = pool.blocks[i];
+
+		if (block.memory != VK_NULL_HANDLE && !block.isDedicated && block.size - block.usedBytes >= requirements.size) {
+			candidates.push_back(i);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [&pool](const std::uint32_t a, const std::uint32_t b) {
+		return pool.blocks[a].usedBytes > pool.blocks[b].usedBytes;
+	});
+
+	for (const auto blockIndex : candidates) {
+		auto& block = pool.blocks[blockIndex];
+		const auto offset = allocateFromBlock(block, requirements.size, alignment);
+
+		if (offset.has_value()) {
+			return Allocation{ block.memory, offset.value(), requirements.size, block.mappedData == nullptr ? nullptr : block.mappedData + offset.value(), poolIndex, blockIndex };
+		}
+	}
+
+	const auto blockIndex = createBlock(pool, pool.blockSize, false);
+
+	if (!blockIndex.has_value()) {
+		return std::nullopt;
+	}
+
+	auto& block = pool.blocks[blockIndex.value()];
+	const auto offset = allocateFromBlock(block, requirements.size, alignment);
+
+	return Allocation{ block.memory, offset.value(), requirements.size, block.mappedData == nullptr ? nullptr : block.mappedData + offset.value(), poolIndex, blockIndex.value() };
+}
+
+std::optional<Allocation> MemoryAllocator::allocateBuffer(const VkBuffer& buffer, const VkMemoryPropertyFlags properties) {
+	VkMemoryRequirements requirements{};
+	vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+	auto allocation = allocate(requirements, properties, ResourceKind::Buffer);
+
+	if (allocation.has_value() && vkBindBufferMemory(device, buffer, allocation->memory, allocation->offset) != VK_SUCCESS) {
+		spdlog::error("Failed to bind buffer memory");
+		free(allocation.value());
+		return std::nullopt;
+	}
+
+	return allocation;
+}
+
+std::optional<Allocation> MemoryAllocator::allocateImage(const VkImage& image, const VkMemoryPropertyFlags properties) {
+	VkMemoryRequirements requirements{};
+	vkGetImageMemoryRequirements(device, image, &requirements);
+
+	auto allocation = allocate(requirements, properties, ResourceKind::Image);
+
+	if (allocation.has_value() && vkBindImageMemory(device, image, allocation->memory, allocation->offset) != VK_SUCCESS) {
+		spdlog::error("Failed to bind image memory");
+		free(allocation.value());
+		return std::nullopt;
+	}
+
+	return allocation;
+}
+
+void MemoryAllocator::free(Allocation& allocation) {
+	if (allocation.memory == VK_NULL_HANDLE) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto& pool = pools[allocation.poolIndex];
+	auto& block = pool.blocks[allocation.blockIndex];
+
+	// Insert the range in offset order and merge it with its neighbours
+	auto& freeRanges = block.freeRanges;
+	auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), allocation.offset, [](const FreeRange& range, const VkDeviceSize offset) {
+		return range.offset < offset;
+	});
+
+	next = freeRanges.insert(next, { allocation.offset, allocation.size });
+
+	if (next + 1 != freeRanges.end() && next->offset + next->size == (next + 1)->offset) {
+		next->size += (next + 1)->size;
+		freeRanges.erase(next + 1);
+	}
+
+	if (next != freeRanges.begin() && (next - 1)->offset + (next - 1)->size == next->offset) {
+		(next - 1)->size += next->size;
+		freeRanges.erase(next);
+	}
+
+	block.usedBytes -= allocation.size;
+	--block.allocationCount;
+	allocation = {};
+
+	if (block.allocationCount > 0) {
+		return;
+	}
+
+	// Keep a single empty block around, so allocating and freeing in a loop does not hit the driver every time
+	const auto hasOtherEmptyBlock = std::any_of(pool.blocks.begin(), pool.blocks.end(), [&block](const Block& other) {
+		return &other != &block && other.memory != VK_NULL_HANDLE && !other.isDedicated && other.allocationCount == 0;
+	});
+
+	if (block.isDedicated || hasOtherEmptyBlock) {
+		vkFreeMemory(device, block.memory, nullptr);
+		block = {};
+	}
+}
+
+bool MemoryAllocator::shouldRelocate(const Allocation& allocation) const {
+	if (allocation.memory == VK_NULL_HANDLE) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto& pool = pools[allocation.poolIndex];
+	const auto& block = pool.blocks[allocation.blockIndex];
+
+	if (!isSparse(pool, block)) {
+		return false;
+	}
+
+	// Only worth it when the other blocks can absorb everything that lives in this one
+	VkDeviceSize availableBytes = 0;
+
+	for (const auto& other : pool.blocks) {
+		if (&other != &block && other.memory != VK_NULL_HANDLE && !other.isDedicated) {
+			availableBytes += other.size - other.usedBytes;
+		}
+	}
+
+	return availableBytes >= block.usedBytes;
+}
+
+bool MemoryAllocator::isFragmented() const {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (const auto& pool : pools) {
+		// A single block cannot be drained into another one
+		const auto blockCount = std::count_if(pool.blocks.begin(), pool.blocks.end(), [](const Block& block) {
+			return block.memory != VK_NULL_HANDLE && !block.isDedicated && block.allocationCount > 0;
+		});
+
+		if (blockCount > 1 && std::any_of(pool.blocks.begin(), pool.blocks.end(), [this, &pool](const Block& block) { return isSparse(pool, block); })) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+MemoryStatistics MemoryAllocator::getStatistics() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	MemoryStatistics statistics{};
+
+	for (const auto& pool : pools) {
+		for (const auto& block : pool.blocks) {
+			if (block.memory == VK_NULL_HANDLE) {
+				continue;
+			}
+
+			++statistics.blockCount;
+			statistics.dedicatedBlockCount += block.isDedicated ? 1 : 0;
+			statistics.allocationCount += block.allocationCount;
+			statistics.reservedBytes += block.size;
+			statistics.usedBytes += block.usedBytes;
+		}
+	}
+
+	return statistics;
+}
+
+void MemoryAllocator::logStatistics() const {
+	constexpr double mebibyte = 1024.0 * 1024.0;
+
+	const auto statistics = getStatistics();
+	spdlog::debug("GPU memory: {} allocations in {} blocks ({} dedicated), {:.1f} of {:.1f} MiB used", statistics.allocationCount, statistics.blockCount, statistics.dedicatedBlockCount, statistics.usedBytes / mebibyte, statistics.reservedBytes / mebibyte);
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (const auto& pool : pools) {
+		std::uint32_t blockCount = 0;
+		VkDeviceSize reservedBytes = 0;
+		VkDeviceSize usedBytes = 0;
+		VkDeviceSize largestFreeRange = 0;
+
+		for (const auto& block : pool.blocks) {
+			if (block.memory == VK_NULL_HANDLE) {
+				continue;
+			}
+
+			++blockCount;
+			reservedBytes += block.size;
+			usedBytes += block.usedBytes;
+
+			for (const auto& range : block.freeRanges) {
+				largestFreeRange = std::max(largestFreeRange, range.size);
+			}
+		}
+
+		if (blockCount > 0) {
+			spdlog::debug("  memory type {} ({}s): {} blocks, {:.1f} of {:.1f} MiB used, largest free range {:.1f} MiB", pool.memoryType, pool.kind == ResourceKind::Buffer ? "buffer" : "image", blockCount, usedBytes / mebibyte, reservedBytes / mebibyte, largestFreeRange / mebibyte);
+		}
+	}
+}
+
+void MemoryAllocator::destroy() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (auto& pool : pools) {
+		for (auto& block : pool.blocks) {
+			if (block.allocationCount > 0) {
+				spdlog::warn("Releasing a memory block that still holds {} allocation{}", block.allocationCount, block.allocationCount != 1 ? "s" : "");
+			}
+
+			// Freeing memory implicitly unmaps it
+			vkFreeMemory(device, block.memory, nullptr);
+		}
+	}
+
+	pools.clear();
+}
+
+std::optional<std::uint32_t> MemoryAllocator::createBlock(Pool& pool, const VkDeviceSize size, const bool isDedicated) {
+	VkMemoryAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = size;
+	allocateInfo.memoryTypeIndex = pool.memoryType;
+
+	Block block{};
+	block.size = size;
+	block.freeRanges.push_back({ 0, size });
+	block.isDedicated = isDedicated;
+
+	if (vkAllocateMemory(device, &allocateInfo, nullptr, &block.memory) != VK_SUCCESS) {
+		spdlog::error("Failed to allocate a memory block of {} bytes", size);
+		return std::nullopt;
+	}
+
+	// Host visible blocks stay mapped for their entire lifetime
+	if ((memoryProperties.memoryTypes[pool.memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0
+		&& vkMapMemory(device, block.memory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&block.mappedData)) != VK_SUCCESS) {
+		spdlog::error("Failed to map a memory block");
+		vkFreeMemory(device, block.memory, nullptr);
+		return std::nullopt;
+	}
+
+	// Reuse the slot of a released block, so the indices of existing allocations stay valid
+	const auto slot = std::find_if(pool.blocks.begin(), pool.blocks.end(), [](const Block& existing) { return existing.memory == VK_NULL_HANDLE; });
+
+	if (slot != pool.blocks.end()) {
+		*slot = std::move(block);
+		return static_cast<std::uint32_t>(std::distance(pool.blocks.begin(), slot));
+	}
+
+	pool.blocks.push_back(std::move(block));
+	return static_cast<std::uint32_t>(pool.blocks.size() - 1);
+}
+
+std::optional<VkDeviceSize> MemoryAllocator::allocateFromBlock(Block& block, const VkDeviceSize size, const VkDeviceSize alignment) {
+	// Best fit, the smallest range that can hold the aligned allocation
+	auto bestRange = block.freeRanges.end();
+	auto bestSize = std::numeric_limits<VkDeviceSize>::max();
+
+	for (auto range = block.freeRanges.begin(); range != block.freeRanges.end(); ++range) {
+		const auto alignedOffset = alignUp(range->offset, alignment);
+
+		if (alignedOffset + size <= range->offset + range->size && range->size < bestSize) {
+			bestRange = range;
+			bestSize = range->size;
+		}
+	}
+
+	if (bestRange == block.freeRanges.end()) {
+		return std::nullopt;
+	}
+
+	// Split the range into the padding in front of the allocation and the remainder behind it
+	const auto alignedOffset = alignUp(bestRange->offset, alignment);
+	const FreeRange padding{ bestRange->offset, alignedOffset - bestRange->offset };
+	const FreeRange remainder{ alignedOffset + size, bestRange->offset + bestRange->size - alignedOffset - size };
+
+	bestRange = block.freeRanges.erase(bestRange);
+
+	if (remainder.size > 0) {
+		bestRange = block.freeRanges.insert(bestRange, remainder);
+	}
+
+	if (padding.size > 0) {
+		block.freeRanges.insert(bestRange, padding);
+	}
+
+	block.usedBytes += size;
+	++block.allocationCount;
+
+	return alignedOffset;
+}
+
+bool MemoryAllocator::isSparse(const Pool& pool, const Block& block) const {
+	return block.memory != VK_NULL_HANDLE && !block.isDedicated && block.allocationCount > 0 && block.usedBytes < pool.blockSize / SPARSE_BLOCK_DIVISOR;
+}
@@ -0,0 +1,21 @@
+#include "graphics/renderer/memory_utility.hpp"
+
+std::optional<std::uint32_t> graphics::renderer::findMemoryType(const VkPhysicalDevice& physicalDevice, const std::uint32_t typeBits, const VkMemoryPropertyFlags properties) {
+	VkPhysicalDeviceMemoryProperties memoryProperties{};
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	return findMemoryType(memoryProperties, typeBits, properties);
+}
+
+std::optional<std::uint32_t> graphics::renderer::findMemoryType(const VkPhysicalDeviceMemoryProperties& memoryProperties, const std::uint32_t typeBits, const VkMemoryPropertyFlags properties) {
+	for (std::uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+		const auto isAllowed = (typeBits & (1u << i)) != 0;
+		const auto hasProperties = (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties;
+
+		if (isAllowed && hasProperties) {
+			return i;
+		}
+	}
+
+	return std::nullopt;
+}
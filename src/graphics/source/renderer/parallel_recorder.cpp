@@ -0,0 +1,151 @@
+#include "graphics/renderer/parallel_recorder.hpp"
+
+#include "core/profiling/trace.hpp"
+#include "core/threading/thread_pool.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <future>
+
+using namespace graphics::renderer;
+
+ParallelRecorder::ParallelRecorder(const VkDevice& device, core::threading::ThreadPool* threadPool) :
+	device(device),
+	threadPool(threadPool),
+	chunkCount{ 1 },
+	pools{} {}
+
+bool ParallelRecorder::create(const std::uint32_t queueFamily, const std::uint32_t framesInFlight) {
+	chunkCount = threadPool != nullptr ? threadPool->getThreadCount() + 1 : 1;
+
+	// Buffers are recorded once per frame and the whole pool is reset at once, instead of every buffer on its own
+	VkCommandPoolCreateInfo commandPoolCreateInfo{};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = queueFamily;
+
+	pools.resize(static_cast<std::size_t>(framesInFlight) * chunkCount);
+
+	for (auto& pool : pools) {
+		if (vkCreateCommandPool(device, &commandPoolCreateInfo, nullptr, &pool.commandPool) != VK_SUCCESS) {
+			spdlog::error("Failed to create a command pool for secondary command buffers");
+			return false;
+		}
+	}
+
+	spdlog::debug("Command buffers are recorded by up to {} thread{}", chunkCount, chunkCount != 1 ? "s" : "");
+	return true;
+}
+
+bool ParallelRecorder::record(const std::uint32_t frameSlot, const std::uint32_t itemCount, const VkRenderPass& renderPass, const RecordFunction& recordItem, std::vector<VkCommandBuffer>& commandBuffers) {
+	PLAIN_TRACE_SCOPE("ParallelRecorder::record");
+
+	commandBuffers.assign(itemCount, VK_NULL_HANDLE);
+
+	if (itemCount == 0) {
+		return true;
+	}
+
+	// Every chunk writes a separate range of "commandBuffers", so the workers never touch the same element
+	const auto usedChunkCount = std::min(chunkCount, itemCount);
+	const auto itemsPerChunk = itemCount / usedChunkCount;
+	const auto remainder = itemCount % usedChunkCount;
+
+	const auto getFirstItem = [itemsPerChunk, remainder](const std::uint32_t chunk) {
+		return chunk * itemsPerChunk + std::min(chunk, remainder);
+	};
+
+	std::vector<std::future<bool>> jobs;
+	jobs.reserve(usedChunkCount - 1);
+
+	for (std::uint32_t chunk = 1; chunk < usedChunkCount; ++chunk) {
+		auto& pool = pools[frameSlot * chunkCount + chunk];
+		const auto firstItem = getFirstItem(chunk);
+		const auto lastItem = getFirstItem(chunk + 1);
+
+		jobs.push_back(threadPool->submit([this, &pool, firstItem, lastItem, &renderPass, &recordItem, &commandBuffers]() {
+			return recordChunk(pool, firstItem, lastItem, renderPass, recordItem, commandBuffers);
+		}));
+	}
+
+	// The calling thread records the first chunk instead of waiting idle
+	auto isSuccessful = recordChunk(pools[frameSlot * chunkCount], 0, getFirstItem(1), renderPass, recordItem, commandBuffers);
+
+	for (auto& job : jobs) {
+		isSuccessful = job.get() && isSuccessful;
+	}
+
+	return isSuccessful;
+}
+
+std::uint32_t ParallelRecorder::getChunkCount() const {
+	return chunkCount;
+}
+
+void ParallelRecorder::destroy() {
+	// Destroying a pool frees the buffers allocated from it
+	for (const auto& pool : pools) {
+		vkDestroyCommandPool(device, pool.commandPool, nullptr);
+	}
+
+	pools.clear();
+}
+
+bool ParallelRecorder::recordChunk(ChunkPool& pool, const std::uint32_t firstItem, const std::uint32_t lastItem, const VkRenderPass& renderPass, const RecordFunction& recordItem, std::vector<VkCommandBuffer>& commandBuffers) {
+	PLAIN_TRACE_SCOPE("ParallelRecorder::recordChunk");
+
+	// The frame that used these buffers before has finished executing
+	vkResetCommandPool(device, pool.commandPool, 0);
+
+	const auto bufferCount = lastItem - firstItem;
+
+	if (pool.commandBuffers.size() < bufferCount) {
+		const auto previousCount = static_cast<std::uint32_t>(pool.commandBuffers.size());
+		pool.commandBuffers.resize(bufferCount, VK_NULL_HANDLE);
+
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.commandPool = pool.commandPool;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		commandBufferAllocateInfo.commandBufferCount = bufferCount - previousCount;
+
+		if (vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, pool.commandBuffers.data() + previousCount) != VK_SUCCESS) {
+			spdlog::error("Failed to allocate secondary command buffers");
+			pool.commandBuffers.resize(previousCount);
+			return false;
+		}
+	}
+
+	// The framebuffer is left out, it differs per item and is only a hint
+	VkCommandBufferInheritanceInfo inheritanceInfo{};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = renderPass;
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+	for (auto item = firstItem; item < lastItem; ++item) {
+		const auto& commandBuffer = pool.commandBuffers[item - firstItem];
+
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+			spdlog::error("Failed to begin recording into a secondary command buffer");
+			return false;
+		}
+
+		recordItem(item, commandBuffer);
+
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+			spdlog::error("Failed to end recording into a secondary command buffer");
+			return false;
+		}
+
+		commandBuffers[item] = commandBuffer;
+	}
+
+	return true;
+}
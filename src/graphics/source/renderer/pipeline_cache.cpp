@@ -0,0 +1,122 @@
+#include "graphics/renderer/pipeline_cache.hpp"
+#include "graphics/renderer/cache_file.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+using namespace graphics::renderer;
+
+// Identifies pipeline cache files written by Plain, bump when the layout of the file header changes
+constexpr std::uint32_t PIPELINE_CACHE_FILE_MAGIC = 0x504C'5043; // "PLPC"
+
+PipelineCache::PipelineCache(const VkDevice& device) :
+	device(device),
+	pipelineCache{},
+	deviceProperties{},
+	path{} {}
+
+bool PipelineCache::create(const VkPhysicalDevice& physicalDevice, const std::filesystem::path& cachePath) {
+	vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+	path = cachePath;
+
+	const auto header = expectedHeader();
+	std::vector<std::uint8_t> initialData{};
+
+	if (const auto file = readCacheFile(path); file.has_value()) {
+		FileHeader fileHeader{};
+
+		if (file->size() >= sizeof(FileHeader)) {
+			std::memcpy(&fileHeader, file->data(), sizeof(FileHeader));
+		}
+
+		const auto data = std::span(*file).subspan(std::min(file->size(), sizeof(FileHeader)));
+
+		// Drivers are not required to survive invalid data, so anything that does not match exactly is discarded
+		const auto isCompatible = fileHeader.magic == header.magic
+			&& fileHeader.vendorId == header.vendorId
+			&& fileHeader.deviceId == header.deviceId
+			&& fileHeader.driverVersion == header.driverVersion
+			&& std::memcmp(fileHeader.pipelineCacheUuid, header.pipelineCacheUuid, VK_UUID_SIZE) == 0;
+
+		if (!isCompatible) {
+			spdlog::info("Ignoring pipeline cache {} because it was written by a different device or driver", path.string());
+		} else if (fileHeader.dataSize != data.size() || fileHeader.dataHash != hashBytes(data)) {
+			spdlog::warn("Ignoring pipeline cache {} because it is corrupted", path.string());
+		} else {
+			initialData.assign(data.begin(), data.end());
+			spdlog::debug("Loaded {} bytes of pipeline cache data from {}", initialData.size(), path.string());
+		}
+	}
+
+	VkPipelineCacheCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	createInfo.initialDataSize = initialData.size();
+	createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+	if (vkCreatePipelineCache(device, &createInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+		spdlog::error("Failed to create pipeline cache");
+		return false;
+	}
+
+	return true;
+}
+
+bool PipelineCache::save() const {
+	if (pipelineCache == VK_NULL_HANDLE) {
+		return false;
+	}
+
+	std::size_t dataSize = 0;
+
+	if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr) != VK_SUCCESS) {
+		spdlog::warn("Failed to query the size of the pipeline cache");
+		return false;
+	}
+
+	std::vector<std::uint8_t> file(sizeof(FileHeader) + dataSize);
+	const auto data = std::span(file).subspan(sizeof(FileHeader));
+
+	if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()) != VK_SUCCESS) {
+		spdlog::warn("Failed to retrieve the contents of the pipeline cache");
+		return false;
+	}
+
+	auto header = expectedHeader();
+	header.dataSize = dataSize;
+	header.dataHash = hashBytes(data.first(dataSize));
+	std::memcpy(file.data(), &header, sizeof(FileHeader));
+	file.resize(sizeof(FileHeader) + dataSize);
+
+	if (!writeCacheFile(path, file)) {
+		return false;
+	}
+
+	spdlog::debug("Saved {} bytes of pipeline cache data to {}", dataSize, path.string());
+	return true;
+}
+
+void PipelineCache::destroy() {
+	vkDestroyPipelineCache(device, pipelineCache, nullptr);
+	pipelineCache = VK_NULL_HANDLE;
+}
+
+const VkPipelineCache& PipelineCache::handle() const {
+	return pipelineCache;
+}
+
+PipelineCache::FileHeader PipelineCache::expectedHeader() const {
+	// Value-initialized so padding bytes are deterministic when the header is copied into the file
+	FileHeader header{};
+	header.magic = PIPELINE_CACHE_FILE_MAGIC;
+	header.vendorId = deviceProperties.vendorID;
+	header.deviceId = deviceProperties.deviceID;
+	header.driverVersion = deviceProperties.driverVersion;
+	std::memcpy(header.pipelineCacheUuid, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	return header;
+}
@@ -0,0 +1,354 @@
+#include "graphics/renderer/pipeline_library.hpp"
+#include "graphics/renderer/embedded_shaders.hpp"
+
+#include "core/threading/thread_pool.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <span>
+
+using namespace graphics::renderer;
+
+// The compositor draws every tile with the image pipeline, so it is built first
+constexpr std::array<PipelineType, PIPELINE_TYPE_COUNT> PIPELINE_BUILD_ORDER = {
+	PipelineType::Image,
+	PipelineType::Solid,
+	PipelineType::Text
+};
+
+// Indexed by pipeline type
+constexpr std::array<std::string_view, PIPELINE_TYPE_COUNT> FRAGMENT_SHADER_NAMES = {
+	"solid.fs",
+	"image.fs",
+	"text.fs"
+};
+
+constexpr std::string_view VERTEX_SHADER_NAME = "quad.vs";
+
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
+// Bytecode compiled by a previous run is reused, relative to the working directory
+constexpr const char* const SHADER_CACHE_DIRECTORY = "./cache/shaders";
+#else
+// Indexed by pipeline type
+constexpr std::array<std::span<const std::uint32_t>, PIPELINE_TYPE_COUNT> EMBEDDED_FRAGMENT_SHADERS = {
+	shaders::SOLID_FRAGMENT,
+	shaders::IMAGE_FRAGMENT,
+	shaders::TEXT_FRAGMENT
+};
+#endif
+
+// Compile a shader from source, or use the SPIR-V the build embedded in the library
+static std::unique_ptr<ShaderModule> loadShader(const VkDevice& device, [[maybe_unused]] const std::string_view name, [[maybe_unused]] const std::span<const std::uint32_t> embeddedSpirV) {
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
+	// Shader sources are read straight from the source tree, so edits show up without rebuilding
+	auto shaderModule = std::make_unique<ShaderModule>(device);
+	const auto path = std::string(PLAIN_SHADER_SOURCE_DIRECTORY "/") + std::string(name);
+
+	if (!shaderModule->compileFromFile(path, SHADER_CACHE_DIRECTORY)) {
+		return nullptr;
+	}
+#else
+	auto shaderModule = std::make_unique<ShaderModule>(device, embeddedSpirV);
+#endif
+
+	if (!shaderModule->create()) {
+		return nullptr;
+	}
+
+	return shaderModule;
+}
+
+PipelineLibrary::PipelineLibrary(const VkDevice& device) :
+	device(device),
+	renderPass{},
+	pipelineCache{},
+	pipelineLayout{},
+	pipelines{},
+	vertexShaderModule{},
+	vertexShaderReady{},
+	vertexShaderFuture{ vertexShaderReady.get_future().share() },
+	jobs{},
+	remainingJobCount{ 0 },
+	hasFailed{ false },
+	startTime{},
+	timingMutex{},
+	timings{} {}
+
+PipelineLibrary::~PipelineLibrary() {
+	// Jobs refer to this library, it must outlive them even when it is never destroyed explicitly
+	wait();
+}
+
+bool PipelineLibrary::initialize(const VkRenderPass& targetRenderPass, const VkDescriptorSetLayout& descriptorSetLayout, const VkPipelineCache& sharedPipelineCache, core::threading::ThreadPool* threadPool) {
+	renderPass = targetRenderPass;
+	pipelineCache = sharedPipelineCache;
+	startTime = std::chrono::steady_clock::now();
+
+	// The viewport size and origin are needed to convert page coordinates into normalized device coordinates
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = sizeof(QuadPushConstants);
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+	pipelineLayoutInfo.pushConstantRangeCount = 1;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+		spdlog::error("Failed to create pipeline layout");
+		return false;
+	}
+
+	// The vertex shader job is queued first, which guarantees that the pipeline jobs waiting for it can never starve it of a worker
+	std::vector<std::function<void()>> jobFunctions{};
+
+	jobFunctions.push_back([this]() {
+		runJob(VERTEX_SHADER_NAME, [this]() {
+			const auto isSuccessful = buildVertexShader();
+			vertexShaderReady.set_value();
+			return isSuccessful;
+		});
+	});
+
+	for (const auto type : PIPELINE_BUILD_ORDER) {
+		jobFunctions.push_back([this, type]() {
+			runJob(FRAGMENT_SHADER_NAMES[static_cast<std::size_t>(type)], [this, type]() { return buildPipeline(type); });
+		});
+	}
+
+	remainingJobCount = jobFunctions.size();
+
+	for (auto& job : jobFunctions) {
+		if (threadPool == nullptr) {
+			job();
+		} else {
+			jobs.push_back(threadPool->submit(std::move(job)));
+		}
+	}
+
+	return !hasFailed;
+}
+
+VkPipeline PipelineLibrary::get(const PipelineType type) const {
+	return pipelines[static_cast<std::size_t>(type)].load(std::memory_order_acquire);
+}
+
+bool PipelineLibrary::isReady(const PipelineType type) const {
+	return get(type) != VK_NULL_HANDLE;
+}
+
+bool PipelineLibrary::isBuilding() const {
+	return remainingJobCount > 0;
+}
+
+bool PipelineLibrary::wait() {
+	for (auto& job : jobs) {
+		job.wait();
+	}
+
+	jobs.clear();
+	return !hasFailed;
+}
+
+void PipelineLibrary::destroy() {
+	wait();
+
+	for (auto& pipeline : pipelines) {
+		vkDestroyPipeline(device, pipeline.exchange(VK_NULL_HANDLE), nullptr);
+	}
+
+	vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+	pipelineLayout = VK_NULL_HANDLE;
+}
+
+const VkPipelineLayout& PipelineLibrary::getLayout() const {
+	return pipelineLayout;
+}
+
+bool PipelineLibrary::buildVertexShader() {
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
+	vertexShaderModule = loadShader(device, VERTEX_SHADER_NAME, {});
+#else
+	vertexShaderModule = loadShader(device, VERTEX_SHADER_NAME, shaders::QUAD_VERTEX);
+#endif
+
+	return vertexShaderModule != nullptr;
+}
+
+bool PipelineLibrary::buildPipeline(const PipelineType type) {
+	const auto index = static_cast<std::size_t>(type);
+
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
+	const auto fragmentShaderModule = loadShader(device, FRAGMENT_SHADER_NAMES[index], {});
+#else
+	const auto fragmentShaderModule = loadShader(device, FRAGMENT_SHADER_NAMES[index], EMBEDDED_FRAGMENT_SHADERS[index]);
+#endif
+
+	// The fragment shader is compiled while the vertex shader job is still running
+	vertexShaderFuture.wait();
+
+	if (fragmentShaderModule == nullptr || vertexShaderModule == nullptr) {
+		return false;
+	}
+
+	// The pipelines only differ in their fragment shader
+	std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+	shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shaderStages[0].module = vertexShaderModule->handle();
+	shaderStages[0].pName = "main";
+	shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shaderStages[1].module = fragmentShaderModule->handle();
+	shaderStages[1].pName = "main";
+
+	const std::array<VkDynamicState, 2> dynamicStates = {
+		VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR
+	};
+
+	VkPipelineDynamicStateCreateInfo dynamicState{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
+	dynamicState.pDynamicStates = dynamicStates.data();
+
+	// Every quad is a single instance, its vertices are generated in the vertex shader
+	VkVertexInputBindingDescription instanceBinding{};
+	instanceBinding.binding = 0;
+	instanceBinding.stride = sizeof(QuadInstance);
+	instanceBinding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+	const std::array<VkVertexInputAttributeDescription, 4> instanceAttributes = {
+		VkVertexInputAttributeDescription{ 0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, static_cast<std::uint32_t>(offsetof(QuadInstance, rectangle)) },
+		VkVertexInputAttributeDescription{ 1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, static_cast<std::uint32_t>(offsetof(QuadInstance, textureCoordinates)) },
+		VkVertexInputAttributeDescription{ 2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, static_cast<std::uint32_t>(offsetof(QuadInstance, color)) },
+		VkVertexInputAttributeDescription{ 3, 0, VK_FORMAT_R32_UINT, static_cast<std::uint32_t>(offsetof(QuadInstance, texture)) }
+	};
+
+	VkPipelineVertexInputStateCreateInfo vertexInput{};
+	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInput.vertexBindingDescriptionCount = 1;
+	vertexInput.pVertexBindingDescriptions = &instanceBinding;
+	vertexInput.vertexAttributeDescriptionCount = static_cast<std::uint32_t>(instanceAttributes.size());
+	vertexInput.pVertexAttributeDescriptions = instanceAttributes.data();
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+	VkPipelineViewportStateCreateInfo viewportState{};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.depthClampEnable = VK_FALSE;
+	rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+	rasterizer.depthBiasEnable = VK_FALSE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.sampleShadingEnable = VK_FALSE;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	// All colors are premultiplied by their alpha
+	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	colorBlendAttachment.blendEnable = VK_TRUE;
+	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+	colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	VkPipelineColorBlendStateCreateInfo colorBlending{};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.logicOpEnable = VK_FALSE;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+
+	VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+	pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineCreateInfo.stageCount = static_cast<std::uint32_t>(shaderStages.size());
+	pipelineCreateInfo.pStages = shaderStages.data();
+	pipelineCreateInfo.pVertexInputState = &vertexInput;
+	pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
+	pipelineCreateInfo.pViewportState = &viewportState;
+	pipelineCreateInfo.pRasterizationState = &rasterizer;
+	pipelineCreateInfo.pMultisampleState = &multisampling;
+	pipelineCreateInfo.pColorBlendState = &colorBlending;
+	pipelineCreateInfo.pDynamicState = &dynamicState;
+	pipelineCreateInfo.layout = pipelineLayout;
+	pipelineCreateInfo.renderPass = renderPass;
+	pipelineCreateInfo.subpass = 0;
+
+	// Pipeline caches are internally synchronized, every job shares the same one
+	VkPipeline pipeline = VK_NULL_HANDLE;
+
+	if (vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineCreateInfo, nullptr, &pipeline) != VK_SUCCESS) {
+		spdlog::error("Failed to create the graphics pipeline for {}", FRAGMENT_SHADER_NAMES[index]);
+		return false;
+	}
+
+	pipelines[index].store(pipeline, std::memory_order_release);
+	return true;
+}
+
+void PipelineLibrary::runJob(const std::string_view name, const std::function<bool()>& job) {
+	const auto start = std::chrono::steady_clock::now();
+	const auto isSuccessful = job();
+	const auto end = std::chrono::steady_clock::now();
+
+	if (!isSuccessful) {
+		hasFailed = true;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(timingMutex);
+		timings.push_back({ name, std::this_thread::get_id(), start, end });
+	}
+
+	// Every pipeline that needs the vertex shader exists now, so its module can be released
+	if (--remainingJobCount == 0) {
+		vertexShaderModule.reset();
+		logTimeline();
+	}
+}
+
+void PipelineLibrary::logTimeline() const {
+	std::lock_guard<std::mutex> lock(timingMutex);
+
+	auto sortedTimings = timings;
+	std::sort(sortedTimings.begin(), sortedTimings.end(), [](const JobTiming& a, const JobTiming& b) { return a.start < b.start; });
+
+	const auto toMilliseconds = [this](const std::chrono::steady_clock::time_point time) {
+		return std::chrono::duration<double, std::milli>(time - startTime).count();
+	};
+
+	const auto totalTime = std::max_element(sortedTimings.begin(), sortedTimings.end(), [](const JobTiming& a, const JobTiming& b) { return a.end < b.end; })->end;
+	spdlog::debug("Built {} pipelines in {:.2f} ms", PIPELINE_TYPE_COUNT, toMilliseconds(totalTime));
+
+	// Threads are numbered in the order they picked up their first job
+	std::vector<std::thread::id> threads{};
+
+	for (const auto& timing : sortedTimings) {
+		auto thread = std::find(threads.begin(), threads.end(), timing.thread);
+
+		if (thread == threads.end()) {
+			thread = threads.insert(threads.end(), timing.thread);
+		}
+
+		spdlog::debug("  thread {} | {:<8} | {:8.2f} ms - {:8.2f} ms", std::distance(threads.begin(), thread), timing.name, toMilliseconds(timing.start), toMilliseconds(timing.end));
+	}
+}
@@ -0,0 +1,225 @@
+#include "graphics/renderer/quad_batcher.hpp"
+#include "graphics/text/text_system.hpp"
+
+#include "core/spatial/grid_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace graphics::renderer;
+
+// How many batches are searched for a compatible batch before starting a new one
+constexpr std::size_t MAX_BATCH_LOOKBACK = 16;
+
+// Convert a single sRGB encoded channel into linear space
+static float srgbToLinear(const float value) {
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+// Write an RGBA color as linear, premultiplied floating point values
+static void writeColor(float (&destination)[4], const std::uint32_t rgba) {
+	const auto alpha = static_cast<float>(rgba & 0xFF) / 255.0f;
+
+	destination[0] = srgbToLinear(static_cast<float>((rgba >> 24) & 0xFF) / 255.0f) * alpha;
+	destination[1] = srgbToLinear(static_cast<float>((rgba >> 16) & 0xFF) / 255.0f) * alpha;
+	destination[2] = srgbToLinear(static_cast<float>((rgba >> 8) & 0xFF) / 255.0f) * alpha;
+	destination[3] = alpha;
+}
+
+// Build an untextured quad
+static QuadInstance makeSolidQuad(const float x, const float y, const float width, const float height, const std::uint32_t rgba) {
+	QuadInstance quad{ { x, y, width, height }, { 0.0f, 0.0f, 1.0f, 1.0f }, {}, NO_TEXTURE };
+	writeColor(quad.color, rgba);
+
+	return quad;
+}
+
+QuadBatcher::QuadBatcher() :
+	pendingBatches{},
+	pendingBatchCount{ 0 },
+	candidates{},
+	quads{},
+	instances{},
+	batches{},
+	textures{} {}
+
+void QuadBatcher::build(const DisplayList& displayList, text::TextSystem& textSystem, const TextureId glyphAtlasTexture, const std::optional<Rectangle>& clip, const core::spatial::GridIndex* const index) {
+	pendingBatchCount = 0;
+	textures.clear();
+
+	const auto items = displayList.getItems();
+
+	// Candidates come back in paint order, so batching is unaffected by where they came from
+	if (clip.has_value() && index != nullptr && index->size() == items.size()) {
+		const auto& area = clip.value();
+		index->query({ area.x, area.y, area.width, area.height }, candidates);
+	} else {
+		candidates.resize(items.size());
+		std::iota(candidates.begin(), candidates.end(), 0u);
+	}
+
+	for (const auto candidate : candidates) {
+		const auto& item = items[candidate];
+
+		if (clip.has_value() && !getPaintBounds(item).intersects(clip.value())) {
+			continue;
+		}
+
+		quads.clear();
+
+		switch (item.type) {
+			case DisplayItemType::Rectangle:
+			{
+				const auto& bounds = item.bounds;
+				quads.push_back(makeSolidQuad(bounds.x, bounds.y, bounds.width, bounds.height, item.color));
+				append(PipelineType::Solid, bounds, quads);
+				break;
+			}
+
+			case DisplayItemType::Border:
+			{
+				const auto& bounds = item.bounds;
+				const auto width = std::min({ item.borderWidth, bounds.width * 0.5f, bounds.height * 0.5f });
+				const auto innerHeight = bounds.height - width * 2.0f;
+
+				// Top, bottom, left, and right edges - the corners belong to the horizontal edges to avoid overdraw
+				quads.push_back(makeSolidQuad(bounds.x, bounds.y, bounds.width, width, item.color));
+				quads.push_back(makeSolidQuad(bounds.x, bounds.y + bounds.height - width, bounds.width, width, item.color));
+				quads.push_back(makeSolidQuad(bounds.x, bounds.y + width, width, innerHeight, item.color));
+				quads.push_back(makeSolidQuad(bounds.x + bounds.width - width, bounds.y + width, width, innerHeight, item.color));
+				append(PipelineType::Solid, bounds, quads);
+				break;
+			}
+
+			case DisplayItemType::Image:
+			{
+				// Images that are not decoded yet leave their area empty
+				if (item.texture == NO_TEXTURE) {
+					break;
+				}
+
+				const auto& bounds = item.bounds;
+				quads.push_back({ { bounds.x, bounds.y, bounds.width, bounds.height }, { 0.0f, 0.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, item.texture });
+				append(PipelineType::Image, bounds, quads);
+
+				if (textures.empty() || textures.back() != item.texture) {
+					textures.push_back(item.texture);
+				}
+
+				break;
+			}
+
+			case DisplayItemType::GlyphRun:
+			{
+				const auto& run = textSystem.shape(item.font, item.pixelSize, displayList.getText(item));
+
+				QuadInstance quad{};
+				writeColor(quad.color, item.color);
+				quad.texture = glyphAtlasTexture;
+
+				for (const auto& shapedGlyph : run.glyphs) {
+					const auto glyph = textSystem.findGlyph(item.font, item.pixelSize, shapedGlyph.glyphIndex);
+
+					if (!glyph.has_value() || glyph->width == 0 || glyph->height == 0) {
+						continue;
+					}
+
+					// Snap glyphs to whole pixels to keep them crisp
+					quad.rectangle[0] = std::round(item.bounds.x + shapedGlyph.x) + static_cast<float>(glyph->bearingX);
+					quad.rectangle[1] = std::round(item.baseline) + static_cast<float>(glyph->bearingY);
+					quad.rectangle[2] = static_cast<float>(glyph->width);
+					quad.rectangle[3] = static_cast<float>(glyph->height);
+					quad.textureCoordinates[0] = glyph->u0;
+					quad.textureCoordinates[1] = glyph->v0;
+					quad.textureCoordinates[2] = glyph->u1;
+					quad.textureCoordinates[3] = glyph->v1;
+					quads.push_back(quad);
+				}
+
+				append(PipelineType::Text, item.bounds, quads);
+
+				if (!quads.empty() && (textures.empty() || textures.back() != glyphAtlasTexture)) {
+					textures.push_back(glyphAtlasTexture);
+				}
+
+				break;
+			}
+		}
+	}
+
+	// Consecutive duplicates are already left out, the rest only alternate between a few textures
+	std::sort(textures.begin(), textures.end());
+	textures.erase(std::unique(textures.begin(), textures.end()), textures.end());
+
+	// Flatten the batches into a single instance array
+	instances.clear();
+	batches.clear();
+
+	for (std::size_t i = 0; i < pendingBatchCount; ++i) {
+		const auto& pendingBatch = pendingBatches[i];
+
+		if (pendingBatch.instances.empty()) {
+			continue;
+		}
+
+		batches.push_back({ pendingBatch.pipeline, static_cast<std::uint32_t>(instances.size()), static_cast<std::uint32_t>(pendingBatch.instances.size()) });
+		instances.insert(instances.end(), pendingBatch.instances.begin(), pendingBatch.instances.end());
+	}
+}
+
+std::span<const QuadInstance> QuadBatcher::getInstances() const {
+	return instances;
+}
+
+std::span<const DrawBatch> QuadBatcher::getBatches() const {
+	return batches;
+}
+
+std::span<const TextureId> QuadBatcher::getTextures() const {
+	return textures;
+}
+
+void QuadBatcher::append(const PipelineType pipeline, const Rectangle& bounds, const std::span<const QuadInstance> itemQuads) {
+	if (itemQuads.empty()) {
+		return;
+	}
+
+	// Walk back through the most recent batches, an item may only be moved past batches that it does not overlap
+	const auto lookbackEnd = pendingBatchCount > MAX_BATCH_LOOKBACK ? pendingBatchCount - MAX_BATCH_LOOKBACK : 0;
+	PendingBatch* target = nullptr;
+
+	for (auto i = pendingBatchCount; i > lookbackEnd; --i) {
+		auto& candidate = pendingBatches[i - 1];
+
+		if (candidate.pipeline == pipeline) {
+			target = &candidate;
+			break;
+		}
+
+		if (candidate.bounds.intersects(bounds)) {
+			break;
+		}
+	}
+
+	if (target == nullptr) {
+		if (pendingBatchCount == pendingBatches.size()) {
+			pendingBatches.emplace_back();
+		}
+
+		target = &pendingBatches[pendingBatchCount++];
+		target->pipeline = pipeline;
+		target->bounds = bounds;
+		target->instances.clear();
+	} else {
+		// Grow the bounds to include the new item
+		const auto right = std::max(target->bounds.x + target->bounds.width, bounds.x + bounds.width);
+		const auto bottom = std::max(target->bounds.y + target->bounds.height, bounds.y + bounds.height);
+		target->bounds.x = std::min(target->bounds.x, bounds.x);
+		target->bounds.y = std::min(target->bounds.y, bounds.y);
+		target->bounds.width = right - target->bounds.x;
+		target->bounds.height = bottom - target->bounds.y;
+	}
+
+	target->instances.insert(target->instances.end(), itemQuads.begin(), itemQuads.end());
+}
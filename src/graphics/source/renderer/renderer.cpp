@@ -1,13 +1,28 @@
 #include "graphics/renderer/renderer.hpp"
-#include "graphics/renderer/shader_module.hpp"
+#include "graphics/renderer/damage_tracker.hpp"
+#include "graphics/renderer/gpu_profiler.hpp"
+#include "graphics/renderer/image_writer.hpp"
+#include "graphics/renderer/parallel_recorder.hpp"
+#include "graphics/renderer/pipeline_cache.hpp"
+#include "graphics/renderer/pipeline_library.hpp"
+#include "graphics/renderer/ring_buffer.hpp"
+#include "graphics/text/text_system.hpp"
 #include "graphics/window/window.hpp"
 
+#include "core/profiling/trace.hpp"
+#include "core/spatial/grid_index.hpp"
+
 #include "spdlog/spdlog.h"
 
 #include "GLFW/glfw3.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <map>
 #include <optional>
@@ -16,6 +31,41 @@
 using namespace graphics::renderer;
 using namespace graphics::window;
 
+// Upper limit of quads that can be drawn in a single frame
+constexpr std::size_t MAX_QUAD_INSTANCE_COUNT = 65'536;
+
+// Upper limit of textures that can be registered with the renderer, the texture array of "image.fs" and "text.fs" must be this large
+constexpr std::uint32_t MAX_TEXTURE_COUNT = 1'024;
+
+// Format of the images rendered to in headless mode, matches the swapchain format that is preferred on screen
+constexpr VkFormat OFFSCREEN_IMAGE_FORMAT = VK_FORMAT_B8G8R8A8_SRGB;
+
+// Files that make the second start faster than the first one, relative to the working directory
+constexpr const char* const PIPELINE_CACHE_PATH = "./cache/pipelines.bin";
+
+// Format of textures created from decoded images
+constexpr VkFormat TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+
+// Size of the staging ring that streamed uploads are copied through, and the number of bytes uploaded per frame at most
+// Keeping the budget well below the ring size lets a frame stage new data while the copies of previous frames still execute
+constexpr VkDeviceSize UPLOAD_STAGING_SIZE = 16ull * 1'024 * 1'024;
+constexpr VkDeviceSize UPLOAD_BUDGET_PER_FRAME = 4ull * 1'024 * 1'024;
+
+// Number of tiles kept in the cache, relative to the number of tiles needed to cover the viewport
+constexpr std::uint32_t TILE_CACHE_VIEWPORT_MULTIPLIER = 3;
+
+// Tiles are recorded into secondary command buffers on the workers once a frame has this many tile draw batches, fewer are recorded inline faster
+constexpr std::size_t PARALLEL_RECORDING_BATCH_COUNT = 256;
+
+// Layout of the profiler overlay in the top-left corner of the window, in pixels
+constexpr float PROFILER_OVERLAY_MARGIN = 8.0f;
+constexpr float PROFILER_OVERLAY_PADDING = 6.0f;
+constexpr float PROFILER_OVERLAY_WIDTH = 200.0f;
+constexpr float PROFILER_OVERLAY_LINE_HEIGHT = 16.0f;
+constexpr std::uint32_t PROFILER_OVERLAY_FONT_SIZE = 12;
+constexpr std::uint32_t PROFILER_OVERLAY_BACKGROUND_COLOR = 0x000000C0;
+constexpr std::uint32_t PROFILER_OVERLAY_TEXT_COLOR = 0xFFFFFFFF;
+
 static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
 	VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
 	VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -30,38 +80,151 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
 	} else if (messageSeverity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
 		spdlog::warn(callbackData->pMessage);
 	} else {
-		spdlog::trace(callbackData->pMessage);
+		SPDLOG_TRACE("{}", callbackData->pMessage);
 	}
 
 	return VK_FALSE;
 }
 
-Renderer::Renderer() :
+struct SwapchainSupportDetails {
+	VkSurfaceCapabilitiesKHR capabilities;
+	std::vector<VkSurfaceFormatKHR> formats;
+	std::vector<VkPresentModeKHR> presentModes;
+};
+
+static SwapchainSupportDetails querySwapchainSupport(const VkPhysicalDevice& gpu, const VkSurfaceKHR& surface) {
+	SwapchainSupportDetails details{};
+	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gpu, surface, &details.capabilities);
+
+	std::uint32_t formatCount = 0;
+	vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, surface, &formatCount, nullptr);
+
+	if (formatCount != 0) {
+		details.formats.resize(formatCount);
+		vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, surface, &formatCount, details.formats.data());
+	}
+
+	std::uint32_t presentModeCount = 0;
+	vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &presentModeCount, nullptr);
+
+	if (presentModeCount != 0) {
+		details.presentModes.resize(presentModeCount);
+		vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &presentModeCount, details.presentModes.data());
+	}
+
+	return details;
+}
+
+static VkSurfaceFormatKHR chooseSwapchainSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) {
+	for (const auto& availableFormat : availableFormats) {
+		if (availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+			// Prefer the most accurate format, which is non-linear sRGB
+			return availableFormat;
+		}
+	}
+
+	// If the preferred format does not exist, we will just use whatever is available first
+	return availableFormats[0];
+}
+
+static VkExtent2D chooseSwapchainExtent(const VkSurfaceCapabilitiesKHR& surfaceCapabilities, const std::uint32_t width, const std::uint32_t height) {
+	if (surfaceCapabilities.currentExtent.width != std::numeric_limits<std::uint32_t>::max()) {
+		return surfaceCapabilities.currentExtent;
+	}
+
+	// Special value was set by window manager - try to make a framebuffer with a resolution that best matches the window
+	// The window's resolution will be the target size, unless it exceeds the bounds of the surface
+	return {
+		std::clamp(width, surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width),
+		std::clamp(height, surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height)
+	};
+}
+
+Renderer::Renderer(core::threading::ThreadPool* threadPool, const std::uint32_t framesInFlight) :
 	instance{},
+	physicalDevice{},
 	device{},
+	memoryAllocator{},
 	graphicsQueue{},
 	presentQueue{},
+	transferQueue{},
 	surface{},
 	swapchain{},
+	targetWindow{ nullptr },
+	graphicsQueueFamily{ 0 },
+	presentQueueFamily{ 0 },
 	renderPass{},
-	pipelineLayout{},
-	graphicsPipeline{},
+	pipelineCache{},
+	pipelineLibrary{},
+	textureDescriptorSetLayout{},
+	descriptorPool{},
+	textureSampler{},
 	commandPool{},
-	commandBuffer{},
+	gpuProfiler{},
+	parallelRecorder{},
 #ifndef NDEBUG
 	debugMessenger{},
 #endif
 	swapchainImageFormat{ VK_FORMAT_UNDEFINED },
 	swapchainExtent{ 0, 0 },
+	swapchainPresentMode{ VK_PRESENT_MODE_FIFO_KHR },
 	swapchainImages{},
 	swapchainImageViews{},
 	swapchainFrameBuffers{},
-	imageAvailableSemaphore{},
-	renderFinishedSemaphore{},
-	inFlightFence{},
+	offscreenImageAllocations{},
+	readbackBuffer{},
+	readbackAllocation{},
+	readbackData{ nullptr },
+	lastRenderedImage{},
+	threadPool(threadPool),
+	framesInFlight{ std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT) },
+	currentFrame{ 0 },
+	frames{},
+	transientBuffer{},
+	renderFinishedSemaphores{},
+	textSystem{},
+	textureDescriptorSet{},
+	textureUploads{},
+	streamingUploader{},
+	textureImages{},
+	glyphAtlasTexture{ NO_TEXTURE },
+	displayList{},
+	quadBatcher{},
+	displayListIndexBuilder{ std::make_unique<core::spatial::GridIndexBuilder>(static_cast<float>(TILE_SIZE)) },
+	displayListIndex{},
+	profilerOverlayFont{},
+	profilerOverlay{},
+	overlayBatches{},
+	tileCache{},
+	visibleTiles{},
+	tileRasters{},
+	tileBatches{},
+	tileCommandBuffers{},
+	damage{},
+	scrollX{ 0.0f },
+	scrollY{ 0.0f },
+	pageTransform{ IDENTITY_TRANSFORM },
+	pageOpacity{ 1.0f },
+	framePacer{ PacingPolicy::Adaptive, MAX_FRAMES_IN_FLIGHT },
+	frameIndex{ 0 },
+	needsComposite{ true },
+	isTileShortageReported{ false },
+	isSwapchainOutdated{ false },
 	isDestroyed{ false } {}
 
+Renderer::~Renderer() = default;
+
 bool Renderer::initialize(const window::Window& window) {
+	return initialize(&window, window.getWidth(), window.getHeight());
+}
+
+bool Renderer::initializeHeadless(const std::uint32_t width, const std::uint32_t height) {
+	return initialize(nullptr, width, height);
+}
+
+bool Renderer::initialize(const window::Window* const window, const std::uint32_t width, const std::uint32_t height) {
+	PLAIN_TRACE_SCOPE("Renderer::initialize");
+
 #ifndef NDEBUG
 	VkDebugUtilsMessengerCreateInfoEXT debugMessengerCreateInfo{};
 	debugMessengerCreateInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
@@ -75,16 +238,19 @@ bool Renderer::initialize(const window::Window& window) {
 		"VK_LAYER_KHRONOS_validation"
 	};
 
-	const std::vector<const char*> requiredDeviceExtensions = {
-		VK_KHR_SWAPCHAIN_EXTENSION_NAME
-	};
+	// Without a window nothing is presented, so neither a surface nor a swapchain is needed
+	std::vector<const char*> requiredDeviceExtensions;
+	std::vector<const char*> requiredExtensions;
+
+	if (window != nullptr) {
+		requiredDeviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
-	std::uint32_t glfwExtensionCount = 0;
-	const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		std::uint32_t glfwExtensionCount = 0;
+		const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
-	std::vector<const char*> requiredExtensions(glfwExtensionCount);
-	for (std::uint32_t i = 0; i < glfwExtensionCount; ++i) {
-		requiredExtensions[i] = glfwExtensions[i];
+		for (std::uint32_t i = 0; i < glfwExtensionCount; ++i) {
+			requiredExtensions.push_back(glfwExtensions[i]);
+		}
 	}
 
 	requiredExtensions.emplace_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
@@ -176,7 +342,7 @@ bool Renderer::initialize(const window::Window& window) {
 		return false;
 	}
 
-	if (glfwCreateWindowSurface(instance, window.getRawHandle(), nullptr, &surface) != VK_SUCCESS) {
+	if (window != nullptr && glfwCreateWindowSurface(instance, window->getRawHandle(), nullptr, &surface) != VK_SUCCESS) {
 		spdlog::error("Failed to create Vulkan surface");
 		return false;
 	}
@@ -209,6 +375,9 @@ bool Renderer::initialize(const window::Window& window) {
 		std::optional<std::uint32_t> graphics;
 		std::optional<std::uint32_t> present;
 
+		// Optional, uploads run on the graphics queue family when the device has no dedicated transfer queue
+		std::optional<std::uint32_t> transfer;
+
 		/**
 		 * @brief Utility method to help determine if all queue family indices were found
 		 * @return True if all indices have been found, false when one or multiple indices are missing
@@ -222,7 +391,7 @@ bool Renderer::initialize(const window::Window& window) {
 		* @return Vector containing the unique queue indices
 		*/
 		const std::set<std::uint32_t> getUniqueIndices() const {
-			return { graphics.value(), present.value() };
+			return { graphics.value(), present.value(), transfer.value_or(graphics.value()) };
 		}
 	};
 
@@ -235,17 +404,36 @@ bool Renderer::initialize(const window::Window& window) {
 		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
 		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
+		// A family without graphics support maps to the copy engines of the GPU, which run alongside rendering
+		// Uploads are split into bands of rows, which requires a transfer granularity of single texels
+		for (std::uint32_t i = 0; i < queueFamilyCount; ++i) {
+			const auto& queueFamily = queueFamilies[i];
+
+			const auto isTransferOnly = (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) > 0 && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0;
+			const auto hasTexelGranularity = queueFamily.minImageTransferGranularity.width == 1 && queueFamily.minImageTransferGranularity.height == 1;
+
+			// Families that can also run compute work are only used when there is no pure transfer family
+			if (isTransferOnly && hasTexelGranularity && (!indices.transfer.has_value() || (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) == 0)) {
+				indices.transfer = i;
+			}
+		}
+
 		std::uint32_t index = 0;
 		for (const auto& queueFamily : queueFamilies) {
 			if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) > 0) {
 				indices.graphics = index;
 			}
 
-			VkBool32 hasPresentSupport = VK_FALSE;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, index, surface, &hasPresentSupport);
+			if (surface == VK_NULL_HANDLE) {
+				// Headless rendering never presents, the graphics queue takes the place of the present queue
+				indices.present = indices.graphics;
+			} else {
+				VkBool32 hasPresentSupport = VK_FALSE;
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, index, surface, &hasPresentSupport);
 
-			if (hasPresentSupport == VK_TRUE) {
-				indices.present = index;
+				if (hasPresentSupport == VK_TRUE) {
+					indices.present = index;
+				}
 			}
 
 			// All necessary indices found, no need to keep searching
@@ -259,36 +447,7 @@ bool Renderer::initialize(const window::Window& window) {
 		return indices;
 	};
 
-	struct SwapchainSupportDetails {
-		VkSurfaceCapabilitiesKHR capabilities;
-		std::vector<VkSurfaceFormatKHR> formats;
-		std::vector<VkPresentModeKHR> presentModes;
-	};
-
-	constexpr auto querySwapchainSupport = [](const VkPhysicalDevice& gpu, const VkSurfaceKHR& surface) {
-		SwapchainSupportDetails details{};
-		vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gpu, surface, &details.capabilities);
-
-		std::uint32_t formatCount = 0;
-		vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, surface, &formatCount, nullptr);
-
-		if (formatCount != 0) {
-			details.formats.resize(formatCount);
-			vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, surface, &formatCount, details.formats.data());
-		}
-
-		std::uint32_t presentModeCount = 0;
-		vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &presentModeCount, nullptr);
-
-		if (presentModeCount != 0) {
-			details.presentModes.resize(presentModeCount);
-			vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &presentModeCount, details.presentModes.data());
-		}
-
-		return details;
-	};
-
-	const auto isDeviceSuitable = [&findQueueFamilyIndices, &requiredDeviceExtensions, &querySwapchainSupport](const VkPhysicalDevice& gpu, const VkSurfaceKHR& surface) -> bool {
+	const auto isDeviceSuitable = [&findQueueFamilyIndices, &requiredDeviceExtensions](const VkPhysicalDevice& gpu, const VkSurfaceKHR& surface) -> bool {
 		std::uint32_t deviceExtensionCount = 0;
 		vkEnumerateDeviceExtensionProperties(gpu, nullptr, &deviceExtensionCount, nullptr);
 
@@ -316,10 +475,12 @@ bool Renderer::initialize(const window::Window& window) {
 			return false;
 		}
 
-		const auto swapchainSupport = querySwapchainSupport(gpu, surface);
-		if (swapchainSupport.formats.empty() || swapchainSupport.presentModes.empty()) {
-			spdlog::trace("Unable to find a swap chain with the necessary capabilities");
-			return false;
+		if (surface != VK_NULL_HANDLE) {
+			const auto swapchainSupport = querySwapchainSupport(gpu, surface);
+			if (swapchainSupport.formats.empty() || swapchainSupport.presentModes.empty()) {
+				spdlog::trace("Unable to find a swap chain with the necessary capabilities");
+				return false;
+			}
 		}
 
 		const auto queueFamilyIndices = findQueueFamilyIndices(gpu, surface);
@@ -329,6 +490,53 @@ bool Renderer::initialize(const window::Window& window) {
 			return false;
 		}
 
+		// Uploads are handed over to the graphics queue with a timeline semaphore
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(gpu, &properties);
+
+		if (properties.apiVersion < VK_API_VERSION_1_2) {
+			spdlog::trace("Unable to use Vulkan 1.2");
+			return false;
+		}
+
+		VkPhysicalDeviceVulkan12Features vulkan12Features{};
+		vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &vulkan12Features;
+
+		vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+		if (vulkan12Features.timelineSemaphore != VK_TRUE) {
+			spdlog::trace("Unable to use timeline semaphores");
+			return false;
+		}
+
+		// Every texture is reachable through a single array of descriptors, which grows while frames that use it are in flight
+		if (vulkan12Features.shaderSampledImageArrayNonUniformIndexing != VK_TRUE
+			|| vulkan12Features.descriptorBindingSampledImageUpdateAfterBind != VK_TRUE
+			|| vulkan12Features.descriptorBindingUpdateUnusedWhilePending != VK_TRUE
+			|| vulkan12Features.descriptorBindingPartiallyBound != VK_TRUE) {
+			spdlog::trace("Unable to use descriptor indexing");
+			return false;
+		}
+
+		VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+		vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &vulkan12Properties;
+
+		vkGetPhysicalDeviceProperties2(gpu, &properties2);
+
+		// Combined image samplers count against both limits
+		if (vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages < MAX_TEXTURE_COUNT || vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers < MAX_TEXTURE_COUNT) {
+			spdlog::trace("Unable to bind {} textures at once", MAX_TEXTURE_COUNT);
+			return false;
+		}
+
 		return true;
 	};
 
@@ -404,7 +612,7 @@ bool Renderer::initialize(const window::Window& window) {
 		return false;
 	}
 
-	VkPhysicalDevice physicalDevice{ bestGpu->second };
+	physicalDevice = bestGpu->second;
 
 	const auto queueFamilyIndices = findQueueFamilyIndices(physicalDevice, surface);
 
@@ -432,8 +640,17 @@ bool Renderer::initialize(const window::Window& window) {
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	vulkan12Features.timelineSemaphore = VK_TRUE;
+	vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+	vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+	vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+
 	VkDeviceCreateInfo deviceCreateInfo{};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceCreateInfo.pNext = &vulkan12Features;
 	deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 	deviceCreateInfo.queueCreateInfoCount = static_cast<std::uint32_t>(queueCreateInfos.size());
 	deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
@@ -454,118 +671,47 @@ bool Renderer::initialize(const window::Window& window) {
 
 	vkGetDeviceQueue(device, queueFamilyIndices.graphics.value(), 0, &graphicsQueue);
 	vkGetDeviceQueue(device, queueFamilyIndices.present.value(), 0, &presentQueue);
+	vkGetDeviceQueue(device, queueFamilyIndices.transfer.value_or(queueFamilyIndices.graphics.value()), 0, &transferQueue);
 
-	constexpr auto chooseSwapchainSurfaceFormat = [](const std::vector<VkSurfaceFormatKHR>& availableFormats) -> VkSurfaceFormatKHR {
-		for (const auto& availableFormat : availableFormats) {
-			if (availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
-				// Prefer the most accurate format, which is non-linear sRGB
-				return availableFormat;
-			}
-		}
-
-		// If the preferred format does not exist, we will just use whatever is available first
-		return availableFormats[0];
-	};
-
-	constexpr auto chooseSwapchainPresentMode = [](const std::vector<VkPresentModeKHR>& availablePresentModes) -> VkPresentModeKHR {
-		for (const auto& availablePresentMode : availablePresentModes) {
-			if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-				// Prefer mailbox present mode to allow for triple-buffering, low latency, and reduced tearing
-				// If running on a mobile device, FIFO might be preferable instead due to the energy usage of the mailbox present mode
-				return availablePresentMode;
-			}
-		}
-
-		// FIFO is always available as per the Vulkan specification
-		return VK_PRESENT_MODE_FIFO_KHR;
-	};
-
-	const auto chooseSwapchainExtent = [&window](const VkSurfaceCapabilitiesKHR& surfaceCapabilities) -> VkExtent2D {
-		if (surfaceCapabilities.currentExtent.width != std::numeric_limits<std::uint32_t>::max()) {
-			return surfaceCapabilities.currentExtent;
-		}
-
-		// Special value was set by window manager - try to make a framebuffer with a resolution that best matches the window
-		// The window's resolution will be the target size, unless it exceeds the bounds of the surface
-		return {
-			std::clamp(window.getWidth(), surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width),
-			std::clamp(window.getHeight(), surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height)
-		};
-	};
-
-	// Create a swapchain
-	const auto swapchainSupport = querySwapchainSupport(physicalDevice, surface);
-	const auto swapchainSurfaceFormat = chooseSwapchainSurfaceFormat(swapchainSupport.formats);
-	const auto swapchainPresentMode = chooseSwapchainPresentMode(swapchainSupport.presentModes);
-
-	swapchainImageFormat = swapchainSurfaceFormat.format;
-	swapchainExtent = chooseSwapchainExtent(swapchainSupport.capabilities);
-
-	std::uint32_t imageCount = swapchainSupport.capabilities.minImageCount + 1;
-	imageCount = std::clamp(imageCount, imageCount, swapchainSupport.capabilities.maxImageCount);
-
-	VkSwapchainCreateInfoKHR swapchainCreateInfo{};
-	swapchainCreateInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-	swapchainCreateInfo.surface = surface;
-	swapchainCreateInfo.minImageCount = imageCount;
-	swapchainCreateInfo.imageFormat = swapchainSurfaceFormat.format;
-	swapchainCreateInfo.imageColorSpace = swapchainSurfaceFormat.colorSpace;
-	swapchainCreateInfo.imageExtent = swapchainExtent;
-	swapchainCreateInfo.imageArrayLayers = 1;
-	swapchainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-	swapchainCreateInfo.preTransform = swapchainSupport.capabilities.currentTransform;
-	swapchainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-	swapchainCreateInfo.presentMode = swapchainPresentMode;
-	swapchainCreateInfo.clipped = VK_TRUE;
-	swapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
+	graphicsQueueFamily = queueFamilyIndices.graphics.value();
+	presentQueueFamily = queueFamilyIndices.present.value();
 
-	if (queueFamilyIndices.graphics.value() != queueFamilyIndices.present.value()) {
-		const std::uint32_t indices[] = { queueFamilyIndices.graphics.value(), queueFamilyIndices.present.value() };
+	// Every buffer and image of the renderer is sub-allocated from a few large blocks instead of one allocation each
+	memoryAllocator = std::make_unique<MemoryAllocator>(device);
 
-		swapchainCreateInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
-		swapchainCreateInfo.queueFamilyIndexCount = 2;
-		swapchainCreateInfo.pQueueFamilyIndices = indices;
-	} else {
-		// To keep things simple, if both queue families are identical, exclusive mode will be used to avoid having to deal with ownership
-		swapchainCreateInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if (!memoryAllocator->initialize(physicalDevice)) {
+		return false;
 	}
 
-	if (vkCreateSwapchainKHR(device, &swapchainCreateInfo, nullptr, &swapchain) != VK_SUCCESS) {
-		spdlog::error("Failed to create swapchain");
+	// Images are uploaded on the dedicated transfer queue when there is one, so large uploads do not hold up rendering
+	streamingUploader = std::make_unique<StreamingUploader>(device, *memoryAllocator);
+
+	if (!streamingUploader->create(transferQueue, queueFamilyIndices.transfer.value_or(queueFamilyIndices.graphics.value()), queueFamilyIndices.graphics.value(), UPLOAD_STAGING_SIZE, UPLOAD_BUDGET_PER_FRAME)) {
 		return false;
 	}
 
-	// Retrieve images that back the swapchain
-	std::uint32_t swapchainImageCount = 0;
-	vkGetSwapchainImagesKHR(device, swapchain, &swapchainImageCount, nullptr);
-
-	swapchainImages.resize(swapchainImageCount);
-	vkGetSwapchainImagesKHR(device, swapchain, &swapchainImageCount, swapchainImages.data());
+	// Pipelines compiled by a previous run on this device are reused, a missing or outdated cache only slows down startup
+	pipelineCache = std::make_unique<PipelineCache>(device);
 
-	swapchainImageViews.resize(swapchainImages.size());
+	if (!pipelineCache->create(physicalDevice, PIPELINE_CACHE_PATH)) {
+		return false;
+	}
 
-	for (auto i = 0; i < swapchainImageViews.size(); ++i) {
-		VkImageViewCreateInfo createInfo{};
-		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		createInfo.image = swapchainImages[i];
-		createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		createInfo.format = swapchainImageFormat;
+	targetWindow = window;
 
-		createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		createInfo.subresourceRange.baseMipLevel = 0;
-		createInfo.subresourceRange.levelCount = 1;
-		createInfo.subresourceRange.baseArrayLayer = 0;
-		createInfo.subresourceRange.layerCount = 1;
+	if (window != nullptr) {
+		// Mailbox presentation is capped at the refresh rate, so it does not render frames that are never shown
+		framePacer.setRefreshRate(window->getRefreshRate());
 
-		createInfo.components = {
-			VK_COMPONENT_SWIZZLE_IDENTITY,
-			VK_COMPONENT_SWIZZLE_IDENTITY,
-			VK_COMPONENT_SWIZZLE_IDENTITY,
-			VK_COMPONENT_SWIZZLE_IDENTITY
-		};
+		if (!createSwapchain(VK_NULL_HANDLE)) {
+			return false;
+		}
+	} else {
+		// Offscreen images take the place of the swapchain, one per frame in flight
+		swapchainImageFormat = OFFSCREEN_IMAGE_FORMAT;
+		swapchainExtent = { width, height };
 
-		if (vkCreateImageView(device, &createInfo, nullptr, &swapchainImageViews[i]) != VK_SUCCESS) {
-			spdlog::error("Failed to create image view for swapchain image");
+		if (!createOffscreenImages()) {
 			return false;
 		}
 	}
@@ -578,7 +724,7 @@ bool Renderer::initialize(const window::Window& window) {
 	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	colorAttachment.finalLayout = window != nullptr ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
 
 	VkAttachmentReference colorAttachmentRef{};
 	colorAttachmentRef.attachment = 0;
@@ -613,130 +759,86 @@ bool Renderer::initialize(const window::Window& window) {
 		return false;
 	}
 
-	// Load shader source code and compile into SPIR-V
-	auto vertexShaderModule = ShaderModule{ device };
-
-	if (!vertexShaderModule.compileFromFile("./resources/shaders/triangle.vs") || !vertexShaderModule.create()) {
+	// Every texture is an element of a single array of combined image samplers, instances select theirs by index
+	// The set stays bound while elements are written: registering a texture fills a new element while earlier frames are still pending,
+	// which update-after-bind allows as long as no pending frame uses that element - compactMemory() rewrites live elements only after the device is idle
+	// Elements that were never written are fine as long as nothing samples them, since the binding is partially bound
+	VkDescriptorSetLayoutBinding textureBinding{};
+	textureBinding.binding = 0;
+	textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	textureBinding.descriptorCount = MAX_TEXTURE_COUNT;
+	textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	const VkDescriptorBindingFlags textureBindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo{};
+	bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+	bindingFlagsCreateInfo.bindingCount = 1;
+	bindingFlagsCreateInfo.pBindingFlags = &textureBindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{};
+	descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	descriptorSetLayoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+	descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+	descriptorSetLayoutCreateInfo.bindingCount = 1;
+	descriptorSetLayoutCreateInfo.pBindings = &textureBinding;
+
+	if (vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, nullptr, &textureDescriptorSetLayout) != VK_SUCCESS) {
+		spdlog::error("Failed to create descriptor set layout");
 		return false;
 	}
 
-	VkPipelineShaderStageCreateInfo vertexShaderStageInfo{};
-	vertexShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	vertexShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-	vertexShaderStageInfo.module = vertexShaderModule.handle();
-	vertexShaderStageInfo.pName = "main";
+	VkDescriptorPoolSize descriptorPoolSize{};
+	descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorPoolSize.descriptorCount = MAX_TEXTURE_COUNT;
 
-	auto fragmentShaderModule = ShaderModule{ device };
+	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
+	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+	descriptorPoolCreateInfo.maxSets = 1;
+	descriptorPoolCreateInfo.poolSizeCount = 1;
+	descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
 
-	if (!fragmentShaderModule.compileFromFile("./resources/shaders/triangle.fs") || !fragmentShaderModule.create()) {
+	if (vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+		spdlog::error("Failed to create descriptor pool");
 		return false;
 	}
 
-	VkPipelineShaderStageCreateInfo fragmentShaderStageInfo{};
-	fragmentShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-	fragmentShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	fragmentShaderStageInfo.module = fragmentShaderModule.handle();
-	fragmentShaderStageInfo.pName = "main";
-
-	const std::vector<VkPipelineShaderStageCreateInfo> shaderStages = { vertexShaderStageInfo, fragmentShaderStageInfo };
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
+	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	descriptorSetAllocateInfo.descriptorPool = descriptorPool;
+	descriptorSetAllocateInfo.descriptorSetCount = 1;
+	descriptorSetAllocateInfo.pSetLayouts = &textureDescriptorSetLayout;
 
-	// Pipeline creation
-	std::vector<VkDynamicState> dynamicStates = {
-		VK_DYNAMIC_STATE_VIEWPORT,
-		VK_DYNAMIC_STATE_SCISSOR
-	};
-
-	VkPipelineDynamicStateCreateInfo dynamicState{};
-	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-	dynamicState.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
-	dynamicState.pDynamicStates = dynamicStates.data();
-
-	VkPipelineVertexInputStateCreateInfo vertexInput{};
-	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	vertexInput.vertexBindingDescriptionCount = 0;
-	vertexInput.vertexAttributeDescriptionCount = 0;
-
-	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-	inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-	VkPipelineViewportStateCreateInfo viewportState{};
-	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportState.viewportCount = 1;
-	viewportState.scissorCount = 1;
-
-	VkPipelineRasterizationStateCreateInfo rasterizer{};
-	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-	rasterizer.depthClampEnable = VK_FALSE;
-	rasterizer.rasterizerDiscardEnable = VK_FALSE;
-	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-	rasterizer.lineWidth = 1.0f;
-	rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-	rasterizer.depthBiasEnable = VK_FALSE;
-
-	VkPipelineMultisampleStateCreateInfo multisampling{};
-	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-	multisampling.sampleShadingEnable = VK_FALSE;
-	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_FALSE;
-
-	VkPipelineColorBlendStateCreateInfo colorBlending{};
-	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	colorBlending.logicOpEnable = VK_FALSE;
-	colorBlending.attachmentCount = 1;
-	colorBlending.pAttachments = &colorBlendAttachment;
-
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-
-	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
-		spdlog::error("Failed to create pipeline layout");
-		return false;
-	}
-
-	VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
-	pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipelineCreateInfo.stageCount = static_cast<std::uint32_t>(shaderStages.size());
-	pipelineCreateInfo.pStages = shaderStages.data();
-	pipelineCreateInfo.pVertexInputState = &vertexInput;
-	pipelineCreateInfo.pInputAssemblyState = &inputAssembly;
-	pipelineCreateInfo.pViewportState = &viewportState;
-	pipelineCreateInfo.pRasterizationState = &rasterizer;
-	pipelineCreateInfo.pMultisampleState = &multisampling;
-	pipelineCreateInfo.pColorBlendState = &colorBlending;
-	pipelineCreateInfo.pDynamicState = &dynamicState;
-	pipelineCreateInfo.layout = pipelineLayout;
-	pipelineCreateInfo.renderPass = renderPass;
-	pipelineCreateInfo.subpass = 0;
-
-	if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
-		spdlog::error("Failed to create graphics pipeline");
+	if (vkAllocateDescriptorSets(device, &descriptorSetAllocateInfo, &textureDescriptorSet) != VK_SUCCESS) {
+		spdlog::error("Failed to allocate the texture descriptor set");
 		return false;
 	}
 
-	swapchainFrameBuffers.resize(swapchainImageViews.size());
+	VkSamplerCreateInfo samplerCreateInfo{};
+	samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+	samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+	samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.maxLod = 0.0f;
+
+	if (vkCreateSampler(device, &samplerCreateInfo, nullptr, &textureSampler) != VK_SUCCESS) {
+		spdlog::error("Failed to create texture sampler");
+		return false;
+	}
 
-	for (auto i = 0; i < swapchainImageViews.size(); ++i) {
-		VkImageView attachments[] = { swapchainImageViews[i] };
+	// Pipelines are built on worker threads, the first frames draw with whichever pipelines are ready
+	pipelineLibrary = std::make_unique<PipelineLibrary>(device);
 
-		VkFramebufferCreateInfo framebufferCreateInfo{};
-		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebufferCreateInfo.renderPass = renderPass;
-		framebufferCreateInfo.attachmentCount = 1;
-		framebufferCreateInfo.pAttachments = attachments;
-		framebufferCreateInfo.width = swapchainExtent.width;
-		framebufferCreateInfo.height = swapchainExtent.height;
-		framebufferCreateInfo.layers = 1;
+	if (!pipelineLibrary->initialize(renderPass, textureDescriptorSetLayout, pipelineCache->handle(), threadPool)) {
+		return false;
+	}
 
-		if (vkCreateFramebuffer(device, &framebufferCreateInfo, nullptr, &swapchainFrameBuffers[i]) != VK_SUCCESS) {
-			spdlog::error("Failed to create framebuffer for index {}", i);
-			return false;
-		}
+	if (!createSwapchainResources()) {
+		return false;
 	}
 
 	VkCommandPoolCreateInfo commandPoolCreateInfo{};
@@ -749,122 +851,482 @@ bool Renderer::initialize(const window::Window& window) {
 		return false;
 	}
 
-	VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
-	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	commandBufferAllocateInfo.commandPool = commandPool;
-	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	commandBufferAllocateInfo.commandBufferCount = 1;
+	// Timestamps are written by the graphics queue, one query pool per frame in flight so results are read without stalling
+	gpuProfiler = std::make_unique<GpuProfiler>(device);
 
-	if (vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &commandBuffer) != VK_SUCCESS) {
-		spdlog::error("Failed to create command buffer");
+	if (!gpuProfiler->create(physicalDevice, queueFamilyIndices.graphics.value(), framesInFlight)) {
 		return false;
 	}
 
-	VkSemaphoreCreateInfo semaphoreInfo{};
-	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	// Every worker records tiles with command pools of its own
+	parallelRecorder = std::make_unique<ParallelRecorder>(device, threadPool);
 
-	if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphore) != VK_SUCCESS || vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphore) != VK_SUCCESS) {
-		spdlog::error("Failed to create semaphores");
+	if (!parallelRecorder->create(queueFamilyIndices.graphics.value(), framesInFlight)) {
 		return false;
 	}
 
-	VkFenceCreateInfo fenceInfo{};
-	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;	// Signaled upon creation so the first frame never waits for the fence that it should signal after the first frame renders
+	frames.resize(framesInFlight);
 
-	if (vkCreateFence(device, &fenceInfo, nullptr, &inFlightFence) != VK_SUCCESS) {
-		spdlog::error("Failed to create fence");
+	for (auto& frame : frames) {
+		if (!createFrameResources(frame)) {
+			return false;
+		}
+	}
+
+	// Quad instances are written straight into host visible memory, every frame in flight has its own region of the buffer
+	// The GPU may still be reading the region of the previous frame while the next frame is recorded
+	transientBuffer = std::make_unique<RingBuffer>(device, *memoryAllocator);
+
+	if (!transientBuffer->create(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, sizeof(QuadInstance) * MAX_QUAD_INSTANCE_COUNT, framesInFlight)) {
+		spdlog::error("Failed to create instance buffer");
 		return false;
 	}
 
-	spdlog::debug("Renderer initialised");
-	return true;
-}
+	textSystem = std::make_unique<text::TextSystem>(device, *memoryAllocator);
 
-void Renderer::render() const {
-	// Wait for previous frame to finish
-	vkWaitForFences(device, 1, &inFlightFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
-	vkResetFences(device, 1, &inFlightFence);
+	if (!textSystem->initialize(framesInFlight)) {
+		spdlog::error("Failed to initialize the text system");
+		return false;
+	}
 
-	// Acquire an image from the swapchain
-	std::uint32_t swapchainImageIndex;
-	vkAcquireNextImageKHR(device, swapchain, std::numeric_limits<std::uint64_t>::max(), imageAvailableSemaphore, VK_NULL_HANDLE, &swapchainImageIndex);
+	glyphAtlasTexture = registerTexture(textSystem->getAtlasImageView());
 
-	VkCommandBufferBeginInfo beginInfo{};
-	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	if (glyphAtlasTexture == NO_TEXTURE) {
+		return false;
+	}
 
-	VkClearValue clearColor{ 0.3921568f, 0.5843137f, 0.9294117f, 1.0f };
+	// Tiles share the swapchain format, which keeps their render pass compatible with the pipelines created above
+	// The budget covers the viewport a few times over, so scrolling back and forth does not immediately re-rasterize
+	const auto visibleTileCount = (swapchainExtent.width / TILE_SIZE + 2) * (swapchainExtent.height / TILE_SIZE + 2);
+	tileCache = std::make_unique<TileCache>(device, *memoryAllocator);
 
-	VkRenderPassBeginInfo renderPassInfo{};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = renderPass;
-	renderPassInfo.framebuffer = swapchainFrameBuffers[swapchainImageIndex];
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = swapchainExtent;
-	renderPassInfo.clearValueCount = 1;
-	renderPassInfo.pClearValues = &clearColor;
+	if (!tileCache->initialize(swapchainImageFormat, visibleTileCount * TILE_CACHE_VIEWPORT_MULTIPLIER)) {
+		return false;
+	}
 
-	VkViewport viewport{};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = static_cast<float>(swapchainExtent.width);
-	viewport.height = static_cast<float>(swapchainExtent.height);
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
+	// Nobody watches the first frames of a headless run, its output should not depend on how quickly the pipelines were built
+	if (window == nullptr && !pipelineLibrary->wait()) {
+		spdlog::error("Failed to build the graphics pipelines");
+		return false;
+	}
 
-	VkRect2D scissor{};
-	scissor.offset = { 0, 0 };
-	scissor.extent = swapchainExtent;
+	spdlog::debug("Renderer initialised with {} frame{} in flight", framesInFlight, framesInFlight != 1 ? "s" : "");
+	return true;
+}
 
-	// Start recording rendering commands
-	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
-		spdlog::error("Failed to begin recording into the command buffer");
+void Renderer::render() {
+	PLAIN_TRACE_SCOPE("Renderer::render");
+
+	// Nothing on screen would change, keep showing the last presented image
+	if (!needsComposite) {
 		return;
 	}
 
-	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
-	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-	vkCmdDraw(commandBuffer, 3, 1, 0, 0);
-	vkCmdEndRenderPass(commandBuffer);
+	// Switching between low latency and power saving presentation takes a new swapchain
+	if (!isHeadless() && framePacer.shouldChangePresentMode(swapchainPresentMode)) {
+		isSwapchainOutdated = true;
+	}
 
-	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
-		spdlog::error("Failed to end recording into the command buffer");
+	if (isSwapchainOutdated && !recreateSwapchain()) {
 		return;
 	}
 
-	// Submit the commands to the GPU
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+	// Only wait for the frame that last used this slot, the frames recorded after it may still be executing
+	const auto& frame = frames[currentFrame];
+	const auto& commandBuffer = frame.commandBuffer;
 
-	VkSubmitInfo submitInfo{};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = &imageAvailableSemaphore;
-	submitInfo.pWaitDstStageMask = waitStages;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &commandBuffer;
-	submitInfo.signalSemaphoreCount = 1;
-	submitInfo.pSignalSemaphores = &renderFinishedSemaphore;
+	const auto isGpuBehind = vkGetFenceStatus(device, frame.inFlightFence) == VK_NOT_READY;
 
-	// Signals the fence so the CPU will block at the start of this method until the GPU has finished execution
-	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFence) != VK_SUCCESS) {
-		spdlog::error("Failed to submit queue");
+	vkWaitForFences(device, 1, &frame.inFlightFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	framePacer.retireFrame(currentFrame, isGpuBehind);
+
+	// The region is as large as the instance limit, so taking all of it always succeeds
+	// Taken before an image is acquired, failing afterwards would leave the image acquired without ever presenting it
+	transientBuffer->beginFrame(currentFrame);
+
+	const auto instanceAllocation = transientBuffer->allocate(sizeof(QuadInstance) * MAX_QUAD_INSTANCE_COUNT, alignof(QuadInstance));
+
+	if (!instanceAllocation.has_value()) {
+		spdlog::error("Failed to allocate quad instances for the frame");
 		return;
 	}
 
-	// Present the image to the screen
-	VkPresentInfoKHR presentInfo{};
-	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
-	presentInfo.swapchainCount = 1;
-	presentInfo.pSwapchains = &swapchain;
+	// Acquire an image from the swapchain, offscreen images belong to a frame slot and are free once its fence is signaled
+	// A swapchain that is out of date skips the frame before the glyph atlas, uploads, or tiles are touched
+	std::uint32_t swapchainImageIndex = currentFrame;
+
+	if (!isHeadless()) {
+		const auto acquireResult = vkAcquireNextImageKHR(device, swapchain, std::numeric_limits<std::uint64_t>::max(), frame.imageAvailableSemaphore, VK_NULL_HANDLE, &swapchainImageIndex);
+
+		if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+			// Nothing was acquired or submitted, the fence stays signaled and the frame is drawn again after recreation
+			isSwapchainOutdated = true;
+			return;
+		}
+
+		if (acquireResult == VK_SUBOPTIMAL_KHR) {
+			// The image was acquired and its semaphore will be signaled, present it and recreate the swapchain afterwards
+			isSwapchainOutdated = true;
+		} else if (acquireResult != VK_SUCCESS) {
+			spdlog::error("Failed to acquire a swapchain image");
+			return;
+		}
+	}
+
+	framePacer.beginFrame();
+
+	auto* const instanceData = reinterpret_cast<QuadInstance*>(instanceAllocation->data);
+
+	textSystem->beginFrame();
+	++frameIndex;
+
+	// Stream the next part of pending uploads, images whose last rows are part of it can be sampled this frame
+	streamingUploader->submit();
+
+	// Checked before any pipeline is looked up, once no job is running every pipeline that is missing failed to build and is not waited for
+	const auto isBuildingPipelines = pipelineLibrary->isBuilding();
+
+	// Find the tiles that cover the viewport, only those with outdated contents are rasterized again
+	constexpr auto tileSize = static_cast<float>(TILE_SIZE);
+
+	const auto firstColumn = static_cast<std::int32_t>(std::floor(scrollX / tileSize));
+	const auto lastColumn = static_cast<std::int32_t>(std::floor((scrollX + static_cast<float>(swapchainExtent.width) - 1.0f) / tileSize));
+	const auto firstRow = static_cast<std::int32_t>(std::floor(scrollY / tileSize));
+	const auto lastRow = static_cast<std::int32_t>(std::floor((scrollY + static_cast<float>(swapchainExtent.height) - 1.0f) / tileSize));
+
+	const auto viewportTileCount = static_cast<std::size_t>(lastColumn - firstColumn + 1) * static_cast<std::size_t>(lastRow - firstRow + 1);
+
+	std::size_t instanceCount = 0;
+	std::size_t missingTileCount = 0;
+	std::size_t delayedTileCount = 0;
+	visibleTiles.clear();
+	tileRasters.clear();
+	tileBatches.clear();
+
+	for (auto row = firstRow; row <= lastRow; ++row) {
+		for (auto column = firstColumn; column <= lastColumn; ++column) {
+			auto* tile = tileCache->acquire(column, row, frameIndex);
+
+			if (tile == nullptr) {
+				++missingTileCount;
+				continue;
+			}
+
+			if (tile->texture == NO_TEXTURE) {
+				tile->texture = registerTexture(tile->imageView);
+
+				if (tile->texture == NO_TEXTURE) {
+					++missingTileCount;
+					continue;
+				}
+			}
+
+			if (tile->isValid) {
+				visibleTiles.push_back(tile);
+				continue;
+			}
+
+			// Convert only the items that touch this tile, which also rasterizes any glyphs that are not in the atlas yet
+			quadBatcher.build(displayList, *textSystem, glyphAtlasTexture, tile->getBounds(), displayListIndex.get());
+
+			const auto instances = quadBatcher.getInstances();
+
+			// Leave the tile outdated when it does not fit (the composite needs room too), it is picked up again next frame
+			// Its image may hold nothing yet or the contents of another grid position, so it is not composited either
+			if (instanceCount + instances.size() + viewportTileCount > MAX_QUAD_INSTANCE_COUNT) {
+				spdlog::warn("Too many quads to rasterize all tiles this frame, the remaining tiles are delayed");
+				++delayedTileCount;
+				continue;
+			}
+
+			std::memcpy(instanceData + instanceCount, instances.data(), instances.size() * sizeof(QuadInstance));
+
+			// Images that are still being uploaded cannot be sampled yet, their quads are hidden until the tile is rasterized again
+			const auto textures = quadBatcher.getTextures();
+			const auto areTexturesReady = std::all_of(textures.begin(), textures.end(), [this](const TextureId texture) { return isTextureReady(texture); });
+
+			if (!areTexturesReady) {
+				for (auto i = instanceCount; i < instanceCount + instances.size(); ++i) {
+					auto& instance = instanceData[i];
+
+					// The glyph atlas is always resident, sampling it with no color leaves the tile unchanged
+					if (!isTextureReady(instance.texture)) {
+						instance.texture = glyphAtlasTexture;
+						std::fill(std::begin(instance.color), std::end(instance.color), 0.0f);
+					}
+				}
+			}
+
+			// Batches without a pipeline are skipped, the tile is rasterized again once every pipeline and texture is ready
+			const auto isComplete = areTexturesReady && std::all_of(quadBatcher.getBatches().begin(), quadBatcher.getBatches().end(), [this, isBuildingPipelines](const DrawBatch& batch) {
+				return !isBuildingPipelines || pipelineLibrary->isReady(batch.pipeline);
+			});
+
+			visibleTiles.push_back(tile);
+			tileRasters.push_back({ tile, static_cast<std::uint32_t>(tileBatches.size()), static_cast<std::uint32_t>(quadBatcher.getBatches().size()), isComplete });
+
+			for (auto batch : quadBatcher.getBatches()) {
+				batch.firstInstance += static_cast<std::uint32_t>(instanceCount);
+				tileBatches.push_back(batch);
+			}
+
+			instanceCount += instances.size();
+		}
+	}
+
+	// A shortage does not go away by drawing again, so it is reported once and does not keep the next frame coming
+	if (missingTileCount > 0 && !isTileShortageReported) {
+		spdlog::warn("{} of {} tiles in the viewport could not be allocated, parts of the page are not drawn", missingTileCount, viewportTileCount);
+	}
+
+	isTileShortageReported = missingTileCount > 0;
+
+	// Every visible tile is composited as a single textured quad, positioned in page coordinates
+	// Tiles hold premultiplied colors, so the opacity of the page scales all four channels
+	const auto firstTileInstance = static_cast<std::uint32_t>(instanceCount);
+
+	for (const auto* tile : visibleTiles) {
+		const auto bounds = tile->getBounds();
+		instanceData[instanceCount++] = { { bounds.x, bounds.y, bounds.width, bounds.height }, { 0.0f, 0.0f, 1.0f, 1.0f }, { pageOpacity, pageOpacity, pageOpacity, pageOpacity }, tile->texture };
+	}
+
+	// The profiler overlay is drawn on top of the tiles in window coordinates, it is left out when the frame has no room for it
+	overlayBatches.clear();
+
+	if (profilerOverlayFont.has_value()) {
+		buildProfilerOverlay(profilerOverlayFont.value());
+		quadBatcher.build(profilerOverlay, *textSystem, glyphAtlasTexture);
+
+		const auto instances = quadBatcher.getInstances();
+
+		if (instanceCount + instances.size() <= MAX_QUAD_INSTANCE_COUNT) {
+			std::memcpy(instanceData + instanceCount, instances.data(), instances.size() * sizeof(QuadInstance));
+
+			for (auto batch : quadBatcher.getBatches()) {
+				batch.firstInstance += static_cast<std::uint32_t>(instanceCount);
+				overlayBatches.push_back(batch);
+			}
+
+			instanceCount += instances.size();
+		}
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+	// Start recording rendering commands
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+		spdlog::error("Failed to begin recording into the command buffer");
+		abandonFrame();
+		return;
+	}
+
+	// The fence of this slot was waited for, so the timestamps it recorded last time are available
+	gpuProfiler->beginFrame(commandBuffer, currentFrame);
+	gpuProfiler->beginPass(commandBuffer, "Frame");
+
+	// Glyphs rasterized since the previous frame are uploaded in one batch, before anything samples the atlas
+	gpuProfiler->beginPass(commandBuffer, "Uploads");
+	textSystem->recordUploads(commandBuffer, currentFrame);
+
+	// Take ownership of streamed images that finished uploading, the submission waits for their copies
+	const auto uploadWaitValue = streamingUploader->recordAcquires(commandBuffer);
+	gpuProfiler->endPass(commandBuffer);
+
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, &transientBuffer->getBuffer(), &instanceAllocation->offset);
+
+	// Rasterize outdated tiles into their textures
+	VkClearValue tileClearColor{ 0.0f, 0.0f, 0.0f, 0.0f };
+	VkRect2D tileScissor{ { 0, 0 }, { TILE_SIZE, TILE_SIZE } };
+
+	gpuProfiler->beginPass(commandBuffer, "Tiles");
+
+	// Complex pages spread the draw calls of their tiles over the workers, every tile is recorded into a secondary command buffer of its own
+	// Secondary buffers inherit no state from the primary buffer, so each binds the instances itself
+	const auto isRecordingInParallel = tileRasters.size() > 1
+		&& tileBatches.size() >= PARALLEL_RECORDING_BATCH_COUNT
+		&& parallelRecorder->getChunkCount() > 1
+		&& parallelRecorder->record(currentFrame, static_cast<std::uint32_t>(tileRasters.size()), tileCache->getRenderPass(), [this, &instanceAllocation](const std::uint32_t item, const VkCommandBuffer& tileCommandBuffer) {
+			vkCmdBindVertexBuffers(tileCommandBuffer, 0, 1, &transientBuffer->getBuffer(), &instanceAllocation->offset);
+			recordTile(tileCommandBuffer, tileRasters[item]);
+		}, tileCommandBuffers);
+
+	for (std::size_t i = 0; i < tileRasters.size(); ++i) {
+		VkRenderPassBeginInfo tileRenderPassInfo{};
+		tileRenderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		tileRenderPassInfo.renderPass = tileCache->getRenderPass();
+		tileRenderPassInfo.framebuffer = tileRasters[i].tile->framebuffer;
+		tileRenderPassInfo.renderArea = tileScissor;
+		tileRenderPassInfo.clearValueCount = 1;
+		tileRenderPassInfo.pClearValues = &tileClearColor;
+
+		if (isRecordingInParallel) {
+			vkCmdBeginRenderPass(commandBuffer, &tileRenderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+			vkCmdExecuteCommands(commandBuffer, 1, &tileCommandBuffers[i]);
+		} else {
+			vkCmdBeginRenderPass(commandBuffer, &tileRenderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+			recordTile(commandBuffer, tileRasters[i]);
+		}
+
+		vkCmdEndRenderPass(commandBuffer);
+	}
+
+	gpuProfiler->endPass(commandBuffer);
+
+	// Composite the tiles into the swapchain image, scrolling only moves the tiles
+	VkClearValue clearColor{ 0.3921568f, 0.5843137f, 0.9294117f, 1.0f };
+
+	VkRenderPassBeginInfo renderPassInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = renderPass;
+	renderPassInfo.framebuffer = swapchainFrameBuffers[swapchainImageIndex];
+	renderPassInfo.renderArea.offset = { 0, 0 };
+	renderPassInfo.renderArea.extent = swapchainExtent;
+	renderPassInfo.clearValueCount = 1;
+	renderPassInfo.pClearValues = &clearColor;
+
+	VkViewport viewport{};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(swapchainExtent.width);
+	viewport.height = static_cast<float>(swapchainExtent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+
+	VkRect2D scissor{};
+	scissor.offset = { 0, 0 };
+	scissor.extent = swapchainExtent;
+
+	const QuadPushConstants pushConstants{ pageTransform, { viewport.width, viewport.height }, { scrollX, scrollY } };
+
+	gpuProfiler->beginPass(commandBuffer, "Composite");
+
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+	vkCmdPushConstants(commandBuffer, pipelineLibrary->getLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants), &pushConstants);
+
+	// Until the image pipeline is ready, the frame only shows the background
+	const auto compositePipeline = pipelineLibrary->get(PipelineType::Image);
+
+	// Every tile selects its own texture, so all of them are composited with a single draw call
+	if (compositePipeline != VK_NULL_HANDLE && !visibleTiles.empty()) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, compositePipeline);
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLibrary->getLayout(), 0, 1, &textureDescriptorSet, 0, nullptr);
+		vkCmdDraw(commandBuffer, 6, static_cast<std::uint32_t>(visibleTiles.size()), 0, firstTileInstance);
+	}
+
+	if (!overlayBatches.empty()) {
+		const QuadPushConstants overlayPushConstants{ IDENTITY_TRANSFORM, { viewport.width, viewport.height }, { 0.0f, 0.0f } };
+
+		vkCmdPushConstants(commandBuffer, pipelineLibrary->getLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(overlayPushConstants), &overlayPushConstants);
+		recordBatches(commandBuffer, overlayBatches);
+	}
+
+	vkCmdEndRenderPass(commandBuffer);
+
+	gpuProfiler->endPass(commandBuffer);
+	gpuProfiler->endPass(commandBuffer);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to end recording into the command buffer");
+		abandonFrame();
+		return;
+	}
+
+	// Wait for the swapchain image before writing to it, and for streamed uploads before sampling them
+	std::array<VkSemaphore, 2> waitSemaphores{};
+	std::array<VkPipelineStageFlags, 2> waitStages{};
+	std::array<std::uint64_t, 2> waitValues{};
+	std::uint32_t waitSemaphoreCount = 0;
+
+	if (!isHeadless()) {
+		waitSemaphores[waitSemaphoreCount] = frame.imageAvailableSemaphore;
+		waitStages[waitSemaphoreCount] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		++waitSemaphoreCount;
+	}
+
+	if (uploadWaitValue != 0) {
+		waitSemaphores[waitSemaphoreCount] = streamingUploader->getSemaphore();
+		waitStages[waitSemaphoreCount] = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		waitValues[waitSemaphoreCount] = uploadWaitValue;
+		++waitSemaphoreCount;
+	}
+
+	// Values of binary semaphores are ignored
+	VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+	timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineSubmitInfo.waitSemaphoreValueCount = waitSemaphoreCount;
+	timelineSubmitInfo.pWaitSemaphoreValues = waitValues.data();
+
+	// Submit the commands to the GPU
+	const auto& renderFinishedSemaphore = renderFinishedSemaphores[swapchainImageIndex];
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineSubmitInfo;
+	submitInfo.waitSemaphoreCount = waitSemaphoreCount;
+	submitInfo.pWaitSemaphores = waitSemaphores.data();
+	submitInfo.pWaitDstStageMask = waitStages.data();
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	submitInfo.signalSemaphoreCount = isHeadless() ? 0 : 1;
+	submitInfo.pSignalSemaphores = &renderFinishedSemaphore;
+
+	// A fence has to be unsignaled to be passed to a submission, abandonFrame() has it signaled again when the submission fails
+	vkResetFences(device, 1, &frame.inFlightFence);
+
+	// Signals the fence so the CPU will block once this slot comes around again until the GPU has finished execution
+	if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, frame.inFlightFence) != VK_SUCCESS) {
+		spdlog::error("Failed to submit queue");
+		abandonFrame();
+		return;
+	}
+
+	// The acquires recorded into this frame are part of a submission now, a frame that failed before records them again next time
+	streamingUploader->commitAcquires();
+
+	// Rasterized tiles only hold their contents once the frame was submitted, a frame that failed before leaves them outdated
+	for (const auto& tileRaster : tileRasters) {
+		tileRaster.tile->isValid = tileRaster.isComplete;
+	}
+
+	// Tiles that were delayed or drawn without all of their textures, or pipelines that are still being built, keep the next frame coming
+	needsComposite = std::any_of(visibleTiles.begin(), visibleTiles.end(), [](const Tile* tile) { return !tile->isValid; })
+		|| delayedTileCount > 0
+		|| (isBuildingPipelines && compositePipeline == VK_NULL_HANDLE)
+		|| streamingUploader->hasPendingUploads();
+
+	framePacer.endFrame(currentFrame);
+
+	lastRenderedImage = swapchainImageIndex;
+
+	if (isHeadless()) {
+		currentFrame = (currentFrame + 1) % framesInFlight;
+		return;
+	}
+
+	// Present the image to the screen
+	VkPresentInfoKHR presentInfo{};
+	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+	presentInfo.waitSemaphoreCount = 1;
+	presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
+	presentInfo.swapchainCount = 1;
+	presentInfo.pSwapchains = &swapchain;
 	presentInfo.pImageIndices = &swapchainImageIndex;
 
-	if (vkQueuePresentKHR(presentQueue, &presentInfo) != VK_SUCCESS) {
+	const auto presentResult = vkQueuePresentKHR(presentQueue, &presentInfo);
+	framePacer.present();
+
+	if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
+		// Draw the next frame into a swapchain of the right size, even when nothing else changes
+		isSwapchainOutdated = true;
+		needsComposite = true;
+	} else if (presentResult != VK_SUCCESS) {
 		spdlog::error("Failed to present");
 	}
+
+	currentFrame = (currentFrame + 1) % framesInFlight;
 }
 
 void Renderer::destroy() {
@@ -891,28 +1353,87 @@ void Renderer::destroy() {
 	}
 #endif
 
-	vkDestroyFence(device, inFlightFence, nullptr);
+	if (textSystem) {
+		textSystem->destroy();
+		textSystem.reset();
+	}
+
+	if (tileCache) {
+		tileCache->destroy();
+		tileCache.reset();
+	}
+
+	if (transientBuffer) {
+		transientBuffer->destroy();
+		transientBuffer.reset();
+	}
+
+	for (auto& textureImage : textureImages) {
+		vkDestroyImageView(device, textureImage.imageView, nullptr);
+		vkDestroyImage(device, textureImage.image, nullptr);
+		memoryAllocator->free(textureImage.allocation);
+	}
+
+	textureImages.clear();
+
+	if (streamingUploader) {
+		streamingUploader->destroy();
+		streamingUploader.reset();
+	}
+
+	for (auto& frame : frames) {
+		vkDestroyFence(device, frame.inFlightFence, nullptr);
+		vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+	}
+
+	frames.clear();
+
+	if (gpuProfiler) {
+		gpuProfiler->destroy();
+		gpuProfiler.reset();
+	}
 
-	vkDestroySemaphore(device, imageAvailableSemaphore, nullptr);
-	vkDestroySemaphore(device, renderFinishedSemaphore, nullptr);
+	if (parallelRecorder) {
+		parallelRecorder->destroy();
+		parallelRecorder.reset();
+	}
 
 	vkDestroyCommandPool(device, commandPool, nullptr);
+	destroySwapchainResources();
 
-	for (const auto& framebuffer : swapchainFrameBuffers) {
-		vkDestroyFramebuffer(device, framebuffer, nullptr);
+	// Waits for pipelines that are still being built, they use the pipeline cache
+	if (pipelineLibrary) {
+		pipelineLibrary->destroy();
+		pipelineLibrary.reset();
 	}
 
-	swapchainFrameBuffers.clear();
+	if (pipelineCache) {
+		pipelineCache->save();
+		pipelineCache->destroy();
+		pipelineCache.reset();
+	}
 
-	vkDestroyPipeline(device, graphicsPipeline, nullptr);
-	vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+	vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(device, textureDescriptorSetLayout, nullptr);
+	vkDestroySampler(device, textureSampler, nullptr);
+
+	// Freed along with its pool
+	textureDescriptorSet = VK_NULL_HANDLE;
 	vkDestroyRenderPass(device, renderPass, nullptr);
 
-	for (const auto& swapchainImageView : swapchainImageViews) {
-		vkDestroyImageView(device, swapchainImageView, nullptr);
+	// Swapchain images are owned by the swapchain, only offscreen images have to be destroyed manually
+	if (isHeadless()) {
+		destroyOffscreenImages();
 	}
 
-	swapchainImageViews.clear();
+	swapchainImages.clear();
+
+	// Whatever is still allocated at this point has leaked, which the statistics make visible
+	if (memoryAllocator) {
+		memoryAllocator->logStatistics();
+		memoryAllocator->destroy();
+		memoryAllocator.reset();
+	}
 
 	vkDestroySwapchainKHR(device, swapchain, nullptr);
 	vkDestroyDevice(device, nullptr);
@@ -920,3 +1441,748 @@ void Renderer::destroy() {
 	vkDestroyInstance(instance, nullptr);
 	spdlog::debug("Renderer destroyed");
 }
+
+graphics::text::TextSystem& Renderer::getTextSystem() {
+	return *textSystem;
+}
+
+TextureId Renderer::registerTexture(const VkImageView& imageView) {
+	if (textureUploads.size() >= MAX_TEXTURE_COUNT) {
+		spdlog::error("Unable to register a texture, the maximum of {} textures has been reached", MAX_TEXTURE_COUNT);
+		return NO_TEXTURE;
+	}
+
+	textureUploads.push_back(NO_UPLOAD);
+
+	const auto texture = static_cast<TextureId>(textureUploads.size() - 1);
+	writeTextureDescriptor(texture, imageView);
+
+	return texture;
+}
+
+TextureId Renderer::createTexture(const std::uint32_t width, const std::uint32_t height, std::vector<std::uint8_t> pixels) {
+	constexpr std::uint32_t bytesPerPixel = 4;
+
+	if (width == 0 || height == 0 || pixels.size() != static_cast<std::size_t>(width) * height * bytesPerPixel) {
+		spdlog::error("Unable to create a {}x{} texture from {} bytes of pixels", width, height, pixels.size());
+		return NO_TEXTURE;
+	}
+
+	TextureImage textureImage{};
+
+	VkImageCreateInfo imageCreateInfo{};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.format = TEXTURE_FORMAT;
+	imageCreateInfo.extent = { width, height, 1 };
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	if (vkCreateImage(device, &imageCreateInfo, nullptr, &textureImage.image) != VK_SUCCESS) {
+		spdlog::error("Failed to create texture image");
+		return NO_TEXTURE;
+	}
+
+	const auto imageAllocation = memoryAllocator->allocateImage(textureImage.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	if (!imageAllocation.has_value()) {
+		spdlog::error("Failed to allocate texture image memory");
+		vkDestroyImage(device, textureImage.image, nullptr);
+		return NO_TEXTURE;
+	}
+
+	textureImage.allocation = imageAllocation.value();
+
+	VkImageViewCreateInfo imageViewCreateInfo{};
+	imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	imageViewCreateInfo.image = textureImage.image;
+	imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	imageViewCreateInfo.format = TEXTURE_FORMAT;
+	imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageViewCreateInfo.subresourceRange.levelCount = 1;
+	imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+	const auto texture = vkCreateImageView(device, &imageViewCreateInfo, nullptr, &textureImage.imageView) == VK_SUCCESS ? registerTexture(textureImage.imageView) : NO_TEXTURE;
+
+	if (texture == NO_TEXTURE) {
+		spdlog::error("Failed to create a view or descriptor set for the texture");
+		vkDestroyImageView(device, textureImage.imageView, nullptr);
+		vkDestroyImage(device, textureImage.image, nullptr);
+		memoryAllocator->free(textureImage.allocation);
+		return NO_TEXTURE;
+	}
+
+	textureUploads[texture] = streamingUploader->uploadImage(textureImage.image, width, height, bytesPerPixel, std::move(pixels));
+	textureImages.push_back(textureImage);
+
+	return texture;
+}
+
+void Renderer::setDisplayList(DisplayList newDisplayList) {
+	damage.clear();
+	computeDamage(displayList, newDisplayList, damage);
+
+	if (tileCache) {
+		for (const auto& area : damage) {
+			tileCache->invalidate(area);
+		}
+	}
+
+	needsComposite = needsComposite || !damage.empty();
+	displayList = std::move(newDisplayList);
+
+	// Cells are as large as tiles, so a tile finds its items in a single cell
+	std::vector<core::spatial::Bounds> paintBounds;
+	paintBounds.reserve(displayList.getItems().size());
+
+	for (const auto& item : displayList.getItems()) {
+		const auto bounds = getPaintBounds(item);
+		paintBounds.push_back({ bounds.x, bounds.y, bounds.width, bounds.height });
+	}
+
+	displayListIndex = displayListIndexBuilder->update(paintBounds);
+}
+
+void Renderer::setScrollOffset(const float x, const float y) {
+	// Whole pixels only, so cached tiles are never resampled in between texels
+	const auto newScrollX = std::max(0.0f, std::round(x));
+	const auto newScrollY = std::max(0.0f, std::round(y));
+
+	needsComposite = needsComposite || newScrollX != scrollX || newScrollY != scrollY;
+	scrollX = newScrollX;
+	scrollY = newScrollY;
+}
+
+void Renderer::setPageLayer(const std::array<float, 16>& transform, const float opacity) {
+	const auto newOpacity = std::clamp(opacity, 0.0f, 1.0f);
+
+	needsComposite = needsComposite || transform != pageTransform || newOpacity != pageOpacity;
+	pageTransform = transform;
+	pageOpacity = newOpacity;
+}
+
+void Renderer::resize() {
+	if (isHeadless()) {
+		return;
+	}
+
+	isSwapchainOutdated = true;
+	needsComposite = true;
+}
+
+void Renderer::setPacingPolicy(const PacingPolicy policy) {
+	framePacer.setPolicy(policy);
+}
+
+void Renderer::notifyInput() {
+	framePacer.notifyInput();
+}
+
+FramePacer::Clock::duration Renderer::getTimeUntilNextFrame() const {
+	return framePacer.getTimeUntilNextFrame();
+}
+
+FrameStatistics Renderer::getFrameStatistics() const {
+	return framePacer.getStatistics();
+}
+
+void Renderer::setProfilerOverlay(const std::optional<text::FontId> font) {
+	profilerOverlayFont = font;
+	needsComposite = true;
+}
+
+std::span<const PassTiming> Renderer::getGpuTimings() const {
+	return gpuProfiler->getTimings();
+}
+
+bool Renderer::needsRedraw() const {
+	// A minimized window has nothing to draw to, the next resize brings the frame back once it is restored
+	if (isSwapchainOutdated && (targetWindow->getWidth() == 0 || targetWindow->getHeight() == 0)) {
+		return false;
+	}
+
+	return needsComposite;
+}
+
+void Renderer::invalidate() {
+	if (tileCache) {
+		tileCache->invalidateAll();
+	}
+
+	needsComposite = true;
+}
+
+bool Renderer::isHeadless() const {
+	return surface == VK_NULL_HANDLE;
+}
+
+bool Renderer::saveFrame(const std::string_view& path) {
+	if (!isHeadless()) {
+		spdlog::error("Frames can only be saved when rendering headless");
+		return false;
+	}
+
+	if (!lastRenderedImage.has_value()) {
+		spdlog::error("Unable to save a frame before anything has been rendered");
+		return false;
+	}
+
+	VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	commandBufferAllocateInfo.commandPool = commandPool;
+	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	commandBufferAllocateInfo.commandBufferCount = 1;
+
+	VkCommandBuffer readbackCommandBuffer{};
+
+	if (vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &readbackCommandBuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to create command buffer");
+		return false;
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	vkBeginCommandBuffer(readbackCommandBuffer, &beginInfo);
+
+	// The render pass left the image in the transfer source layout, the copy only has to wait for rendering to finish
+	VkMemoryBarrier renderBarrier{};
+	renderBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	renderBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	renderBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+	vkCmdPipelineBarrier(readbackCommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &renderBarrier, 0, nullptr, 0, nullptr);
+
+	VkBufferImageCopy region{};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent = { swapchainExtent.width, swapchainExtent.height, 1 };
+
+	vkCmdCopyImageToBuffer(readbackCommandBuffer, swapchainImages[lastRenderedImage.value()], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffer, 1, &region);
+
+	VkMemoryBarrier hostBarrier{};
+	hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+
+	vkCmdPipelineBarrier(readbackCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, nullptr, 0, nullptr);
+	vkEndCommandBuffer(readbackCommandBuffer);
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &readbackCommandBuffer;
+
+	// Saving a frame is rare enough that simply waiting for the queue is acceptable
+	const auto isSubmitted = vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) == VK_SUCCESS && vkQueueWaitIdle(graphicsQueue) == VK_SUCCESS;
+	vkFreeCommandBuffers(device, commandPool, 1, &readbackCommandBuffer);
+
+	if (!isSubmitted) {
+		spdlog::error("Failed to read back the rendered frame");
+		return false;
+	}
+
+	// Image files expect RGBA, offscreen images are stored as BGRA
+	std::vector<std::uint8_t> pixels(readbackData, readbackData + static_cast<std::size_t>(swapchainExtent.width) * swapchainExtent.height * 4);
+
+	for (std::size_t i = 0; i < pixels.size(); i += 4) {
+		std::swap(pixels[i], pixels[i + 2]);
+	}
+
+	return writeImage(path, swapchainExtent.width, swapchainExtent.height, pixels);
+}
+
+void Renderer::compactMemory() {
+	if (!memoryAllocator->isFragmented()) {
+		return;
+	}
+
+	// Tiles that are moved lose their contents, the GPU must not be using the old images while they are released
+	vkDeviceWaitIdle(device);
+
+	const auto movedTiles = tileCache->defragment();
+
+	// Texture identifiers stay the same, only the image their element of the texture array refers to changes
+	for (const auto* tile : movedTiles) {
+		if (tile->texture != NO_TEXTURE) {
+			writeTextureDescriptor(tile->texture, tile->imageView);
+		}
+	}
+
+	if (!movedTiles.empty()) {
+		needsComposite = true;
+	}
+
+	spdlog::debug("Moved {} tile{} out of sparsely used memory blocks", movedTiles.size(), movedTiles.size() != 1 ? "s" : "");
+	memoryAllocator->logStatistics();
+}
+
+MemoryStatistics Renderer::getMemoryStatistics() const {
+	return memoryAllocator->getStatistics();
+}
+
+bool Renderer::createOffscreenImages() {
+	swapchainImages.resize(framesInFlight);
+	offscreenImageAllocations.resize(framesInFlight);
+
+	for (std::uint32_t i = 0; i < framesInFlight; ++i) {
+		VkImageCreateInfo imageCreateInfo{};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = swapchainImageFormat;
+		imageCreateInfo.extent = { swapchainExtent.width, swapchainExtent.height, 1 };
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		if (vkCreateImage(device, &imageCreateInfo, nullptr, &swapchainImages[i]) != VK_SUCCESS) {
+			spdlog::error("Failed to create offscreen image");
+			destroyOffscreenImages();
+			return false;
+		}
+
+		const auto imageAllocation = memoryAllocator->allocateImage(swapchainImages[i], VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		if (!imageAllocation.has_value()) {
+			spdlog::error("Failed to allocate offscreen image memory");
+			destroyOffscreenImages();
+			return false;
+		}
+
+		offscreenImageAllocations[i] = imageAllocation.value();
+	}
+
+	// Rendered frames are copied into this buffer before they are written to disk
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size = static_cast<VkDeviceSize>(swapchainExtent.width) * swapchainExtent.height * 4;
+	bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(device, &bufferCreateInfo, nullptr, &readbackBuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to create readback buffer");
+		destroyOffscreenImages();
+		return false;
+	}
+
+	const auto bufferAllocation = memoryAllocator->allocateBuffer(readbackBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	if (!bufferAllocation.has_value()) {
+		spdlog::error("Failed to allocate readback buffer memory");
+		destroyOffscreenImages();
+		return false;
+	}
+
+	readbackAllocation = bufferAllocation.value();
+	readbackData = readbackAllocation.mappedData;
+
+	spdlog::debug("Created {} offscreen image{} ({}x{})", framesInFlight, framesInFlight != 1 ? "s" : "", swapchainExtent.width, swapchainExtent.height);
+	return true;
+}
+
+void Renderer::destroyOffscreenImages() {
+	for (auto& image : swapchainImages) {
+		vkDestroyImage(device, image, nullptr);
+		image = VK_NULL_HANDLE;
+	}
+
+	for (auto& allocation : offscreenImageAllocations) {
+		memoryAllocator->free(allocation);
+	}
+
+	offscreenImageAllocations.clear();
+
+	vkDestroyBuffer(device, readbackBuffer, nullptr);
+	readbackBuffer = VK_NULL_HANDLE;
+	readbackData = nullptr;
+
+	memoryAllocator->free(readbackAllocation);
+	readbackAllocation = {};
+}
+
+bool Renderer::createSwapchain(const VkSwapchainKHR& oldSwapchain) {
+	const auto swapchainSupport = querySwapchainSupport(physicalDevice, surface);
+	const auto swapchainSurfaceFormat = chooseSwapchainSurfaceFormat(swapchainSupport.formats);
+
+	// The render pass and every pipeline were created for the original format, which a surface is not expected to change
+	if (renderPass != VK_NULL_HANDLE && swapchainSurfaceFormat.format != swapchainImageFormat) {
+		spdlog::error("The surface format changed, the swapchain cannot be recreated");
+		return false;
+	}
+
+	swapchainImageFormat = swapchainSurfaceFormat.format;
+	swapchainExtent = chooseSwapchainExtent(swapchainSupport.capabilities, targetWindow->getWidth(), targetWindow->getHeight());
+	swapchainPresentMode = framePacer.choosePresentMode(swapchainSupport.presentModes);
+
+	std::uint32_t imageCount = swapchainSupport.capabilities.minImageCount + 1;
+
+	// A maximum of zero means there is no limit
+	if (swapchainSupport.capabilities.maxImageCount > 0) {
+		imageCount = std::min(imageCount, swapchainSupport.capabilities.maxImageCount);
+	}
+
+	VkSwapchainCreateInfoKHR swapchainCreateInfo{};
+	swapchainCreateInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+	swapchainCreateInfo.surface = surface;
+	swapchainCreateInfo.minImageCount = imageCount;
+	swapchainCreateInfo.imageFormat = swapchainSurfaceFormat.format;
+	swapchainCreateInfo.imageColorSpace = swapchainSurfaceFormat.colorSpace;
+	swapchainCreateInfo.imageExtent = swapchainExtent;
+	swapchainCreateInfo.imageArrayLayers = 1;
+	swapchainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	swapchainCreateInfo.preTransform = swapchainSupport.capabilities.currentTransform;
+	swapchainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	swapchainCreateInfo.presentMode = swapchainPresentMode;
+	swapchainCreateInfo.clipped = VK_TRUE;
+
+	// Lets the presentation engine hand over from the images that are still on screen instead of starting from scratch
+	swapchainCreateInfo.oldSwapchain = oldSwapchain;
+
+	const std::uint32_t indices[] = { graphicsQueueFamily, presentQueueFamily };
+
+	if (graphicsQueueFamily != presentQueueFamily) {
+		swapchainCreateInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+		swapchainCreateInfo.queueFamilyIndexCount = 2;
+		swapchainCreateInfo.pQueueFamilyIndices = indices;
+	} else {
+		// To keep things simple, if both queue families are identical, exclusive mode will be used to avoid having to deal with ownership
+		swapchainCreateInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	}
+
+	if (vkCreateSwapchainKHR(device, &swapchainCreateInfo, nullptr, &swapchain) != VK_SUCCESS) {
+		spdlog::error("Failed to create swapchain");
+		return false;
+	}
+
+	// Retrieve images that back the swapchain
+	std::uint32_t swapchainImageCount = 0;
+	vkGetSwapchainImagesKHR(device, swapchain, &swapchainImageCount, nullptr);
+
+	swapchainImages.resize(swapchainImageCount);
+	vkGetSwapchainImagesKHR(device, swapchain, &swapchainImageCount, swapchainImages.data());
+
+	spdlog::debug("Swapchain presents in {} mode", swapchainPresentMode == VK_PRESENT_MODE_MAILBOX_KHR ? "mailbox" : "FIFO");
+	return true;
+}
+
+bool Renderer::createSwapchainResources() {
+	swapchainImageViews.resize(swapchainImages.size());
+
+	for (std::size_t i = 0; i < swapchainImageViews.size(); ++i) {
+		VkImageViewCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		createInfo.image = swapchainImages[i];
+		createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		createInfo.format = swapchainImageFormat;
+
+		createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		createInfo.subresourceRange.baseMipLevel = 0;
+		createInfo.subresourceRange.levelCount = 1;
+		createInfo.subresourceRange.baseArrayLayer = 0;
+		createInfo.subresourceRange.layerCount = 1;
+
+		createInfo.components = {
+			VK_COMPONENT_SWIZZLE_IDENTITY,
+			VK_COMPONENT_SWIZZLE_IDENTITY,
+			VK_COMPONENT_SWIZZLE_IDENTITY,
+			VK_COMPONENT_SWIZZLE_IDENTITY
+		};
+
+		if (vkCreateImageView(device, &createInfo, nullptr, &swapchainImageViews[i]) != VK_SUCCESS) {
+			spdlog::error("Failed to create image view for swapchain image");
+			return false;
+		}
+	}
+
+	swapchainFrameBuffers.resize(swapchainImageViews.size());
+
+	for (std::size_t i = 0; i < swapchainImageViews.size(); ++i) {
+		VkImageView attachments[] = { swapchainImageViews[i] };
+
+		VkFramebufferCreateInfo framebufferCreateInfo{};
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.renderPass = renderPass;
+		framebufferCreateInfo.attachmentCount = 1;
+		framebufferCreateInfo.pAttachments = attachments;
+		framebufferCreateInfo.width = swapchainExtent.width;
+		framebufferCreateInfo.height = swapchainExtent.height;
+		framebufferCreateInfo.layers = 1;
+
+		if (vkCreateFramebuffer(device, &framebufferCreateInfo, nullptr, &swapchainFrameBuffers[i]) != VK_SUCCESS) {
+			spdlog::error("Failed to create framebuffer for index {}", i);
+			return false;
+		}
+	}
+
+	// Presentation of an image has to finish before its semaphore can be signaled again, hence one per swapchain image
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	renderFinishedSemaphores.resize(swapchainImages.size());
+
+	for (auto& semaphore : renderFinishedSemaphores) {
+		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+			spdlog::error("Failed to create semaphores");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Renderer::destroySwapchainResources() {
+	for (const auto& semaphore : renderFinishedSemaphores) {
+		vkDestroySemaphore(device, semaphore, nullptr);
+	}
+
+	renderFinishedSemaphores.clear();
+
+	for (const auto& framebuffer : swapchainFrameBuffers) {
+		vkDestroyFramebuffer(device, framebuffer, nullptr);
+	}
+
+	swapchainFrameBuffers.clear();
+
+	for (const auto& swapchainImageView : swapchainImageViews) {
+		vkDestroyImageView(device, swapchainImageView, nullptr);
+	}
+
+	swapchainImageViews.clear();
+}
+
+bool Renderer::recreateSwapchain() {
+	// A minimized window has no area to present to, the swapchain stays outdated until it is restored
+	if (targetWindow->getWidth() == 0 || targetWindow->getHeight() == 0) {
+		return false;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	// Only the graphics and present queues use swapchain images, uploads on the transfer queue keep running
+	vkQueueWaitIdle(graphicsQueue);
+
+	if (presentQueue != graphicsQueue) {
+		vkQueueWaitIdle(presentQueue);
+	}
+
+	destroySwapchainResources();
+
+	const auto oldSwapchain = swapchain;
+	const auto isCreated = createSwapchain(oldSwapchain);
+
+	// Retired either way, the old swapchain can no longer present once it was passed to a new one
+	vkDestroySwapchainKHR(device, oldSwapchain, nullptr);
+
+	if (!isCreated) {
+		swapchain = VK_NULL_HANDLE;
+		return false;
+	}
+
+	if (!createSwapchainResources()) {
+		return false;
+	}
+
+	// Pipelines use dynamic viewport and scissor state, the tile cache only needs room for a larger viewport
+	const auto visibleTileCount = (swapchainExtent.width / TILE_SIZE + 2) * (swapchainExtent.height / TILE_SIZE + 2);
+	tileCache->grow(visibleTileCount * TILE_CACHE_VIEWPORT_MULTIPLIER);
+
+	isSwapchainOutdated = false;
+	lastRenderedImage.reset();
+	needsComposite = true;
+
+	const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	spdlog::debug("Swapchain recreated at {}x{} in {:.2f}ms", swapchainExtent.width, swapchainExtent.height, elapsed);
+
+	return true;
+}
+
+bool Renderer::createFrameResources(FrameResources& frame) {
+	VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	commandBufferAllocateInfo.commandPool = commandPool;
+	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	commandBufferAllocateInfo.commandBufferCount = 1;
+
+	if (vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &frame.commandBuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to create command buffer");
+		return false;
+	}
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS) {
+		spdlog::error("Failed to create semaphores");
+		return false;
+	}
+
+	VkFenceCreateInfo fenceInfo{};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;	// Signaled upon creation so the first frame never waits for the fence that it should signal after the first frame renders
+
+	if (vkCreateFence(device, &fenceInfo, nullptr, &frame.inFlightFence) != VK_SUCCESS) {
+		spdlog::error("Failed to create fence");
+		return false;
+	}
+
+	return true;
+}
+
+void Renderer::abandonFrame() {
+	auto& frame = frames[currentFrame];
+
+	// Nothing is going to signal a fence that was reset for a failed submission, the next wait on this slot would never return
+	const auto isFenceReset = vkGetFenceStatus(device, frame.inFlightFence) != VK_SUCCESS;
+	auto isSemaphorePending = !isHeadless();
+
+	// The acquire left a signal on the semaphore that no submission waits for, an empty batch consumes it (and signals the fence)
+	if (isSemaphorePending) {
+		const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.pWaitSemaphores = &frame.imageAvailableSemaphore;
+		submitInfo.pWaitDstStageMask = &waitStage;
+
+		isSemaphorePending = vkQueueSubmit(graphicsQueue, 1, &submitInfo, isFenceReset ? frame.inFlightFence : VK_NULL_HANDLE) != VK_SUCCESS;
+	}
+
+	// The queue is unable to take even an empty batch, replace the synchronization objects instead
+	if (isSemaphorePending) {
+		vkDeviceWaitIdle(device);
+		vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+		frame.imageAvailableSemaphore = VK_NULL_HANDLE;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS) {
+			spdlog::error("Failed to create semaphores");
+		}
+	}
+
+	if (isFenceReset && (isHeadless() || isSemaphorePending)) {
+		vkDestroyFence(device, frame.inFlightFence, nullptr);
+		frame.inFlightFence = VK_NULL_HANDLE;
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+		if (vkCreateFence(device, &fenceInfo, nullptr, &frame.inFlightFence) != VK_SUCCESS) {
+			spdlog::error("Failed to create fence");
+		}
+	}
+
+	// The acquired image is never presented, it is released along with the swapchain before the frame is drawn again
+	if (!isHeadless()) {
+		isSwapchainOutdated = true;
+	}
+
+	framePacer.cancelFrame();
+	needsComposite = true;
+}
+
+void Renderer::writeTextureDescriptor(const TextureId texture, const VkImageView& imageView) {
+	VkDescriptorImageInfo imageInfo{};
+	imageInfo.sampler = textureSampler;
+	imageInfo.imageView = imageView;
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = textureDescriptorSet;
+	write.dstBinding = 0;
+	write.dstArrayElement = texture;
+	write.descriptorCount = 1;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	write.pImageInfo = &imageInfo;
+
+	vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+void Renderer::recordBatches(const VkCommandBuffer& commandBuffer, const std::span<const DrawBatch> batches) {
+	if (batches.empty()) {
+		return;
+	}
+
+	// Every texture is in the same set, so it is bound once and batches only switch pipelines
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLibrary->getLayout(), 0, 1, &textureDescriptorSet, 0, nullptr);
+
+	std::optional<PipelineType> boundPipeline;
+
+	for (const auto& batch : batches) {
+		if (boundPipeline != batch.pipeline) {
+			const auto pipeline = pipelineLibrary->get(batch.pipeline);
+
+			if (pipeline == VK_NULL_HANDLE) {
+				continue;
+			}
+
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			boundPipeline = batch.pipeline;
+		}
+
+		// Six vertices per instance, which the vertex shader turns into two triangles
+		vkCmdDraw(commandBuffer, 6, batch.instanceCount, 0, batch.firstInstance);
+	}
+}
+
+void Renderer::recordTile(const VkCommandBuffer& commandBuffer, const TileRaster& tileRaster) {
+	constexpr auto tileSize = static_cast<float>(TILE_SIZE);
+
+	const VkViewport tileViewport{ 0.0f, 0.0f, tileSize, tileSize, 0.0f, 1.0f };
+	const VkRect2D tileScissor{ { 0, 0 }, { TILE_SIZE, TILE_SIZE } };
+
+	const auto bounds = tileRaster.tile->getBounds();
+	const QuadPushConstants pushConstants{ IDENTITY_TRANSFORM, { tileSize, tileSize }, { bounds.x, bounds.y } };
+
+	vkCmdSetViewport(commandBuffer, 0, 1, &tileViewport);
+	vkCmdSetScissor(commandBuffer, 0, 1, &tileScissor);
+	vkCmdPushConstants(commandBuffer, pipelineLibrary->getLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants), &pushConstants);
+	recordBatches(commandBuffer, std::span<const DrawBatch>(tileBatches).subspan(tileRaster.firstBatch, tileRaster.batchCount));
+}
+
+bool Renderer::isTextureReady(const TextureId texture) const {
+	return texture == NO_TEXTURE || streamingUploader->isComplete(textureUploads[texture]);
+}
+
+void Renderer::buildProfilerOverlay(const text::FontId font) {
+	const auto timings = gpuProfiler->getTimings();
+	const auto lineCount = std::max<std::size_t>(timings.size(), 1);
+
+	profilerOverlay.clear();
+	profilerOverlay.pushRectangle({
+		PROFILER_OVERLAY_MARGIN,
+		PROFILER_OVERLAY_MARGIN,
+		PROFILER_OVERLAY_WIDTH,
+		static_cast<float>(lineCount) * PROFILER_OVERLAY_LINE_HEIGHT + PROFILER_OVERLAY_PADDING * 2.0f
+	}, PROFILER_OVERLAY_BACKGROUND_COLOR);
+
+	const auto pushLine = [this, font](const std::size_t line, const std::string_view& text) {
+		const auto top = PROFILER_OVERLAY_MARGIN + PROFILER_OVERLAY_PADDING + static_cast<float>(line) * PROFILER_OVERLAY_LINE_HEIGHT;
+		const auto baseline = std::round(top + PROFILER_OVERLAY_LINE_HEIGHT * 0.75f);
+
+		profilerOverlay.pushGlyphRun({ PROFILER_OVERLAY_MARGIN + PROFILER_OVERLAY_PADDING, top, PROFILER_OVERLAY_WIDTH - PROFILER_OVERLAY_PADDING * 2.0f, PROFILER_OVERLAY_LINE_HEIGHT }, baseline, font, PROFILER_OVERLAY_FONT_SIZE, text, PROFILER_OVERLAY_TEXT_COLOR);
+	};
+
+	if (timings.empty()) {
+		pushLine(0, gpuProfiler->isEnabled() ? "GPU: waiting for timings" : "GPU: timestamps unsupported");
+		return;
+	}
+
+	for (std::size_t i = 0; i < timings.size(); ++i) {
+		pushLine(i, fmt::format("GPU {}: {:.3f} ms", timings[i].name, timings[i].milliseconds));
+	}
+}
@@ -0,0 +1,66 @@
+#include "graphics/renderer/ring_buffer.hpp"
+
+#include "spdlog/spdlog.h"
+
+using namespace graphics::renderer;
+
+RingBuffer::RingBuffer(const VkDevice& device, MemoryAllocator& allocator) :
+	device(device),
+	allocator(allocator),
+	buffer{},
+	allocation{},
+	regionSize{ 0 },
+	regionStart{ 0 },
+	head{ 0 } {}
+
+bool RingBuffer::create(const VkBufferUsageFlags usage, const VkDeviceSize bytesPerRegion, const std::uint32_t regionCount) {
+	regionSize = bytesPerRegion;
+
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size = regionSize * regionCount;
+	bufferCreateInfo.usage = usage;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(device, &bufferCreateInfo, nullptr, &buffer) != VK_SUCCESS) {
+		spdlog::error("Failed to create ring buffer");
+		return false;
+	}
+
+	const auto bufferAllocation = allocator.allocateBuffer(buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	if (!bufferAllocation.has_value()) {
+		spdlog::error("Failed to allocate ring buffer memory");
+		return false;
+	}
+
+	allocation = bufferAllocation.value();
+	return true;
+}
+
+void RingBuffer::beginFrame(const std::uint32_t region) {
+	regionStart = regionSize * region;
+	head = regionStart;
+}
+
+std::optional<TransientAllocation> RingBuffer::allocate(const VkDeviceSize size, const VkDeviceSize alignment) {
+	const auto offset = (head + alignment - 1) / alignment * alignment;
+
+	if (offset + size > regionStart + regionSize) {
+		return std::nullopt;
+	}
+
+	head = offset + size;
+	return TransientAllocation{ offset, allocation.mappedData + offset };
+}
+
+const VkBuffer& RingBuffer::getBuffer() const {
+	return buffer;
+}
+
+void RingBuffer::destroy() {
+	vkDestroyBuffer(device, buffer, nullptr);
+	buffer = VK_NULL_HANDLE;
+
+	allocator.free(allocation);
+}
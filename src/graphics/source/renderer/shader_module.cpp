@@ -1,28 +1,74 @@
 #include "graphics/renderer/shader_module.hpp"
 
+#include "core/profiling/trace.hpp"
+
 #include "spdlog/spdlog.h"
 
+#include <utility>
+
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
+#include "graphics/renderer/cache_file.hpp"
+
 #include "shaderc/shaderc.hpp"
 
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <ios>
 #include <map>
 #include <sstream>
-#include <utility>
+#include <string>
+#endif
 
 using namespace graphics::renderer;
 
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
 static const std::map<std::string_view, shaderc_shader_kind> FILE_EXTENSION_TO_SHADER_TYPE {
 	{ "vs", shaderc_vertex_shader },
 	{ "fs", shaderc_fragment_shader }
 };
 
+// First word of every SPIR-V module
+constexpr std::uint32_t SPIR_V_MAGIC_NUMBER = 0x0723'0203;
+
+// Bump whenever the way shaders are compiled changes in a way that is not captured by the compile options
+constexpr std::uint32_t SHADER_CACHE_VERSION = 2;
+
+#ifdef NDEBUG
+constexpr auto SHADER_OPTIMIZATION_LEVEL = shaderc_optimization_level_performance;
+#else
+constexpr auto SHADER_OPTIMIZATION_LEVEL = shaderc_optimization_level_zero;
+#endif
+
+// Identifies the compiled bytecode of a shader, any change to the source or to the way it is compiled results in a different key
+static std::uint64_t computeCacheKey(const std::string& sourceCode, const shaderc_shader_kind shaderType) {
+	std::uint32_t spirVVersion = 0;
+	std::uint32_t spirVRevision = 0;
+	shaderc_get_spv_version(&spirVVersion, &spirVRevision);
+
+	const std::uint32_t options[] = {
+		SHADER_CACHE_VERSION,
+		spirVVersion,
+		spirVRevision,
+		static_cast<std::uint32_t>(shaderType),
+		static_cast<std::uint32_t>(SHADER_OPTIMIZATION_LEVEL)
+	};
+
+	const auto optionsHash = hashBytes({ reinterpret_cast<const std::uint8_t*>(options), sizeof(options) });
+	return hashBytes({ reinterpret_cast<const std::uint8_t*>(sourceCode.data()), sourceCode.size() }, optionsHash);
+}
+#endif
+
 ShaderModule::ShaderModule(const VkDevice& device) :
 	device(device),
 	spirV{},
 	shaderModule(VK_NULL_HANDLE) {}
 
+ShaderModule::ShaderModule(const VkDevice& device, const std::span<const std::uint32_t> spirV) :
+	device(device),
+	spirV(spirV.begin(), spirV.end()),
+	shaderModule(VK_NULL_HANDLE) {}
+
 ShaderModule::ShaderModule(const ShaderModule& other):
 	device(other.device),
 	spirV(other.spirV),
@@ -32,29 +78,46 @@ ShaderModule::ShaderModule(const ShaderModule& other):
 ShaderModule::ShaderModule(ShaderModule&& other) noexcept:
 	device(other.device),
 	spirV(std::move(other.spirV)),
-	shaderModule(std::move(other.shaderModule))
+	shaderModule(std::exchange(other.shaderModule, VK_NULL_HANDLE))
 {}
 
 ShaderModule::~ShaderModule() {
 	vkDestroyShaderModule(device, shaderModule, nullptr);
 }
 
-bool ShaderModule::compileFromFile(const std::string_view path) {
+bool ShaderModule::create() {
+	if (shaderModule != VK_NULL_HANDLE) {
+		spdlog::error("Cannot create shader module because a shader module exists already - please only create one shader module per shader");
+		return false;
+	}
+
+	VkShaderModuleCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	createInfo.codeSize = spirV.size() * sizeof(std::uint32_t);
+	createInfo.pCode = spirV.data();
+
+	if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+		spdlog::error("Failed to create shader module");
+		return false;
+	}
+
+	return true;
+}
+
+const VkShaderModule& ShaderModule::handle() const {
+	return shaderModule;
+}
+
+#ifdef PLAIN_RUNTIME_SHADER_COMPILATION
+bool ShaderModule::compileFromFile(const std::string_view path, const std::string_view cacheDirectory) {
+	PLAIN_TRACE_SCOPE("ShaderModule::compileFromFile");
+
 	if (!std::filesystem::exists(path)) {
 		spdlog::error("Shader file not found: {}", path);
 		spdlog::debug("Current working directory: {}", std::filesystem::current_path().string());
 		return false;
 	}
 
-	shaderc::Compiler compiler {};
-	shaderc::CompileOptions compileOptions {};
-
-#ifdef NDEBUG
-	compileOptions.SetOptimizationLevel(shaderc_optimization_level_performance);
-#else
-	compileOptions.SetOptimizationLevel(shaderc_optimization_level_zero);
-#endif
-
 	auto shaderType = shaderc_glsl_infer_from_source;
 
 	const auto fileExtensionStartIndex = path.rfind('.');
@@ -78,7 +141,26 @@ bool ShaderModule::compileFromFile(const std::string_view path) {
 	std::stringstream sourceCode {};
 	sourceCode << inputFile.rdbuf();
 
-	const auto compileResult = compiler.CompileGlslToSpv(sourceCode.str(), shaderType, path.data(), compileOptions);
+	const auto source = sourceCode.str();
+	std::filesystem::path cachePath{};
+
+	if (!cacheDirectory.empty()) {
+		cachePath = std::filesystem::path(cacheDirectory) / fmt::format("{:016x}.spv", computeCacheKey(source, shaderType));
+
+		if (loadFromCache(cachePath)) {
+			spdlog::debug("Loaded compiled shader {} from cache", path);
+			return true;
+		}
+	}
+
+	shaderc::Compiler compiler {};
+	shaderc::CompileOptions compileOptions {};
+	compileOptions.SetOptimizationLevel(SHADER_OPTIMIZATION_LEVEL);
+
+	// Descriptor indexing is core in Vulkan 1.2, which the renderer requires
+	compileOptions.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+
+	const auto compileResult = compiler.CompileGlslToSpv(source, shaderType, path.data(), compileOptions);
 
 	if (compileResult.GetCompilationStatus() != shaderc_compilation_status_success) {
 		spdlog::error(compileResult.GetErrorMessage());
@@ -87,29 +169,36 @@ bool ShaderModule::compileFromFile(const std::string_view path) {
 
 	spirV = { compileResult.begin(), compileResult.end() };
 
+	// A failure to cache only makes the next start slower
+	if (!cachePath.empty()) {
+		writeCacheFile(cachePath, { reinterpret_cast<const std::uint8_t*>(spirV.data()), spirV.size() * sizeof(std::uint32_t) });
+	}
+
 	spdlog::debug("Successfully compiled shader from: {}", path);
 	return true;
 }
 
-bool ShaderModule::create() {
-	if (shaderModule != VK_NULL_HANDLE) {
-		spdlog::error("Cannot create shader module because a shader module exists already - please only create one shader module per shader");
+bool ShaderModule::loadFromCache(const std::filesystem::path& cachePath) {
+	const auto bytes = readCacheFile(cachePath);
+
+	if (!bytes.has_value()) {
 		return false;
 	}
 
-	VkShaderModuleCreateInfo createInfo{};
-	createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-	createInfo.codeSize = spirV.size() * sizeof(std::uint32_t);
-	createInfo.pCode = spirV.data();
+	if (bytes->empty() || bytes->size() % sizeof(std::uint32_t) != 0) {
+		spdlog::warn("Ignoring cached shader {} because its size is invalid", cachePath.string());
+		return false;
+	}
 
-	if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
-		spdlog::error("Failed to create shader module");
+	spirV.resize(bytes->size() / sizeof(std::uint32_t));
+	std::memcpy(spirV.data(), bytes->data(), bytes->size());
+
+	if (spirV.front() != SPIR_V_MAGIC_NUMBER) {
+		spdlog::warn("Ignoring cached shader {} because it does not contain SPIR-V", cachePath.string());
+		spirV.clear();
 		return false;
 	}
 
 	return true;
 }
-
-const VkShaderModule& ShaderModule::handle() const {
-	return shaderModule;
-}
+#endif
@@ -0,0 +1,381 @@
+#include "graphics/renderer/streaming_uploader.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+using namespace graphics::renderer;
+
+// Buffer offsets of copies on a transfer-only queue must be a multiple of four bytes, as well as of the texel size
+constexpr VkDeviceSize COPY_OFFSET_ALIGNMENT = 4;
+
+static VkDeviceSize alignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+StreamingUploader::StreamingUploader(const VkDevice& device, MemoryAllocator& allocator) :
+	device(device),
+	allocator(allocator),
+	transferQueue{},
+	transferFamily{ 0 },
+	graphicsFamily{ 0 },
+	commandPool{},
+	freeCommandBuffers{},
+	submissions{},
+	timelineSemaphore{},
+	timelineValue{ 0 },
+	stagingBuffer{},
+	stagingAllocation{},
+	stagingSize{ 0 },
+	stagingHead{ 0 },
+	stagingTail{ 0 },
+	frameBudget{ 0 },
+	pendingUploads{},
+	releasedImages{},
+	recordedAcquireCount{ 0 },
+	nextUpload{ NO_UPLOAD + 1 },
+	completedUpload{ NO_UPLOAD } {}
+
+bool StreamingUploader::create(const VkQueue& queue, const std::uint32_t queueFamily, const std::uint32_t graphicsQueueFamily, const VkDeviceSize ringSize, const VkDeviceSize bytesPerFrame) {
+	transferQueue = queue;
+	transferFamily = queueFamily;
+	graphicsFamily = graphicsQueueFamily;
+	stagingSize = ringSize;
+	frameBudget = bytesPerFrame;
+
+	VkCommandPoolCreateInfo commandPoolCreateInfo{};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = transferFamily;
+
+	if (vkCreateCommandPool(device, &commandPoolCreateInfo, nullptr, &commandPool) != VK_SUCCESS) {
+		spdlog::error("Failed to create the upload command pool");
+		return false;
+	}
+
+	VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo{};
+	semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	semaphoreTypeCreateInfo.initialValue = timelineValue;
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo{};
+	semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+
+	if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &timelineSemaphore) != VK_SUCCESS) {
+		spdlog::error("Failed to create the upload timeline semaphore");
+		return false;
+	}
+
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size = stagingSize;
+	bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(device, &bufferCreateInfo, nullptr, &stagingBuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to create the upload staging buffer");
+		return false;
+	}
+
+	const auto bufferAllocation = allocator.allocateBuffer(stagingBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	if (!bufferAllocation.has_value()) {
+		spdlog::error("Failed to allocate upload staging buffer memory");
+		return false;
+	}
+
+	stagingAllocation = bufferAllocation.value();
+
+	spdlog::debug("Streaming uploads on queue family {} ({}), {} KiB per frame", transferFamily, transferFamily != graphicsFamily ? "dedicated" : "shared with graphics", frameBudget / 1'024);
+	return true;
+}
+
+UploadId StreamingUploader::uploadImage(const VkImage& image, const std::uint32_t width, const std::uint32_t height, const std::uint32_t bytesPerPixel, std::vector<std::uint8_t> pixels) {
+	// Every band of rows has to fit into the staging ring at once
+	if (static_cast<VkDeviceSize>(width) * bytesPerPixel > stagingSize || pixels.size() < static_cast<std::size_t>(width) * height * bytesPerPixel) {
+		spdlog::error("Unable to upload a {}x{} image, its pixels do not match its size or a row does not fit into the staging buffer", width, height);
+		return NO_UPLOAD;
+	}
+
+	const auto id = nextUpload++;
+	pendingUploads.push_back({ id, image, width, height, bytesPerPixel, std::move(pixels), 0 });
+
+	return id;
+}
+
+void StreamingUploader::submit() {
+	reclaim();
+
+	if (pendingUploads.empty()) {
+		return;
+	}
+
+	VkCommandBuffer commandBuffer{};
+
+	if (freeCommandBuffers.empty()) {
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.commandPool = commandPool;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &commandBuffer) != VK_SUCCESS) {
+			spdlog::error("Failed to allocate an upload command buffer");
+			return;
+		}
+	} else {
+		commandBuffer = freeCommandBuffers.back();
+		freeCommandBuffers.pop_back();
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+		spdlog::error("Failed to begin recording into an upload command buffer");
+		freeCommandBuffers.push_back(commandBuffer);
+		return;
+	}
+
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = 1;
+
+	VkDeviceSize remainingBudget = frameBudget;
+	VkDeviceSize submittedBytes = 0;
+
+	// Progress is only committed once the command buffer has been submitted, a failed submission leaves every upload waiting
+	const auto firstStagingHead = stagingHead;
+	std::vector<VkImage> finishedImages{};
+	std::size_t finishedCount = 0;
+	std::uint32_t uploadedRows = pendingUploads.front().uploadedRows;
+
+	while (finishedCount < pendingUploads.size() && remainingBudget > 0) {
+		const auto& upload = pendingUploads[finishedCount];
+
+		const auto rowSize = static_cast<VkDeviceSize>(upload.width) * upload.bytesPerPixel;
+		const auto remainingRows = upload.height - uploadedRows;
+
+		// At least one row per frame, so rows that are larger than the budget still make progress
+		const auto budgetRows = std::max<VkDeviceSize>(remainingBudget / rowSize, submittedBytes == 0 ? 1 : 0);
+		const auto rowCount = static_cast<std::uint32_t>(std::min<VkDeviceSize>({ remainingRows, budgetRows, stagingSize / rowSize }));
+
+		if (rowCount == 0) {
+			break;
+		}
+
+		const auto byteCount = rowSize * rowCount;
+		const auto stagingOffset = reserve(byteCount, std::lcm<VkDeviceSize>(COPY_OFFSET_ALIGNMENT, upload.bytesPerPixel));
+
+		// The ring is full of copies that are still executing, continue next frame
+		if (!stagingOffset.has_value()) {
+			break;
+		}
+
+		std::memcpy(stagingAllocation.mappedData + stagingOffset.value(), upload.pixels.data() + rowSize * uploadedRows, byteCount);
+
+		if (uploadedRows == 0) {
+			barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.image = upload.image;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = stagingOffset.value();
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, static_cast<std::int32_t>(uploadedRows), 0 };
+		region.imageExtent = { upload.width, rowCount, 1 };
+
+		vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		uploadedRows += rowCount;
+		submittedBytes += byteCount;
+		remainingBudget -= std::min(remainingBudget, byteCount);
+
+		if (uploadedRows < upload.height) {
+			continue;
+		}
+
+		// Release the image to the graphics queue, the matching acquire is recorded by recordAcquires()
+		// The layout transition is part of both barriers, and only happens once
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcQueueFamilyIndex = transferFamily != graphicsFamily ? transferFamily : VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = transferFamily != graphicsFamily ? graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		barrier.image = upload.image;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		finishedImages.push_back(upload.image);
+		++finishedCount;
+
+		uploadedRows = finishedCount < pendingUploads.size() ? pendingUploads[finishedCount].uploadedRows : 0;
+	}
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to end recording into an upload command buffer");
+		stagingHead = firstStagingHead;
+		freeCommandBuffers.push_back(commandBuffer);
+		return;
+	}
+
+	// Nothing fit into the staging ring, the command buffer is reused without being submitted
+	if (submittedBytes == 0) {
+		freeCommandBuffers.push_back(commandBuffer);
+		return;
+	}
+
+	const auto signalValue = timelineValue + 1;
+
+	VkTimelineSemaphoreSubmitInfo timelineSubmitInfo{};
+	timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineSubmitInfo.signalSemaphoreValueCount = 1;
+	timelineSubmitInfo.pSignalSemaphoreValues = &signalValue;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineSubmitInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &timelineSemaphore;
+
+	if (vkQueueSubmit(transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+		spdlog::error("Failed to submit uploads to the transfer queue");
+		stagingHead = firstStagingHead;
+		freeCommandBuffers.push_back(commandBuffer);
+		return;
+	}
+
+	timelineValue = signalValue;
+	submissions.push_back({ commandBuffer, timelineValue, stagingHead });
+
+	if (finishedCount > 0) {
+		completedUpload = pendingUploads[finishedCount - 1].id;
+		releasedImages.insert(releasedImages.end(), finishedImages.begin(), finishedImages.end());
+		pendingUploads.erase(pendingUploads.begin(), pendingUploads.begin() + static_cast<std::ptrdiff_t>(finishedCount));
+	}
+
+	if (!pendingUploads.empty()) {
+		pendingUploads.front().uploadedRows = uploadedRows;
+	}
+
+	spdlog::trace("Submitted {} KiB of uploads, {} image{} waiting", submittedBytes / 1'024, pendingUploads.size(), pendingUploads.size() != 1 ? "s" : "");
+}
+
+std::uint64_t StreamingUploader::recordAcquires(const VkCommandBuffer& commandBuffer) {
+	recordedAcquireCount = releasedImages.size();
+
+	if (releasedImages.empty()) {
+		return 0;
+	}
+
+	// Without a dedicated transfer queue there is no ownership to transfer, waiting for the semaphore is enough
+	if (transferFamily != graphicsFamily) {
+		std::vector<VkImageMemoryBarrier> barriers(releasedImages.size());
+
+		for (std::size_t i = 0; i < releasedImages.size(); ++i) {
+			auto& barrier = barriers[i];
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcQueueFamilyIndex = transferFamily;
+			barrier.dstQueueFamilyIndex = graphicsFamily;
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barrier.image = releasedImages[i];
+			barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			barrier.subresourceRange.levelCount = 1;
+			barrier.subresourceRange.layerCount = 1;
+		}
+
+		// Chained to the semaphore wait, which happens at the fragment shader stage
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<std::uint32_t>(barriers.size()), barriers.data());
+	}
+
+	return timelineValue;
+}
+
+void StreamingUploader::commitAcquires() {
+	releasedImages.erase(releasedImages.begin(), releasedImages.begin() + static_cast<std::ptrdiff_t>(recordedAcquireCount));
+	recordedAcquireCount = 0;
+}
+
+const VkSemaphore& StreamingUploader::getSemaphore() const {
+	return timelineSemaphore;
+}
+
+bool StreamingUploader::isComplete(const UploadId upload) const {
+	return upload <= completedUpload;
+}
+
+bool StreamingUploader::hasPendingUploads() const {
+	return !pendingUploads.empty();
+}
+
+void StreamingUploader::destroy() {
+	vkDestroyBuffer(device, stagingBuffer, nullptr);
+	stagingBuffer = VK_NULL_HANDLE;
+	allocator.free(stagingAllocation);
+
+	vkDestroySemaphore(device, timelineSemaphore, nullptr);
+	timelineSemaphore = VK_NULL_HANDLE;
+
+	// Destroying the pool frees its command buffers
+	vkDestroyCommandPool(device, commandPool, nullptr);
+	commandPool = VK_NULL_HANDLE;
+
+	freeCommandBuffers.clear();
+	submissions.clear();
+	pendingUploads.clear();
+	releasedImages.clear();
+	recordedAcquireCount = 0;
+}
+
+void StreamingUploader::reclaim() {
+	std::uint64_t finishedValue = 0;
+
+	if (submissions.empty() || vkGetSemaphoreCounterValue(device, timelineSemaphore, &finishedValue) != VK_SUCCESS) {
+		return;
+	}
+
+	while (!submissions.empty() && submissions.front().value <= finishedValue) {
+		stagingTail = submissions.front().stagingEnd;
+		freeCommandBuffers.push_back(submissions.front().commandBuffer);
+
+		submissions.pop_front();
+	}
+}
+
+std::optional<VkDeviceSize> StreamingUploader::reserve(const VkDeviceSize size, const VkDeviceSize alignment) {
+	const auto headOffset = stagingHead % stagingSize;
+	auto start = stagingHead - headOffset + alignUp(headOffset, alignment);
+
+	// A range never wraps around the end of the buffer, skip to the start of the next lap instead
+	if (start % stagingSize + size > stagingSize || start % stagingSize < headOffset) {
+		start = alignUp(stagingHead, stagingSize);
+	}
+
+	// Would overwrite data of a copy that is still executing
+	if (start + size - stagingTail > stagingSize) {
+		return std::nullopt;
+	}
+
+	stagingHead = start + size;
+	return start % stagingSize;
+}
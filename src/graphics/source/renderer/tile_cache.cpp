@@ -0,0 +1,309 @@
+#include "graphics/renderer/tile_cache.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace graphics::renderer;
+
+// Pack a grid position into a single key
+static std::uint64_t makeKey(const std::int32_t column, const std::int32_t row) {
+	return static_cast<std::uint64_t>(static_cast<std::uint32_t>(column)) << 32 | static_cast<std::uint32_t>(row);
+}
+
+Rectangle Tile::getBounds() const {
+	constexpr auto size = static_cast<float>(TILE_SIZE);
+	return { static_cast<float>(column) * size, static_cast<float>(row) * size, size, size };
+}
+
+TileCache::TileCache(const VkDevice& device, MemoryAllocator& allocator) :
+	device(device),
+	allocator(allocator),
+	format{},
+	renderPass{},
+	maxTileCount{ 0 },
+	tiles{},
+	tileLookup{} {}
+
+bool TileCache::initialize(const VkFormat tileFormat, const std::uint32_t tileCount) {
+	format = tileFormat;
+	maxTileCount = tileCount;
+
+	tiles.reserve(maxTileCount);
+
+	// Tiles are always rasterized completely, so their previous contents can be discarded
+	VkAttachmentDescription colorAttachment{};
+	colorAttachment.format = format;
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkAttachmentReference colorAttachmentRef{};
+	colorAttachmentRef.attachment = 0;
+	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	VkSubpassDescription subpass{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorAttachmentRef;
+
+	// Wait for earlier composites that sampled the tile, and make the new contents visible to the next composite
+	VkSubpassDependency dependencies[2]{};
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	VkRenderPassCreateInfo renderPassCreateInfo{};
+	renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.attachmentCount = 1;
+	renderPassCreateInfo.pAttachments = &colorAttachment;
+	renderPassCreateInfo.subpassCount = 1;
+	renderPassCreateInfo.pSubpasses = &subpass;
+	renderPassCreateInfo.dependencyCount = 2;
+	renderPassCreateInfo.pDependencies = dependencies;
+
+	if (vkCreateRenderPass(device, &renderPassCreateInfo, nullptr, &renderPass) != VK_SUCCESS) {
+		spdlog::error("Failed to create tile render pass");
+		return false;
+	}
+
+	spdlog::debug("Tile cache created ({} tiles of {}x{})", maxTileCount, TILE_SIZE, TILE_SIZE);
+	return true;
+}
+
+Tile* TileCache::acquire(const std::int32_t column, const std::int32_t row, const std::uint64_t frame) {
+	const auto key = makeKey(column, row);
+	const auto iterator = tileLookup.find(key);
+
+	if (iterator != tileLookup.end()) {
+		auto& tile = tiles[iterator->second];
+		tile.lastUsedFrame = frame;
+
+		return &tile;
+	}
+
+	std::size_t index = 0;
+
+	if (tiles.size() < maxTileCount) {
+		Tile tile{};
+		tile.texture = NO_TEXTURE;
+
+		if (!createTile(tile)) {
+			return nullptr;
+		}
+
+		index = tiles.size();
+		tiles.push_back(tile);
+	} else {
+		// Recycle the tile that has not been looked at for the longest time
+		auto oldestFrame = std::numeric_limits<std::uint64_t>::max();
+
+		for (std::size_t i = 0; i < tiles.size(); ++i) {
+			if (tiles[i].lastUsedFrame < oldestFrame) {
+				oldestFrame = tiles[i].lastUsedFrame;
+				index = i;
+			}
+		}
+
+		// The caller reports the shortage, it happens for every tile past the budget
+		if (oldestFrame >= frame) {
+			return nullptr;
+		}
+
+		tileLookup.erase(makeKey(tiles[index].column, tiles[index].row));
+	}
+
+	auto& tile = tiles[index];
+	tile.column = column;
+	tile.row = row;
+	tile.isValid = false;
+	tile.lastUsedFrame = frame;
+
+	tileLookup[key] = index;
+	return &tile;
+}
+
+void TileCache::invalidate(const Rectangle& area) {
+	if (area.width <= 0.0f || area.height <= 0.0f) {
+		return;
+	}
+
+	constexpr auto size = static_cast<float>(TILE_SIZE);
+
+	const auto firstColumn = static_cast<std::int32_t>(std::floor(area.x / size));
+	const auto lastColumn = static_cast<std::int32_t>(std::floor((area.x + area.width) / size));
+	const auto firstRow = static_cast<std::int32_t>(std::floor(area.y / size));
+	const auto lastRow = static_cast<std::int32_t>(std::floor((area.y + area.height) / size));
+
+	// Large areas touch more grid cells than there are tiles, in which case walking the tiles is cheaper
+	const auto cellCount = static_cast<std::uint64_t>(lastColumn - firstColumn + 1) * static_cast<std::uint64_t>(lastRow - firstRow + 1);
+
+	if (cellCount > tiles.size()) {
+		for (auto& tile : tiles) {
+			if (tile.column >= firstColumn && tile.column <= lastColumn && tile.row >= firstRow && tile.row <= lastRow) {
+				tile.isValid = false;
+			}
+		}
+
+		return;
+	}
+
+	for (auto row = firstRow; row <= lastRow; ++row) {
+		for (auto column = firstColumn; column <= lastColumn; ++column) {
+			const auto iterator = tileLookup.find(makeKey(column, row));
+
+			if (iterator != tileLookup.end()) {
+				tiles[iterator->second].isValid = false;
+			}
+		}
+	}
+}
+
+void TileCache::invalidateAll() {
+	for (auto& tile : tiles) {
+		tile.isValid = false;
+	}
+}
+
+void TileCache::grow(const std::uint32_t tileCount) {
+	if (tileCount <= maxTileCount) {
+		return;
+	}
+
+	maxTileCount = tileCount;
+	tiles.reserve(maxTileCount);
+
+	spdlog::debug("Tile cache grown to {} tiles", maxTileCount);
+}
+
+std::vector<Tile*> TileCache::defragment() {
+	std::vector<Tile*> movedTiles{};
+
+	for (auto& tile : tiles) {
+		if (!allocator.shouldRelocate(tile.imageAllocation)) {
+			continue;
+		}
+
+		// The new image is allocated before the old one is released, so it cannot end up in the same block
+		auto movedTile = tile;
+
+		if (!createTile(movedTile)) {
+			break;
+		}
+
+		destroyTile(tile);
+
+		tile = movedTile;
+		tile.isValid = false;
+		movedTiles.push_back(&tile);
+	}
+
+	return movedTiles;
+}
+
+const VkRenderPass& TileCache::getRenderPass() const {
+	return renderPass;
+}
+
+void TileCache::destroy() {
+	for (auto& tile : tiles) {
+		destroyTile(tile);
+	}
+
+	tiles.clear();
+	tileLookup.clear();
+
+	vkDestroyRenderPass(device, renderPass, nullptr);
+	renderPass = VK_NULL_HANDLE;
+}
+
+bool TileCache::createTile(Tile& tile) {
+	VkImageCreateInfo imageCreateInfo{};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.format = format;
+	imageCreateInfo.extent = { TILE_SIZE, TILE_SIZE, 1 };
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	if (vkCreateImage(device, &imageCreateInfo, nullptr, &tile.image) != VK_SUCCESS) {
+		spdlog::error("Failed to create tile image");
+		return false;
+	}
+
+	const auto imageAllocation = allocator.allocateImage(tile.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	if (!imageAllocation.has_value()) {
+		spdlog::error("Failed to allocate tile image memory");
+		vkDestroyImage(device, tile.image, nullptr);
+		return false;
+	}
+
+	tile.imageAllocation = imageAllocation.value();
+
+	VkImageViewCreateInfo imageViewCreateInfo{};
+	imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	imageViewCreateInfo.image = tile.image;
+	imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	imageViewCreateInfo.format = format;
+	imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageViewCreateInfo.subresourceRange.levelCount = 1;
+	imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+	if (vkCreateImageView(device, &imageViewCreateInfo, nullptr, &tile.imageView) != VK_SUCCESS) {
+		spdlog::error("Failed to create tile image view");
+		vkDestroyImage(device, tile.image, nullptr);
+		allocator.free(tile.imageAllocation);
+		return false;
+	}
+
+	VkFramebufferCreateInfo framebufferCreateInfo{};
+	framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferCreateInfo.renderPass = renderPass;
+	framebufferCreateInfo.attachmentCount = 1;
+	framebufferCreateInfo.pAttachments = &tile.imageView;
+	framebufferCreateInfo.width = TILE_SIZE;
+	framebufferCreateInfo.height = TILE_SIZE;
+	framebufferCreateInfo.layers = 1;
+
+	if (vkCreateFramebuffer(device, &framebufferCreateInfo, nullptr, &tile.framebuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to create tile framebuffer");
+		vkDestroyImageView(device, tile.imageView, nullptr);
+		vkDestroyImage(device, tile.image, nullptr);
+		allocator.free(tile.imageAllocation);
+		return false;
+	}
+
+	return true;
+}
+
+void TileCache::destroyTile(Tile& tile) {
+	vkDestroyFramebuffer(device, tile.framebuffer, nullptr);
+	vkDestroyImageView(device, tile.imageView, nullptr);
+	vkDestroyImage(device, tile.image, nullptr);
+	allocator.free(tile.imageAllocation);
+
+	tile.framebuffer = VK_NULL_HANDLE;
+	tile.imageView = VK_NULL_HANDLE;
+	tile.image = VK_NULL_HANDLE;
+}
@@ -0,0 +1,145 @@
+#include "graphics/text/font_collection.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+using namespace graphics::text;
+
+// FreeType reports most metrics in 26.6 fixed point
+constexpr float FIXED_26_6_TO_FLOAT = 1.0f / 64.0f;
+
+FontCollection::FontCollection() :
+	library(nullptr),
+	faces{} {}
+
+FontCollection::~FontCollection() {
+	destroy();
+}
+
+bool FontCollection::initialize() {
+	const auto error = FT_Init_FreeType(&library);
+
+	if (error != 0) {
+		spdlog::error("Unable to initialize FreeType: {}", error);
+		return false;
+	}
+
+	spdlog::debug("FreeType initialised");
+	return true;
+}
+
+std::optional<FontId> FontCollection::load(const std::string_view& path) {
+	if (faces.size() >= std::numeric_limits<FontId>::max()) {
+		spdlog::error("Unable to load font because the maximum number of fonts has been reached");
+		return std::nullopt;
+	}
+
+	FT_Face face = nullptr;
+	const auto error = FT_New_Face(library, std::string(path).c_str(), 0, &face);
+
+	if (error != 0) {
+		spdlog::error("Unable to load font \"{}\": {}", path, error);
+		return std::nullopt;
+	}
+
+	spdlog::debug("Loaded font: {} {} ({})", face->family_name, face->style_name, path);
+
+	faces.push_back(face);
+	return static_cast<FontId>(faces.size() - 1);
+}
+
+std::optional<GlyphMetrics> FontCollection::getGlyphMetrics(const FontId font, const std::uint32_t pixelSize, const std::uint32_t codePoint) {
+	const auto face = selectFace(font, pixelSize);
+
+	if (face == nullptr) {
+		return std::nullopt;
+	}
+
+	// Missing characters map onto glyph 0, which is the font's "missing glyph" box
+	const auto glyphIndex = FT_Get_Char_Index(face, codePoint);
+
+	if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT) != 0) {
+		return std::nullopt;
+	}
+
+	return GlyphMetrics{ glyphIndex, static_cast<float>(face->glyph->advance.x) * FIXED_26_6_TO_FLOAT };
+}
+
+float FontCollection::getKerning(const FontId font, const std::uint32_t pixelSize, const std::uint32_t leftGlyphIndex, const std::uint32_t rightGlyphIndex) {
+	const auto face = selectFace(font, pixelSize);
+
+	if (face == nullptr || !FT_HAS_KERNING(face)) {
+		return 0.0f;
+	}
+
+	FT_Vector kerning{};
+	FT_Get_Kerning(face, leftGlyphIndex, rightGlyphIndex, FT_KERNING_DEFAULT, &kerning);
+
+	return static_cast<float>(kerning.x) * FIXED_26_6_TO_FLOAT;
+}
+
+std::optional<RasterizedGlyph> FontCollection::rasterize(const FontId font, const std::uint32_t pixelSize, const std::uint32_t glyphIndex) {
+	const auto face = selectFace(font, pixelSize);
+
+	if (face == nullptr) {
+		return std::nullopt;
+	}
+
+	if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_RENDER) != 0) {
+		spdlog::error("Unable to rasterize glyph {}", glyphIndex);
+		return std::nullopt;
+	}
+
+	const auto& bitmap = face->glyph->bitmap;
+
+	RasterizedGlyph glyph{};
+	glyph.width = bitmap.width;
+	glyph.height = bitmap.rows;
+	glyph.bearingX = face->glyph->bitmap_left;
+	glyph.bearingY = -face->glyph->bitmap_top;
+	glyph.pixels.resize(static_cast<std::size_t>(glyph.width) * glyph.height);
+
+	// The pitch may include padding, so copy row by row
+	for (std::uint32_t row = 0; row < glyph.height; ++row) {
+		const auto source = bitmap.buffer + static_cast<std::ptrdiff_t>(row) * bitmap.pitch;
+		std::copy(source, source + glyph.width, glyph.pixels.begin() + static_cast<std::ptrdiff_t>(row) * glyph.width);
+	}
+
+	return glyph;
+}
+
+void FontCollection::destroy() {
+	for (const auto face : faces) {
+		FT_Done_Face(face);
+	}
+
+	faces.clear();
+
+	if (library != nullptr) {
+		FT_Done_FreeType(library);
+		library = nullptr;
+		spdlog::debug("FreeType terminated");
+	}
+}
+
+FT_Face FontCollection::selectFace(const FontId font, const std::uint32_t pixelSize) {
+	if (font >= faces.size()) {
+		spdlog::error("Unknown font: {}", font);
+		return nullptr;
+	}
+
+	const auto face = faces[font];
+
+	// Changing the size of a face is cheap, but not free - skip it when the size did not change
+	if (face->size->metrics.y_ppem != pixelSize) {
+		FT_Set_Pixel_Sizes(face, 0, pixelSize);
+	}
+
+	return face;
+}
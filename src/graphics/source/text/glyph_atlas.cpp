@@ -0,0 +1,377 @@
+#include "graphics/text/glyph_atlas.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace graphics::renderer;
+using namespace graphics::text;
+
+// Empty border around every glyph, prevents neighbouring glyphs from bleeding into each other when sampling
+constexpr std::uint32_t GLYPH_PADDING = 1;
+
+// Offsets of regions in a buffer to image copy must be a multiple of four bytes
+constexpr VkDeviceSize COPY_OFFSET_ALIGNMENT = 4;
+
+// Pack the font, size, and glyph index into a single key
+static std::uint64_t makeKey(const FontId font, const std::uint32_t pixelSize, const std::uint32_t glyphIndex) {
+	return static_cast<std::uint64_t>(font) << 48 | static_cast<std::uint64_t>(pixelSize & 0xFFFF) << 32 | glyphIndex;
+}
+
+GlyphAtlas::GlyphAtlas(const VkDevice& device, MemoryAllocator& allocator, const std::uint32_t size) :
+	device(device),
+	allocator(allocator),
+	size(size),
+	packer(size, size),
+	entries{},
+	frameIndex{ 0 },
+	pixels(static_cast<std::size_t>(size) * size, 0),
+	pendingUploads{},
+	needsFullUpload{ true },
+	isImageInitialized{ false },
+	image{},
+	imageAllocation{},
+	imageView{},
+	stagingBuffer{},
+	stagingAllocation{},
+	stagingData{ nullptr },
+	stagingSliceCount{ 0 } {}
+
+bool GlyphAtlas::create(const std::uint32_t sliceCount) {
+	stagingSliceCount = sliceCount;
+
+	VkImageCreateInfo imageCreateInfo{};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.format = VK_FORMAT_R8_UNORM;
+	imageCreateInfo.extent = { size, size, 1 };
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	if (vkCreateImage(device, &imageCreateInfo, nullptr, &image) != VK_SUCCESS) {
+		spdlog::error("Failed to create glyph atlas image");
+		return false;
+	}
+
+	const auto atlasAllocation = allocator.allocateImage(image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+	if (!atlasAllocation.has_value()) {
+		spdlog::error("Failed to allocate glyph atlas image memory");
+		return false;
+	}
+
+	imageAllocation = atlasAllocation.value();
+
+	VkImageViewCreateInfo imageViewCreateInfo{};
+	imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	imageViewCreateInfo.image = image;
+	imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	imageViewCreateInfo.format = VK_FORMAT_R8_UNORM;
+	imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageViewCreateInfo.subresourceRange.levelCount = 1;
+	imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+	if (vkCreateImageView(device, &imageViewCreateInfo, nullptr, &imageView) != VK_SUCCESS) {
+		spdlog::error("Failed to create glyph atlas image view");
+		return false;
+	}
+
+	// Every slice of the staging buffer is large enough to hold the entire atlas, which is needed after an eviction
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.size = static_cast<VkDeviceSize>(pixels.size()) * stagingSliceCount;
+	bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(device, &bufferCreateInfo, nullptr, &stagingBuffer) != VK_SUCCESS) {
+		spdlog::error("Failed to create glyph atlas staging buffer");
+		return false;
+	}
+
+	// Persistently mapped by the allocator, the buffer is written to every time new glyphs are uploaded
+	const auto bufferAllocation = allocator.allocateBuffer(stagingBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+	if (!bufferAllocation.has_value()) {
+		spdlog::error("Failed to allocate glyph atlas staging buffer memory");
+		return false;
+	}
+
+	stagingAllocation = bufferAllocation.value();
+	stagingData = stagingAllocation.mappedData;
+
+	spdlog::debug("Glyph atlas created ({}x{})", size, size);
+	return true;
+}
+
+void GlyphAtlas::beginFrame() {
+	++frameIndex;
+}
+
+std::optional<AtlasGlyph> GlyphAtlas::find(FontCollection& fonts, const FontId font, const std::uint32_t pixelSize, const std::uint32_t glyphIndex) {
+	const auto key = makeKey(font, pixelSize, glyphIndex);
+	const auto found = entries.find(key);
+
+	if (found != entries.end()) {
+		found->second.lastUsedFrame = frameIndex;
+		return found->second.glyph;
+	}
+
+	const auto rasterizedGlyph = fonts.rasterize(font, pixelSize, glyphIndex);
+
+	if (!rasterizedGlyph.has_value()) {
+		return std::nullopt;
+	}
+
+	Entry entry{};
+	entry.glyph.width = rasterizedGlyph->width;
+	entry.glyph.height = rasterizedGlyph->height;
+	entry.glyph.bearingX = rasterizedGlyph->bearingX;
+	entry.glyph.bearingY = rasterizedGlyph->bearingY;
+	entry.lastUsedFrame = frameIndex;
+
+	// Glyphs without pixels (such as spaces) are cached for their metrics, but take up no space in the texture
+	if (rasterizedGlyph->width > 0 && rasterizedGlyph->height > 0) {
+		auto rectangle = insert(rasterizedGlyph->width, rasterizedGlyph->height, rasterizedGlyph->pixels.data());
+
+		if (!rectangle.has_value()) {
+			evict();
+			rectangle = insert(rasterizedGlyph->width, rasterizedGlyph->height, rasterizedGlyph->pixels.data());
+		}
+
+		if (!rectangle.has_value()) {
+			spdlog::error("Glyph atlas is full, even after evicting unused glyphs");
+			return std::nullopt;
+		}
+
+		entry.rectangle = rectangle.value();
+		updateTextureCoordinates(entry);
+	}
+
+	return entries.emplace(key, entry).first->second.glyph;
+}
+
+void GlyphAtlas::recordUpload(const VkCommandBuffer& commandBuffer, const std::uint32_t stagingSlice) {
+	if (!needsFullUpload && pendingUploads.empty()) {
+		return;
+	}
+
+	const auto sliceOffset = static_cast<VkDeviceSize>(pixels.size()) * (stagingSlice % stagingSliceCount);
+	auto* const sliceData = stagingData + sliceOffset;
+
+	std::vector<VkBufferImageCopy> regions;
+	regions.reserve(pendingUploads.size());
+
+	if (!needsFullUpload) {
+		VkDeviceSize offset = 0;
+
+		for (const auto& rectangle : pendingUploads) {
+			const auto byteCount = static_cast<VkDeviceSize>(rectangle.width) * rectangle.height;
+
+			// Alignment padding could make the individual regions outgrow the buffer, upload everything at once instead
+			if (offset + byteCount > pixels.size()) {
+				needsFullUpload = true;
+				break;
+			}
+
+			// Rows are copied tightly packed into the staging buffer
+			for (std::uint32_t row = 0; row < rectangle.height; ++row) {
+				const auto source = pixels.data() + static_cast<std::size_t>(rectangle.y + row) * size + rectangle.x;
+				std::memcpy(sliceData + offset + static_cast<VkDeviceSize>(row) * rectangle.width, source, rectangle.width);
+			}
+
+			VkBufferImageCopy region{};
+			region.bufferOffset = sliceOffset + offset;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { static_cast<std::int32_t>(rectangle.x), static_cast<std::int32_t>(rectangle.y), 0 };
+			region.imageExtent = { rectangle.width, rectangle.height, 1 };
+			regions.push_back(region);
+
+			offset = (offset + byteCount + COPY_OFFSET_ALIGNMENT - 1) & ~(COPY_OFFSET_ALIGNMENT - 1);
+		}
+	}
+
+	if (needsFullUpload) {
+		std::memcpy(sliceData, pixels.data(), pixels.size());
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = sliceOffset;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.layerCount = 1;
+		region.imageExtent = { size, size, 1 };
+
+		regions.clear();
+		regions.push_back(region);
+	}
+
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.oldLayout = isImageInitialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.layerCount = 1;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	// Previous frames may still be sampling the atlas, the copy has to wait for those reads
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<std::uint32_t>(regions.size()), regions.data());
+
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	spdlog::trace("Uploaded {} glyph atlas region{}", regions.size(), regions.size() != 1 ? "s" : "");
+
+	pendingUploads.clear();
+	needsFullUpload = false;
+	isImageInitialized = true;
+}
+
+const VkImageView& GlyphAtlas::getImageView() const {
+	return imageView;
+}
+
+void GlyphAtlas::destroy() {
+	vkDestroyBuffer(device, stagingBuffer, nullptr);
+	allocator.free(stagingAllocation);
+	stagingData = nullptr;
+
+	vkDestroyImageView(device, imageView, nullptr);
+	vkDestroyImage(device, image, nullptr);
+	allocator.free(imageAllocation);
+
+	entries.clear();
+}
+
+std::optional<PackedRectangle> GlyphAtlas::insert(const std::uint32_t width, const std::uint32_t height, const std::uint8_t* const source) {
+	const auto packed = packer.pack(width + GLYPH_PADDING * 2, height + GLYPH_PADDING * 2);
+
+	if (!packed.has_value()) {
+		return std::nullopt;
+	}
+
+	const PackedRectangle rectangle{ packed->x + GLYPH_PADDING, packed->y + GLYPH_PADDING, width, height };
+
+	for (std::uint32_t row = 0; row < height; ++row) {
+		std::memcpy(pixels.data() + static_cast<std::size_t>(rectangle.y + row) * size + rectangle.x, source + static_cast<std::size_t>(row) * width, width);
+	}
+
+	pendingUploads.push_back(rectangle);
+	return rectangle;
+}
+
+void GlyphAtlas::evict() {
+	const auto previousEntryCount = entries.size();
+
+	std::vector<std::pair<std::uint64_t, Entry>> survivors;
+	survivors.reserve(entries.size());
+
+	for (const auto& entry : entries) {
+		survivors.push_back(entry);
+	}
+
+	// Most recently used glyphs first
+	std::sort(survivors.begin(), survivors.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.second.lastUsedFrame > rhs.second.lastUsedFrame;
+	});
+
+	// Keep everything used in the current frame, plus recently used glyphs until half of the atlas is filled
+	const auto areaBudget = static_cast<std::uint64_t>(size) * size / 2;
+	std::uint64_t keptArea = 0;
+	std::size_t keptCount = 0;
+
+	for (const auto& [key, entry] : survivors) {
+		const auto area = static_cast<std::uint64_t>(entry.rectangle.width + GLYPH_PADDING * 2) * (entry.rectangle.height + GLYPH_PADDING * 2);
+
+		if (entry.lastUsedFrame != frameIndex && keptArea + area > areaBudget) {
+			break;
+		}
+
+		keptArea += area;
+		++keptCount;
+	}
+
+	survivors.resize(keptCount);
+
+	// Taller glyphs first, which packs noticeably tighter with a skyline
+	std::sort(survivors.begin(), survivors.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.second.rectangle.height > rhs.second.rectangle.height;
+	});
+
+	const auto previousPixels = std::move(pixels);
+	pixels.assign(previousPixels.size(), 0);
+	packer.reset();
+	entries.clear();
+
+	const auto hasPixels = [](const Entry& entry) {
+		return entry.glyph.width > 0 && entry.glyph.height > 0;
+	};
+
+	// Quads built earlier in this frame already hold the texture coordinates of the current frame's glyphs, so those stay where they are
+	// The space in the atlas around them is packed with the remaining glyphs
+	for (const auto& [key, entry] : survivors) {
+		if (entry.lastUsedFrame != frameIndex || !hasPixels(entry)) {
+			continue;
+		}
+
+		const auto& rectangle = entry.rectangle;
+		packer.reserve({ rectangle.x - GLYPH_PADDING, rectangle.y - GLYPH_PADDING, rectangle.width + GLYPH_PADDING * 2, rectangle.height + GLYPH_PADDING * 2 });
+
+		for (std::uint32_t row = 0; row < rectangle.height; ++row) {
+			const auto offset = static_cast<std::size_t>(rectangle.y + row) * size + rectangle.x;
+			std::memcpy(pixels.data() + offset, previousPixels.data() + offset, rectangle.width);
+		}
+	}
+
+	for (auto& [key, entry] : survivors) {
+		if (entry.lastUsedFrame != frameIndex && hasPixels(entry)) {
+			const auto packed = packer.pack(entry.rectangle.width + GLYPH_PADDING * 2, entry.rectangle.height + GLYPH_PADDING * 2);
+
+			if (!packed.has_value()) {
+				continue;
+			}
+
+			const PackedRectangle rectangle{ packed->x + GLYPH_PADDING, packed->y + GLYPH_PADDING, entry.rectangle.width, entry.rectangle.height };
+
+			for (std::uint32_t row = 0; row < rectangle.height; ++row) {
+				const auto source = previousPixels.data() + static_cast<std::size_t>(entry.rectangle.y + row) * size + entry.rectangle.x;
+				std::memcpy(pixels.data() + static_cast<std::size_t>(rectangle.y + row) * size + rectangle.x, source, rectangle.width);
+			}
+
+			entry.rectangle = rectangle;
+			updateTextureCoordinates(entry);
+		}
+
+		entries.emplace(key, entry);
+	}
+
+	// Most glyphs moved, so the texture is replaced as a whole
+	pendingUploads.clear();
+	needsFullUpload = true;
+
+	spdlog::debug("Glyph atlas full - evicted {} glyphs, {} remain", previousEntryCount - entries.size(), entries.size());
+}
+
+void GlyphAtlas::updateTextureCoordinates(Entry& entry) const {
+	const auto scale = 1.0f / static_cast<float>(size);
+
+	entry.glyph.u0 = static_cast<float>(entry.rectangle.x) * scale;
+	entry.glyph.v0 = static_cast<float>(entry.rectangle.y) * scale;
+	entry.glyph.u1 = static_cast<float>(entry.rectangle.x + entry.rectangle.width) * scale;
+	entry.glyph.v1 = static_cast<float>(entry.rectangle.y + entry.rectangle.height) * scale;
+}
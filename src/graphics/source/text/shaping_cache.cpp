@@ -0,0 +1,125 @@
+#include "graphics/text/shaping_cache.hpp"
+
+#include <optional>
+
+using namespace graphics::text;
+
+// Substituted for malformed UTF-8 sequences
+constexpr std::uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// Decode the code point starting at "position" and advance past it
+static std::uint32_t decodeUtf8(const std::string_view& text, std::size_t& position) {
+	const auto lead = static_cast<std::uint8_t>(text[position++]);
+
+	if (lead < 0x80) {
+		return lead;
+	}
+
+	std::size_t continuationCount = 0;
+	std::uint32_t codePoint = 0;
+
+	if ((lead & 0xE0) == 0xC0) {
+		continuationCount = 1;
+		codePoint = lead & 0x1F;
+	} else if ((lead & 0xF0) == 0xE0) {
+		continuationCount = 2;
+		codePoint = lead & 0x0F;
+	} else if ((lead & 0xF8) == 0xF0) {
+		continuationCount = 3;
+		codePoint = lead & 0x07;
+	} else {
+		return REPLACEMENT_CHARACTER;
+	}
+
+	for (std::size_t i = 0; i < continuationCount; ++i) {
+		if (position >= text.size() || (static_cast<std::uint8_t>(text[position]) & 0xC0) != 0x80) {
+			return REPLACEMENT_CHARACTER;
+		}
+
+		codePoint = (codePoint << 6) | (static_cast<std::uint8_t>(text[position++]) & 0x3F);
+	}
+
+	return codePoint;
+}
+
+ShapingCache::ShapingCache(const std::size_t capacity) :
+	capacity(capacity),
+	entries{},
+	lookup{},
+	hitCount{ 0 },
+	missCount{ 0 } {}
+
+const ShapedRun& ShapingCache::shape(FontCollection& fonts, const FontId font, const std::uint32_t pixelSize, const std::string_view& text) {
+	const auto key = makeKey(font, pixelSize, text);
+	const auto found = lookup.find(key);
+
+	if (found != lookup.end()) {
+		++hitCount;
+
+		// Move the entry to the front of the list to mark it as most recently used
+		entries.splice(entries.begin(), entries, found->second);
+		return found->second->run;
+	}
+
+	++missCount;
+
+	ShapedRun run{};
+	run.width = 0.0f;
+	run.glyphs.reserve(text.size());
+
+	std::optional<std::uint32_t> previousGlyphIndex;
+	std::size_t position = 0;
+
+	while (position < text.size()) {
+		const auto codePoint = decodeUtf8(text, position);
+		const auto metrics = fonts.getGlyphMetrics(font, pixelSize, codePoint);
+
+		if (!metrics.has_value()) {
+			continue;
+		}
+
+		if (previousGlyphIndex.has_value()) {
+			run.width += fonts.getKerning(font, pixelSize, previousGlyphIndex.value(), metrics->glyphIndex);
+		}
+
+		run.glyphs.push_back({ metrics->glyphIndex, run.width });
+		run.width += metrics->advance;
+		previousGlyphIndex = metrics->glyphIndex;
+	}
+
+	// Evict the least recently used run when the cache is full
+	if (entries.size() >= capacity && !entries.empty()) {
+		lookup.erase(entries.back().key);
+		entries.pop_back();
+	}
+
+	entries.push_front({ key, std::move(run) });
+
+	// The lookup table refers to the key owned by the list entry, which never moves in memory
+	lookup.emplace(entries.front().key, entries.begin());
+
+	return entries.front().run;
+}
+
+void ShapingCache::clear() {
+	lookup.clear();
+	entries.clear();
+}
+
+std::size_t ShapingCache::getHitCount() const {
+	return hitCount;
+}
+
+std::size_t ShapingCache::getMissCount() const {
+	return missCount;
+}
+
+std::string ShapingCache::makeKey(const FontId font, const std::uint32_t pixelSize, const std::string_view& text) {
+	std::string key;
+	key.reserve(sizeof(font) + sizeof(pixelSize) + text.size());
+	key.append(reinterpret_cast<const char*>(&font), sizeof(font));
+	key.append(reinterpret_cast<const char*>(&pixelSize), sizeof(pixelSize));
+	key.append(text);
+
+	return key;
+}
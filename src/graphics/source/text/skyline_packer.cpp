@@ -0,0 +1,163 @@
+#include "graphics/text/skyline_packer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using namespace graphics::text;
+
+SkylinePacker::SkylinePacker(const std::uint32_t width, const std::uint32_t height) :
+	width(width),
+	height(height),
+	usedArea{ 0 },
+	skyline{} {
+	reset();
+}
+
+std::optional<PackedRectangle> SkylinePacker::pack(const std::uint32_t rectangleWidth, const std::uint32_t rectangleHeight) {
+	auto bestY = std::numeric_limits<std::uint32_t>::max();
+	auto bestWidth = std::numeric_limits<std::uint32_t>::max();
+	std::optional<std::size_t> bestIndex;
+
+	// Bottom-left: prefer the lowest position, break ties by picking the narrowest segment to reduce waste
+	for (std::size_t i = 0; i < skyline.size(); ++i) {
+		const auto y = fit(i, rectangleWidth, rectangleHeight);
+
+		if (!y.has_value()) {
+			continue;
+		}
+
+		if (y.value() < bestY || (y.value() == bestY && skyline[i].width < bestWidth)) {
+			bestY = y.value();
+			bestWidth = skyline[i].width;
+			bestIndex = i;
+		}
+	}
+
+	if (!bestIndex.has_value()) {
+		return std::nullopt;
+	}
+
+	const PackedRectangle rectangle{ skyline[bestIndex.value()].x, bestY, rectangleWidth, rectangleHeight };
+	addSkylineLevel(bestIndex.value(), rectangle);
+	usedArea += static_cast<std::uint64_t>(rectangleWidth) * rectangleHeight;
+
+	return rectangle;
+}
+
+void SkylinePacker::reserve(const PackedRectangle& rectangle) {
+	const auto left = rectangle.x;
+	const auto right = std::min(rectangle.x + rectangle.width, width);
+	const auto top = rectangle.y + rectangle.height;
+
+	std::vector<Segment> raisedSkyline;
+	raisedSkyline.reserve(skyline.size() + 2);
+
+	// Split the segments at the edges of the rectangle, the part in between rests on top of it
+	for (const auto& segment : skyline) {
+		const auto segmentRight = segment.x + segment.width;
+		const auto overlapLeft = std::max(segment.x, left);
+		const auto overlapRight = std::min(segmentRight, right);
+
+		if (overlapLeft >= overlapRight) {
+			raisedSkyline.push_back(segment);
+			continue;
+		}
+
+		if (segment.x < overlapLeft) {
+			raisedSkyline.push_back({ segment.x, segment.y, overlapLeft - segment.x });
+		}
+
+		raisedSkyline.push_back({ overlapLeft, std::max(segment.y, top), overlapRight - overlapLeft });
+
+		if (overlapRight < segmentRight) {
+			raisedSkyline.push_back({ overlapRight, segment.y, segmentRight - overlapRight });
+		}
+	}
+
+	// Merge neighbouring segments at the same height
+	skyline.clear();
+
+	for (const auto& segment : raisedSkyline) {
+		if (!skyline.empty() && skyline.back().y == segment.y) {
+			skyline.back().width += segment.width;
+		} else {
+			skyline.push_back(segment);
+		}
+	}
+
+	usedArea += static_cast<std::uint64_t>(right - std::min(left, right)) * rectangle.height;
+}
+
+void SkylinePacker::reset() {
+	skyline.clear();
+	skyline.push_back({ 0, 0, width });
+	usedArea = 0;
+}
+
+float SkylinePacker::getOccupancy() const {
+	return static_cast<float>(usedArea) / (static_cast<float>(width) * static_cast<float>(height));
+}
+
+std::optional<std::uint32_t> SkylinePacker::fit(const std::size_t segmentIndex, const std::uint32_t rectangleWidth, const std::uint32_t rectangleHeight) const {
+	const auto x = skyline[segmentIndex].x;
+
+	if (x + rectangleWidth > width) {
+		return std::nullopt;
+	}
+
+	// The rectangle rests on the highest segment it spans
+	auto remainingWidth = static_cast<std::int64_t>(rectangleWidth);
+	auto y = skyline[segmentIndex].y;
+
+	for (auto i = segmentIndex; remainingWidth > 0; ++i) {
+		if (i >= skyline.size()) {
+			return std::nullopt;
+		}
+
+		y = std::max(y, skyline[i].y);
+
+		if (y + rectangleHeight > height) {
+			return std::nullopt;
+		}
+
+		remainingWidth -= skyline[i].width;
+	}
+
+	return y;
+}
+
+void SkylinePacker::addSkylineLevel(const std::size_t segmentIndex, const PackedRectangle& rectangle) {
+	skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(segmentIndex), { rectangle.x, rectangle.y + rectangle.height, rectangle.width });
+
+	// Shrink or remove the segments that are now covered by the new segment
+	const auto right = rectangle.x + rectangle.width;
+
+	for (auto i = segmentIndex + 1; i < skyline.size();) {
+		auto& segment = skyline[i];
+
+		if (segment.x >= right) {
+			break;
+		}
+
+		const auto segmentRight = segment.x + segment.width;
+
+		if (segmentRight <= right) {
+			skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+			continue;
+		}
+
+		segment.width = segmentRight - right;
+		segment.x = right;
+		break;
+	}
+
+	// Merge neighbouring segments at the same height
+	for (std::size_t i = 0; i + 1 < skyline.size();) {
+		if (skyline[i].y == skyline[i + 1].y) {
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+		} else {
+			++i;
+		}
+	}
+}
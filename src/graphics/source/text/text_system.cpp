@@ -0,0 +1,55 @@
+#include "graphics/text/text_system.hpp"
+
+#include "spdlog/spdlog.h"
+
+using namespace graphics::text;
+
+TextSystem::TextSystem(const VkDevice& device, renderer::MemoryAllocator& allocator) :
+	fonts{},
+	shapingCache{},
+	glyphAtlas{ device, allocator } {}
+
+bool TextSystem::initialize(const std::uint32_t framesInFlight) {
+	if (!fonts.initialize()) {
+		return false;
+	}
+
+	if (!glyphAtlas.create(framesInFlight)) {
+		return false;
+	}
+
+	spdlog::debug("Text system initialised");
+	return true;
+}
+
+std::optional<FontId> TextSystem::loadFont(const std::string_view& path) {
+	return fonts.load(path);
+}
+
+const ShapedRun& TextSystem::shape(const FontId font, const std::uint32_t pixelSize, const std::string_view& text) {
+	return shapingCache.shape(fonts, font, pixelSize, text);
+}
+
+std::optional<AtlasGlyph> TextSystem::findGlyph(const FontId font, const std::uint32_t pixelSize, const std::uint32_t glyphIndex) {
+	return glyphAtlas.find(fonts, font, pixelSize, glyphIndex);
+}
+
+void TextSystem::beginFrame() {
+	glyphAtlas.beginFrame();
+}
+
+void TextSystem::recordUploads(const VkCommandBuffer& commandBuffer, const std::uint32_t frameSlot) {
+	glyphAtlas.recordUpload(commandBuffer, frameSlot);
+}
+
+const VkImageView& TextSystem::getAtlasImageView() const {
+	return glyphAtlas.getImageView();
+}
+
+void TextSystem::destroy() {
+	spdlog::debug("Shaping cache statistics: {} hits, {} misses", shapingCache.getHitCount(), shapingCache.getMissCount());
+
+	shapingCache.clear();
+	glyphAtlas.destroy();
+	fonts.destroy();
+}
@@ -3,13 +3,45 @@
 #include "spdlog/spdlog.h"
 #include "GLFW/glfw3.h"
 
+#include <algorithm>
+
 using namespace graphics::window;
 
+// Assumed when the monitor does not report its refresh rate
+constexpr std::uint32_t DEFAULT_REFRESH_RATE = 60;
+
+// Distance scrolled by a single step of the scroll wheel, in screen coordinates
+constexpr double SCROLL_STEP_SIZE = 48.0;
+
+// Ratio between framebuffer pixels and screen coordinates, which differ on high-DPI displays
+static std::pair<double, double> getContentScale(GLFWwindow* window) {
+	int windowWidth = 0;
+	int windowHeight = 0;
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	glfwGetWindowSize(window, &windowWidth, &windowHeight);
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+
+	return {
+		windowWidth > 0 ? static_cast<double>(framebufferWidth) / windowWidth : 1.0,
+		windowHeight > 0 ? static_cast<double>(framebufferHeight) / windowHeight : 1.0
+	};
+}
+
 Window::Window(const std::uint32_t width, const std::uint32_t height, const std::string_view& title) :
 	width(width),
 	height(height),
 	title(title),
-	handle(nullptr) {
+	handle(nullptr),
+	isResized(false),
+	hasInput(false),
+	hasCursorMoved(false),
+	cursorX(0.0f),
+	cursorY(0.0f),
+	scrollX(0.0f),
+	scrollY(0.0f),
+	framebufferWidth{ 0 },
+	framebufferHeight{ 0 } {
 	if (glfwInit() != GLFW_TRUE) {
 		spdlog::critical("Unable to initialize GLFW: {}", glfwGetError(nullptr));
 	} else {
@@ -24,13 +56,63 @@ Window::~Window() {
 
 bool Window::create() {
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 	handle = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
 
+	if (handle == nullptr) {
+		return false;
+	}
+
+	int initialWidth = 0;
+	int initialHeight = 0;
+	glfwGetFramebufferSize(handle, &initialWidth, &initialHeight);
+
+	framebufferWidth = static_cast<std::uint32_t>(initialWidth);
+	framebufferHeight = static_cast<std::uint32_t>(initialHeight);
+
+	// Not every platform reports an outdated swapchain after a resize, so the renderer is told explicitly
+	glfwSetWindowUserPointer(handle, this);
+	glfwSetFramebufferSizeCallback(handle, [](GLFWwindow* window, int newWidth, int newHeight) {
+		auto* const self = static_cast<Window*>(glfwGetWindowUserPointer(window));
+
+		self->framebufferWidth = static_cast<std::uint32_t>(std::max(newWidth, 0));
+		self->framebufferHeight = static_cast<std::uint32_t>(std::max(newHeight, 0));
+		self->isResized = true;
+	});
+
+	// Input makes the renderer favor latency over power for a while
+	glfwSetKeyCallback(handle, [](GLFWwindow* window, int, int, int, int) {
+		static_cast<Window*>(glfwGetWindowUserPointer(window))->hasInput = true;
+	});
+
+	glfwSetMouseButtonCallback(handle, [](GLFWwindow* window, int, int, int) {
+		static_cast<Window*>(glfwGetWindowUserPointer(window))->hasInput = true;
+	});
+
+	// GLFW reports scrolling down as a negative offset, steps are accumulated until the compositor picks them up
+	glfwSetScrollCallback(handle, [](GLFWwindow* window, double offsetX, double offsetY) {
+		auto* const self = static_cast<Window*>(glfwGetWindowUserPointer(window));
+		const auto [scaleX, scaleY] = getContentScale(window);
+
+		self->scrollX -= static_cast<float>(offsetX * SCROLL_STEP_SIZE * scaleX);
+		self->scrollY -= static_cast<float>(offsetY * SCROLL_STEP_SIZE * scaleY);
+		self->hasInput = true;
+	});
+
+	// The cursor is reported in screen coordinates, which are not framebuffer pixels on high-DPI displays
+	glfwSetCursorPosCallback(handle, [](GLFWwindow* window, double x, double y) {
+		auto* const self = static_cast<Window*>(glfwGetWindowUserPointer(window));
+		const auto [scaleX, scaleY] = getContentScale(window);
+
+		self->cursorX = static_cast<float>(x * scaleX);
+		self->cursorY = static_cast<float>(y * scaleY);
+		self->hasCursorMoved = true;
+	});
+
 	spdlog::debug("Window created successfully");
 	spdlog::debug("    width:  {}", width);
 	spdlog::debug("    height: {}", height);
-	return handle != nullptr;
+	return true;
 }
 
 bool Window::isAlive() {
@@ -41,6 +123,43 @@ void Window::poll() const {
 	glfwPollEvents();
 }
 
+void Window::wait(const std::chrono::milliseconds timeout) const {
+	glfwWaitEventsTimeout(std::chrono::duration<double>(timeout).count());
+}
+
+void Window::wake() {
+	glfwPostEmptyEvent();
+}
+
+bool Window::consumeResize() {
+	const auto wasResized = isResized;
+	isResized = false;
+
+	return wasResized;
+}
+
+bool Window::consumeInput() {
+	const auto hadInput = hasInput;
+	hasInput = false;
+
+	return hadInput;
+}
+
+bool Window::consumeCursorMove() {
+	const auto hadCursorMoved = hasCursorMoved;
+	hasCursorMoved = false;
+
+	return hadCursorMoved;
+}
+
+std::pair<float, float> Window::consumeScroll() {
+	const auto delta = std::make_pair(scrollX, scrollY);
+	scrollX = 0.0f;
+	scrollY = 0.0f;
+
+	return delta;
+}
+
 void Window::destroy() {
 	if (handle != nullptr) {
 		spdlog::debug("Destroyed GLFW window");
@@ -54,15 +173,34 @@ GLFWwindow* const Window::getRawHandle() const {
 }
 
 std::uint32_t Window::getWidth() const {
-	int widthValue = 0;
-	glfwGetFramebufferSize(handle, &widthValue, nullptr);
-
-	return static_cast<std::uint32_t>(widthValue);
+	return framebufferWidth;
 }
 
 std::uint32_t Window::getHeight() const {
-	int heightValue = 0;
-	glfwGetFramebufferSize(handle, nullptr, &heightValue);
+	return framebufferHeight;
+}
+
+std::uint32_t Window::getRefreshRate() const {
+	// A window that is not fullscreen has no monitor of its own, the primary monitor is the best guess
+	auto* monitor = glfwGetWindowMonitor(handle);
+
+	if (monitor == nullptr) {
+		monitor = glfwGetPrimaryMonitor();
+	}
+
+	const auto* videoMode = monitor != nullptr ? glfwGetVideoMode(monitor) : nullptr;
+
+	if (videoMode == nullptr || videoMode->refreshRate <= 0) {
+		return DEFAULT_REFRESH_RATE;
+	}
+
+	return static_cast<std::uint32_t>(videoMode->refreshRate);
+}
+
+float Window::getCursorX() const {
+	return cursorX;
+}
 
-	return static_cast<std::uint32_t>(heightValue);
+float Window::getCursorY() const {
+	return cursorY;
 }
@@ -0,0 +1,94 @@
+#ifndef LAYOUT_ENGINE_CONSTRAINTS_HPP
+#define LAYOUT_ENGINE_CONSTRAINTS_HPP
+
+#include "layout/text/line_breaker.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace layout::engine {
+
+	// Input to the layout of a single box, handed down by its containing block
+	struct Constraints {
+		// Width of the containing block's content box in pixels
+		float availableWidth;
+
+		bool operator==(const Constraints&) const = default;
+	};
+
+	// Geometry of a laid out box - the position is relative to the parent's border box
+	struct BoxGeometry {
+		float x;
+		float y;
+		float width;
+		float height;
+	};
+
+	// A single line's worth of a text node, the position is relative to the containing block's border box
+	struct TextFragment {
+		std::uint32_t start;
+		std::uint32_t length;
+		float x;
+		float y;
+		float width;
+		float height;
+	};
+
+	// Line break opportunities of a text node and the width of the text between them
+	// Only depends on the text and the font, so lines can be broken again at a different width without measuring anything
+	struct MeasuredText {
+		// Font size the segments were measured at, empty when the text has to be measured again
+		std::optional<float> fontSize;
+
+		std::vector<text::TextSegment> segments;
+		std::vector<float> segmentWidths;
+		float spaceWidth;
+
+		// Returns whether the measurements can be reused for text at the given font size
+		bool isValidFor(const float otherFontSize) const {
+			return fontSize.has_value() && fontSize.value() == otherFontSize;
+		}
+
+		// Throw away the measurements, the text changed
+		void invalidate() {
+			fontSize.reset();
+		}
+	};
+
+	// Per box layout cache, only valid as long as the box is not layout-dirty and the constraints match
+	struct LayoutCache {
+		std::optional<Constraints> constraints;
+		BoxGeometry geometry;
+
+		// Only used by text nodes, which are split into one fragment per line they occupy
+		std::vector<TextFragment> textFragments;
+		MeasuredText measuredText;
+
+		// Fragments of the subtree in the most recently built fragment tree, relative to the first fragment and the origin of the parent node
+		// A subtree that needs no repaint is copied from there, moved along with its containing block
+		bool hasFragments;
+		std::uint32_t fragmentOffset;
+		std::uint32_t fragmentCount;
+		float fragmentOriginX;
+		float fragmentOriginY;
+
+		// Returns whether the cached geometry can be reused for the given constraints
+		bool isValidFor(const Constraints& other) const {
+			return constraints.has_value() && constraints.value() == other;
+		}
+
+		// Throw away the cached result
+		void invalidate() {
+			constraints.reset();
+		}
+
+		// Forget where the fragments of the subtree are, they are rebuilt instead of copied
+		void invalidateFragments() {
+			hasFragments = false;
+		}
+	};
+
+}
+
+#endif // !LAYOUT_ENGINE_CONSTRAINTS_HPP
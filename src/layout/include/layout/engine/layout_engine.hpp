@@ -0,0 +1,116 @@
+#ifndef LAYOUT_ENGINE_LAYOUT_ENGINE_HPP
+#define LAYOUT_ENGINE_LAYOUT_ENGINE_HPP
+
+#include "constraints.hpp"
+
+#include "layout/fragment/fragment_tree.hpp"
+#include "layout/fragment/fragment_tree_builder.hpp"
+#include "layout/style/computed_style.hpp"
+#include "layout/style/style_resolver.hpp"
+#include "layout/text/text_measurer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace core::threading {
+	class ThreadPool;
+}
+
+namespace layout::tree {
+	class Node;
+}
+
+namespace layout::engine {
+
+	// Counters that show how much work an update actually performed
+	struct LayoutStatistics {
+		std::uint32_t stylesRecalculated;
+		std::uint32_t boxesLaidOut;
+		std::uint32_t layoutCacheHits;
+		std::uint32_t formattingContextsLaidOutInParallel;
+		std::uint32_t textNodesMeasured;
+
+		// Set when anything needed a repaint, only the subtrees that did are built again, the rest is copied from the previous tree
+		bool fragmentTreeRebuilt;
+		std::uint32_t fragmentsBuilt;
+		std::uint32_t fragmentsCopied;
+	};
+
+	// Brings the computed style and geometry of a document up to date, visiting dirty subtrees only
+	// Sibling boxes that establish an independent formatting context are laid out concurrently when a thread pool is available
+	// Text is measured with "measureFunction" (must be safe to call from any thread, one call at a time), or estimated when there is none
+	class LayoutEngine final {
+	public:
+		explicit LayoutEngine(core::threading::ThreadPool* threadPool = nullptr, text::MeasureFunction measureFunction = {});
+		LayoutEngine(const LayoutEngine&) = delete;
+		LayoutEngine(LayoutEngine&&) = delete;
+		LayoutEngine& operator=(const LayoutEngine&) = delete;
+		LayoutEngine& operator=(LayoutEngine&&) = delete;
+		~LayoutEngine() = default;
+
+		// Restyle and relayout everything that changed since the previous update
+		LayoutStatistics update(tree::Node& root, const Constraints& viewport);
+
+		// Result of the most recent update, safe to hand over to other threads
+		std::shared_ptr<const fragment::FragmentTree> getFragmentTree() const;
+
+	private:
+		// Recompute the style of dirty nodes, "forced" is set when an inherited property of the parent changed
+		void restyle(tree::Node& node, const style::ComputedStyle& parentStyle, const bool forced);
+
+		// Lay out a box (and its subtree when necessary) and return its geometry
+		BoxGeometry layoutBox(tree::Node& node, const Constraints& constraints);
+
+		// Lay out the children of a block container and return the height of its content
+		float layoutChildren(tree::Node& node, const float contentWidth);
+
+		// Flow a run of consecutive inline-level children into line boxes and return the height of those lines
+		float layoutInlineRun(const std::vector<tree::Node*>& items, const style::ComputedStyle& containerStyle, const float contentWidth, const float startY);
+
+		// Lay out all dirty children that establish an independent formatting context on the thread pool
+		void layoutIndependentContextsInParallel(tree::Node& node, const Constraints& childConstraints);
+
+		// Split a text node at its line break opportunities and measure the text in between, unless that was done before
+		void measureText(tree::Node& textNode);
+
+		// Where the fragments of a parent node start in the tree that is built and in the previous tree, and the origin they were built at
+		// Children store their fragments relative to this, which stays correct when a whole subtree is copied somewhere else
+		struct FragmentAnchor {
+			std::uint32_t start;
+			float originX;
+			float originY;
+
+			// Cleared when the parent has no fragments in the previous tree, its children have nothing to copy then
+			bool hasPrevious;
+			std::uint32_t previousStart;
+			float previousOriginX;
+			float previousOriginY;
+		};
+
+		// Append the fragments of a subtree to the builder, "origin" is the absolute position of the containing block
+		// Subtrees that need no repaint are copied from the previous tree instead of being built again
+		void buildFragments(tree::Node& node, const float originX, const float originY, const std::uint32_t parent, const FragmentAnchor& anchor);
+
+	private:
+		style::StyleResolver styleResolver;
+		core::threading::ThreadPool* threadPool;
+		text::TextMeasurer textMeasurer;
+
+		fragment::FragmentTreeBuilder fragmentTreeBuilder;
+		std::shared_ptr<const fragment::FragmentTree> fragmentTree;
+
+		std::uint32_t stylesRecalculated;
+		std::atomic<std::uint32_t> boxesLaidOut;
+		std::atomic<std::uint32_t> layoutCacheHits;
+		std::uint32_t formattingContextsLaidOutInParallel;
+		std::atomic<std::uint32_t> textNodesMeasured;
+		std::uint32_t fragmentsBuilt;
+		std::uint32_t fragmentsCopied;
+	};
+
+}
+
+#endif // !LAYOUT_ENGINE_LAYOUT_ENGINE_HPP
@@ -0,0 +1,104 @@
+#ifndef LAYOUT_FRAGMENT_FRAGMENT_TREE_HPP
+#define LAYOUT_FRAGMENT_FRAGMENT_TREE_HPP
+
+#include "core/spatial/grid_index.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace layout::fragment {
+
+	enum class FragmentFlags : std::uint8_t {
+		None = 0,
+
+		// Fragment of a block-level box
+		Box = 1 << 0,
+
+		// Fragment of a single line of a text node
+		Text = 1 << 1,
+
+		// The box establishes an independent block formatting context
+		FormattingContextRoot = 1 << 2,
+
+		// The box has a visible background
+		HasBackground = 1 << 3
+	};
+
+	constexpr FragmentFlags operator|(const FragmentFlags lhs, const FragmentFlags rhs) {
+		return static_cast<FragmentFlags>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+	}
+
+	constexpr bool hasFlag(const FragmentFlags flags, const FragmentFlags flag) {
+		return (static_cast<std::uint8_t>(flags) & static_cast<std::uint8_t>(flag)) != 0;
+	}
+
+	// Parent index of fragments without a parent
+	constexpr std::uint32_t NO_PARENT = std::numeric_limits<std::uint32_t>::max();
+
+	// Immutable result of a layout pass, stored as a struct-of-arrays
+	// Fragments are ordered depth-first, so a parent always precedes its children (and paint order is index order)
+	// Once built a tree is never modified, which makes it safe to read from any thread without locks
+	class FragmentTree final {
+	public:
+		friend class FragmentTreeBuilder;
+
+		// Number of fragments in the tree
+		std::size_t size() const;
+
+		// Absolute position of every fragment in pixels
+		std::span<const float> getX() const;
+		std::span<const float> getY() const;
+
+		// Size of every fragment in pixels
+		std::span<const float> getWidth() const;
+		std::span<const float> getHeight() const;
+
+		std::span<const FragmentFlags> getFlags() const;
+		std::span<const std::uint32_t> getParents() const;
+
+		// Paint properties (RGBA)
+		std::span<const std::uint32_t> getColors() const;
+		std::span<const std::uint32_t> getBackgroundColors() const;
+		std::span<const float> getFontSizes() const;
+
+		// Text of a text fragment, empty for any other fragment
+		std::string_view getText(const std::size_t index) const;
+
+		// Returns the topmost fragment (the last one in paint order) at a point in page coordinates
+		std::optional<std::uint32_t> hitTest(const float pointX, const float pointY) const;
+
+	private:
+		// Should not be instantiated directly - please use "FragmentTreeBuilder" instead
+		FragmentTree() = default;
+
+	private:
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> width;
+		std::vector<float> height;
+
+		std::vector<FragmentFlags> flags;
+		std::vector<std::uint32_t> parents;
+
+		std::vector<std::uint32_t> colors;
+		std::vector<std::uint32_t> backgroundColors;
+		std::vector<float> fontSizes;
+
+		// All text of the document is stored back to back, fragments refer to a range within this buffer
+		std::vector<std::uint32_t> textOffsets;
+		std::vector<std::uint32_t> textLengths;
+		std::string text;
+
+		// Grid over the bounds of every fragment, shares the cells that did not change with the index of the previous tree
+		std::shared_ptr<const core::spatial::GridIndex> spatialIndex;
+	};
+
+}
+
+#endif // !LAYOUT_FRAGMENT_FRAGMENT_TREE_HPP
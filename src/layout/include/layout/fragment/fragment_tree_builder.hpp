@@ -0,0 +1,60 @@
+#ifndef LAYOUT_FRAGMENT_FRAGMENT_TREE_BUILDER_HPP
+#define LAYOUT_FRAGMENT_FRAGMENT_TREE_BUILDER_HPP
+
+#include "fragment_tree.hpp"
+
+#include "core/spatial/grid_index.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace layout::fragment {
+
+	// Geometry and paint properties of a fragment that is about to be added to a tree
+	struct FragmentDescription {
+		float x;
+		float y;
+		float width;
+		float height;
+		FragmentFlags flags;
+		std::uint32_t parent;
+		std::uint32_t color;
+		std::uint32_t backgroundColor;
+		float fontSize;
+	};
+
+	// Builder for fragment trees
+	class FragmentTreeBuilder final {
+	public:
+		// Create a new builder, the capacity is a hint for the expected number of fragments
+		explicit FragmentTreeBuilder(const std::size_t capacity = 0);
+
+		// Add a box fragment and return its index
+		std::uint32_t addBox(const FragmentDescription& description);
+
+		// Add a text fragment and return its index
+		std::uint32_t addText(const FragmentDescription& description, const std::string_view& text);
+
+		// Copy "count" fragments starting at "first" from another tree, moved by an offset, and return the index of the first copy
+		// The range must be a whole subtree, fragments whose parent is outside of it get "parent" as their new parent
+		std::uint32_t addRange(const FragmentTree& source, const std::uint32_t first, const std::uint32_t count, const std::uint32_t parent, const float offsetX, const float offsetY);
+
+		// Number of fragments added since the last build
+		std::uint32_t size() const;
+
+		// Finish the tree - the builder is empty afterwards and may be reused
+		// The spatial index is updated from the tree that was built before, fragments are matched by index
+		std::shared_ptr<const FragmentTree> build();
+
+	private:
+		std::unique_ptr<FragmentTree> tree;
+
+		core::spatial::GridIndexBuilder spatialIndexBuilder;
+		std::vector<core::spatial::Bounds> fragmentBounds;
+	};
+
+}
+
+#endif // !LAYOUT_FRAGMENT_FRAGMENT_TREE_BUILDER_HPP
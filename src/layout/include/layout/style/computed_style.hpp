@@ -0,0 +1,66 @@
+#ifndef LAYOUT_STYLE_COMPUTED_STYLE_HPP
+#define LAYOUT_STYLE_COMPUTED_STYLE_HPP
+
+#include <cstdint>
+#include <optional>
+
+namespace layout::style {
+
+	enum class Display {
+		// Generates a box that starts on a new line and fills its containing block
+		Block,
+
+		// Generates a box that flows along with the surrounding text
+		Inline,
+
+		// Block box that establishes a new, independent block formatting context
+		FlowRoot,
+
+		// Generates no box at all
+		None
+	};
+
+	// Size of each side of a box in pixels
+	struct Edges {
+		float top;
+		float right;
+		float bottom;
+		float left;
+
+		bool operator==(const Edges&) const = default;
+	};
+
+	// The final value of every property the layout engine cares about
+	struct ComputedStyle {
+		Display display;
+
+		// Empty when the size should be determined by the box's content ("auto")
+		std::optional<float> width;
+		std::optional<float> height;
+
+		Edges margin;
+		Edges padding;
+
+		// Inherited properties
+		float fontSize;
+		float lineHeight;
+		std::uint32_t color;
+
+		// Non-inherited paint properties (RGBA, zero alpha means transparent)
+		std::uint32_t backgroundColor;
+
+		bool operator==(const ComputedStyle&) const = default;
+
+		// Returns whether a change from "other" to this style requires the box to be laid out again
+		bool affectsLayoutComparedTo(const ComputedStyle& other) const;
+
+		// Returns whether a change from "other" to this style changes a property children inherit
+		bool affectsInheritanceComparedTo(const ComputedStyle& other) const;
+	};
+
+	// Style of the initial containing block, which every root element inherits from
+	ComputedStyle initialStyle();
+
+}
+
+#endif // !LAYOUT_STYLE_COMPUTED_STYLE_HPP
@@ -0,0 +1,27 @@
+#ifndef LAYOUT_STYLE_STYLE_RESOLVER_HPP
+#define LAYOUT_STYLE_STYLE_RESOLVER_HPP
+
+#include "computed_style.hpp"
+
+#include <string_view>
+
+namespace layout::tree {
+	class Node;
+}
+
+namespace layout::style {
+
+	// Computes the style of a node from its tag, its inline "style" attribute and its parent's style
+	class StyleResolver final {
+	public:
+		// Resolve the computed style of a node - the parent style is used for inherited properties
+		ComputedStyle resolve(const tree::Node& node, const ComputedStyle& parentStyle) const;
+
+	private:
+		// Apply a single "property: value" declaration to a style
+		void applyDeclaration(ComputedStyle& style, const std::string_view& property, const std::string_view& value) const;
+	};
+
+}
+
+#endif // !LAYOUT_STYLE_STYLE_RESOLVER_HPP
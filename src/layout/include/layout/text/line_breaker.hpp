@@ -0,0 +1,125 @@
+#ifndef LAYOUT_TEXT_LINE_BREAKER_HPP
+#define LAYOUT_TEXT_LINE_BREAKER_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace layout::text {
+
+	// Line breaking classes of the Unicode line breaking algorithm, classes that are resolved to another class are left out
+	// Reference: https://www.unicode.org/reports/tr14/#Table1
+	enum class BreakClass : std::uint8_t {
+		// AL - letters and most symbols
+		Alphabetic,
+
+		// BA - spaces that are not SP, and hyphens that allow a break after them
+		BreakAfter,
+
+		// BB - characters that allow a break before them
+		BreakBefore,
+
+		// B2 - em dash, breaks are allowed before and after it, but not between two of them
+		BreakBoth,
+
+		// BK - forces a break after it
+		MandatoryBreak,
+
+		// CL - closing punctuation
+		ClosePunctuation,
+
+		// CM - combining marks and control characters, which take the class of the character they follow
+		CombiningMark,
+
+		// CP - closing parenthesis
+		CloseParenthesis,
+
+		// CR
+		CarriageReturn,
+
+		// EX - exclamation and interrogation marks
+		Exclamation,
+
+		// GL - non-breaking glue like the no-break space
+		Glue,
+
+		// HY - hyphen-minus
+		Hyphen,
+
+		// ID - ideographs, a break is allowed between any two of them
+		Ideographic,
+
+		// IN - ellipsis and leaders
+		Inseparable,
+
+		// IS - separators within numbers
+		InfixSeparator,
+
+		// LF
+		LineFeed,
+
+		// NL
+		NextLine,
+
+		// NS - characters that may not start a line, like small kana and iteration marks
+		Nonstarter,
+
+		// NU - digits
+		Numeric,
+
+		// OP - opening punctuation
+		OpenPunctuation,
+
+		// PO - characters that follow a number, like a percent sign
+		PostfixNumeric,
+
+		// PR - characters that precede a number, like currency symbols
+		PrefixNumeric,
+
+		// QU - quotation marks
+		Quotation,
+
+		// RI - regional indicators, pairs of which form a flag
+		RegionalIndicator,
+
+		// SP
+		Space,
+
+		// SY - the slash, which allows a break after it except before a digit
+		Symbol,
+
+		// WJ - word joiner
+		WordJoiner,
+
+		// ZW - zero width space
+		ZeroWidthSpace,
+
+		// ZWJ - zero width joiner
+		ZeroWidthJoiner
+	};
+
+	// Text between two line break opportunities
+	struct TextSegment {
+		// Byte offset of the segment in the text
+		std::uint32_t start;
+
+		// Size in bytes without the whitespace at the end, which hangs past the end of a line and is never measured
+		std::uint32_t length;
+
+		// Size in bytes of the whitespace at the end
+		std::uint32_t whitespaceLength;
+
+		// The line has to end after this segment, it ends in a line feed or another line separator
+		bool isMandatoryBreak;
+	};
+
+	// Returns the line breaking class of a code point
+	BreakClass getBreakClass(const char32_t codePoint);
+
+	// Split UTF-8 encoded text at every line break opportunity, following the Unicode line breaking algorithm (UAX #14)
+	// Dictionary based breaking of languages that do not separate words (Thai, Lao, ...) is not supported
+	void findTextSegments(const std::string_view& text, std::vector<TextSegment>& segments);
+
+}
+
+#endif // !LAYOUT_TEXT_LINE_BREAKER_HPP
@@ -0,0 +1,68 @@
+#ifndef LAYOUT_TEXT_TEXT_MEASURER_HPP
+#define LAYOUT_TEXT_TEXT_MEASURER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace layout::text {
+
+	// Returns the advance of a run of UTF-8 encoded text in pixels at the given font size
+	using MeasureFunction = std::function<float(const std::string_view& text, const float fontSize)>;
+
+	// Caches the width of every piece of text that was measured, separately for every font size
+	// Safe to use from multiple threads, only measuring text that was not seen before is serialized
+	class TextMeasurer final {
+	public:
+		// Without a measure function, widths are estimated from the number of characters
+		explicit TextMeasurer(MeasureFunction measureFunction = {});
+		TextMeasurer(const TextMeasurer&) = delete;
+		TextMeasurer(TextMeasurer&&) = delete;
+		TextMeasurer& operator=(const TextMeasurer&) = delete;
+		TextMeasurer& operator=(TextMeasurer&&) = delete;
+		~TextMeasurer() = default;
+
+		// Width of a run of text in pixels
+		float measure(const std::string_view& text, const float fontSize);
+
+		// Forget all measured widths
+		void clear();
+
+		std::size_t getHitCount() const;
+		std::size_t getMissCount() const;
+
+	private:
+		// Allows looking up widths by string view, without allocating a string for every lookup
+		struct TextHash {
+			using is_transparent = void;
+
+			std::size_t operator()(const std::string_view& text) const {
+				return std::hash<std::string_view>{}(text);
+			}
+		};
+
+		using WidthTable = std::unordered_map<std::string, float, TextHash, std::equal_to<>>;
+
+		// Width of a run of text when no measure function is available
+		static float estimate(const std::string_view& text, const float fontSize);
+
+	private:
+		MeasureFunction measureFunction;
+
+		// Also serializes calls to the measure function, which does not have to be thread-safe
+		std::shared_mutex mutex;
+		std::map<float, WidthTable> widthsByFontSize;
+		std::size_t entryCount;
+
+		std::atomic<std::size_t> hitCount;
+		std::atomic<std::size_t> missCount;
+	};
+
+}
+
+#endif // !LAYOUT_TEXT_TEXT_MEASURER_HPP
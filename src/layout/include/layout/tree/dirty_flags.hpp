@@ -0,0 +1,76 @@
+#ifndef LAYOUT_TREE_DIRTY_FLAGS_HPP
+#define LAYOUT_TREE_DIRTY_FLAGS_HPP
+
+#include <cstdint>
+
+namespace layout::tree {
+
+	enum class DirtyFlags : std::uint8_t {
+		None = 0,
+
+		// The computed style of this node is out of date
+		Style = 1 << 0,
+
+		// The size or position of this node's box is out of date
+		Layout = 1 << 1,
+
+		// The box needs to be repainted, but its geometry is still valid
+		Paint = 1 << 2,
+
+		// At least one descendant has an out of date computed style
+		DescendantStyle = 1 << 3,
+
+		// At least one descendant needs to be laid out again
+		DescendantLayout = 1 << 4,
+
+		// At least one descendant needs to be repainted
+		DescendantPaint = 1 << 5
+	};
+
+	constexpr DirtyFlags operator|(const DirtyFlags lhs, const DirtyFlags rhs) {
+		return static_cast<DirtyFlags>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+	}
+
+	constexpr DirtyFlags operator&(const DirtyFlags lhs, const DirtyFlags rhs) {
+		return static_cast<DirtyFlags>(static_cast<std::uint8_t>(lhs) & static_cast<std::uint8_t>(rhs));
+	}
+
+	constexpr DirtyFlags operator~(const DirtyFlags flags) {
+		return static_cast<DirtyFlags>(~static_cast<std::uint8_t>(flags));
+	}
+
+	constexpr DirtyFlags& operator|=(DirtyFlags& lhs, const DirtyFlags rhs) {
+		return lhs = lhs | rhs;
+	}
+
+	constexpr DirtyFlags& operator&=(DirtyFlags& lhs, const DirtyFlags rhs) {
+		return lhs = lhs & rhs;
+	}
+
+	// Returns whether any of the bits in "mask" are set in "flags"
+	constexpr bool hasAny(const DirtyFlags flags, const DirtyFlags mask) {
+		return (flags & mask) != DirtyFlags::None;
+	}
+
+	// Map a node's own dirty bits onto the bits its ancestors should receive
+	constexpr DirtyFlags toDescendantFlags(const DirtyFlags flags) {
+		auto result = DirtyFlags::None;
+
+		if (hasAny(flags, DirtyFlags::Style | DirtyFlags::DescendantStyle)) {
+			result |= DirtyFlags::DescendantStyle;
+		}
+
+		if (hasAny(flags, DirtyFlags::Layout | DirtyFlags::DescendantLayout)) {
+			result |= DirtyFlags::DescendantLayout;
+		}
+
+		if (hasAny(flags, DirtyFlags::Paint | DirtyFlags::DescendantPaint)) {
+			result |= DirtyFlags::DescendantPaint;
+		}
+
+		return result;
+	}
+
+}
+
+#endif // !LAYOUT_TREE_DIRTY_FLAGS_HPP
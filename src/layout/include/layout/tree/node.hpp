@@ -0,0 +1,102 @@
+#ifndef LAYOUT_TREE_NODE_HPP
+#define LAYOUT_TREE_NODE_HPP
+
+#include "dirty_flags.hpp"
+
+#include "layout/engine/constraints.hpp"
+#include "layout/style/computed_style.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace layout::tree {
+
+	enum class NodeType {
+		Element,
+		Text
+	};
+
+	// A single node in the document tree, together with the style and layout state derived from it
+	class Node final {
+	public:
+		Node(const NodeType type, const std::string_view& tagNameOrText);
+		Node(const Node&) = delete;
+		Node(Node&&) = delete;
+		Node& operator=(const Node&) = delete;
+		Node& operator=(Node&&) = delete;
+		~Node() = default;
+
+		// Create a new element node
+		static std::unique_ptr<Node> createElement(const std::string_view& tagName);
+
+		// Create a new text node
+		static std::unique_ptr<Node> createText(const std::string_view& text);
+
+		// Add a node as the last child of this node and return a reference to it
+		Node& appendChild(std::unique_ptr<Node> child);
+
+		// Remove a child from this node and hand ownership back to the caller
+		std::unique_ptr<Node> removeChild(Node& child);
+
+		// Set an attribute - invalidates the style of this node
+		void setAttribute(const std::string_view& name, const std::string_view& value);
+
+		// Remove an attribute - invalidates the style of this node
+		void removeAttribute(const std::string_view& name);
+
+		// Change the contents of a text node - invalidates the layout of this node
+		void setText(const std::string_view& text);
+
+		// Flag this node as dirty and notify all ancestors that one of their descendants is dirty
+		void markDirty(const DirtyFlags flags);
+
+		// Flag this node as dirty without notifying its ancestors - the caller is responsible for the ancestor chain
+		// Unlike "markDirty", this only touches the node itself and is safe to use while its siblings are laid out in parallel
+		void markDirtyLocally(const DirtyFlags flags);
+
+		// Clear the given dirty bits on this node only
+		void clearDirty(const DirtyFlags flags);
+
+		// Returns whether any of the given dirty bits are set
+		bool isDirty(const DirtyFlags flags) const;
+
+		// Returns the value of an attribute, or nullptr if the attribute does not exist
+		const std::string* getAttribute(const std::string_view& name) const;
+
+		NodeType getType() const;
+		const std::string& getTagName() const;
+		const std::string& getText() const;
+		DirtyFlags getDirtyFlags() const;
+
+		Node* getParent() const;
+		const std::vector<std::unique_ptr<Node>>& getChildren() const;
+
+		const style::ComputedStyle& getComputedStyle() const;
+		void setComputedStyle(const style::ComputedStyle& style);
+
+		engine::LayoutCache& getLayoutCache();
+		const engine::LayoutCache& getLayoutCache() const;
+
+	private:
+		NodeType type;
+
+		// Tag name for elements, contents for text nodes
+		std::string tagNameOrText;
+
+		std::map<std::string, std::string, std::less<>> attributes;
+
+		Node* parent;
+		std::vector<std::unique_ptr<Node>> children;
+
+		DirtyFlags dirtyFlags;
+
+		style::ComputedStyle computedStyle;
+		engine::LayoutCache layoutCache;
+	};
+
+}
+
+#endif // !LAYOUT_TREE_NODE_HPP
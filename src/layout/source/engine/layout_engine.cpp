@@ -0,0 +1,486 @@
+#include "layout/engine/layout_engine.hpp"
+#include "layout/tree/node.hpp"
+
+#include "core/threading/thread_pool.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+
+using namespace layout::engine;
+using namespace layout::fragment;
+using namespace layout::style;
+using namespace layout::tree;
+
+// Fewer independent formatting contexts than this are not worth the overhead of dispatching to the thread pool
+constexpr std::size_t MINIMUM_PARALLEL_FORMATTING_CONTEXTS = 2;
+
+// Clear dirty bits throughout a subtree, only descending into nodes that actually have dirty descendants
+static void clearDirtySubtree(Node& node, const DirtyFlags flags) {
+	const auto allFlags = flags | toDescendantFlags(flags);
+
+	if (!node.isDirty(allFlags)) {
+		return;
+	}
+
+	node.clearDirty(allFlags);
+
+	for (const auto& child : node.getChildren()) {
+		clearDirtySubtree(*child, flags);
+	}
+}
+
+LayoutEngine::LayoutEngine(core::threading::ThreadPool* threadPool, text::MeasureFunction measureFunction) :
+	styleResolver{},
+	threadPool(threadPool),
+	textMeasurer{ std::move(measureFunction) },
+	fragmentTreeBuilder{},
+	fragmentTree{ fragmentTreeBuilder.build() },
+	stylesRecalculated{ 0 },
+	boxesLaidOut{ 0 },
+	layoutCacheHits{ 0 },
+	formattingContextsLaidOutInParallel{ 0 },
+	textNodesMeasured{ 0 },
+	fragmentsBuilt{ 0 },
+	fragmentsCopied{ 0 } {}
+
+LayoutStatistics LayoutEngine::update(Node& root, const Constraints& viewport) {
+	stylesRecalculated = 0;
+	boxesLaidOut = 0;
+	layoutCacheHits = 0;
+	formattingContextsLaidOutInParallel = 0;
+	textNodesMeasured = 0;
+	fragmentsBuilt = 0;
+	fragmentsCopied = 0;
+
+	restyle(root, initialStyle(), false);
+
+	const auto geometry = layoutBox(root, viewport);
+	root.getLayoutCache().geometry.x = 0.0f;
+	root.getLayoutCache().geometry.y = 0.0f;
+
+	// The fragment tree only has to be rebuilt when something visible changed
+	const auto rebuildFragmentTree = root.isDirty(DirtyFlags::Paint | DirtyFlags::DescendantPaint);
+
+	if (rebuildFragmentTree) {
+		buildFragments(root, 0.0f, 0.0f, NO_PARENT, { 0, 0.0f, 0.0f, true, 0, 0.0f, 0.0f });
+		fragmentTree = fragmentTreeBuilder.build();
+	}
+
+	LayoutStatistics statistics{};
+	statistics.stylesRecalculated = stylesRecalculated;
+	statistics.boxesLaidOut = boxesLaidOut;
+	statistics.layoutCacheHits = layoutCacheHits;
+	statistics.formattingContextsLaidOutInParallel = formattingContextsLaidOutInParallel;
+	statistics.textNodesMeasured = textNodesMeasured;
+	statistics.fragmentTreeRebuilt = rebuildFragmentTree;
+	statistics.fragmentsBuilt = fragmentsBuilt;
+	statistics.fragmentsCopied = fragmentsCopied;
+
+	spdlog::trace("Layout updated ({}x{}): {} styles recalculated, {} boxes laid out ({} in parallel), {} cache hits, {} text nodes measured, {} fragments ({} built, {} copied)",
+		geometry.width, geometry.height, statistics.stylesRecalculated, statistics.boxesLaidOut, statistics.formattingContextsLaidOutInParallel,
+		statistics.layoutCacheHits, statistics.textNodesMeasured, fragmentTree->size(), statistics.fragmentsBuilt, statistics.fragmentsCopied);
+
+	return statistics;
+}
+
+std::shared_ptr<const FragmentTree> LayoutEngine::getFragmentTree() const {
+	return fragmentTree;
+}
+
+void LayoutEngine::restyle(Node& node, const ComputedStyle& parentStyle, const bool forced) {
+	if (!forced && !node.isDirty(DirtyFlags::Style | DirtyFlags::DescendantStyle)) {
+		return;
+	}
+
+	auto forceChildren = false;
+
+	if (forced || node.isDirty(DirtyFlags::Style)) {
+		const auto previousStyle = node.getComputedStyle();
+		const auto style = styleResolver.resolve(node, parentStyle);
+		++stylesRecalculated;
+
+		if (style != previousStyle) {
+			// Only geometry affecting properties require a relayout, anything else merely needs a repaint
+			node.markDirty(style.affectsLayoutComparedTo(previousStyle) ? DirtyFlags::Layout | DirtyFlags::Paint : DirtyFlags::Paint);
+			forceChildren = style.affectsInheritanceComparedTo(previousStyle);
+			node.setComputedStyle(style);
+		}
+
+		node.clearDirty(DirtyFlags::Style);
+	}
+
+	for (const auto& child : node.getChildren()) {
+		restyle(*child, node.getComputedStyle(), forceChildren);
+	}
+
+	// Descendant bits may only be cleared once the entire subtree is clean, ancestors rely on this invariant
+	node.clearDirty(DirtyFlags::DescendantStyle);
+}
+
+BoxGeometry LayoutEngine::layoutBox(Node& node, const Constraints& constraints) {
+	auto& cache = node.getLayoutCache();
+
+	// Clean boxes that are asked to lay out under the same constraints as last time are skipped entirely
+	if (!node.isDirty(DirtyFlags::Layout | DirtyFlags::DescendantLayout) && cache.isValidFor(constraints)) {
+		++layoutCacheHits;
+		return cache.geometry;
+	}
+
+	++boxesLaidOut;
+
+	const auto& style = node.getComputedStyle();
+	const auto previousGeometry = cache.geometry;
+	BoxGeometry geometry{ previousGeometry.x, previousGeometry.y, 0.0f, 0.0f };
+
+	if (style.display == Display::None) {
+		clearDirtySubtree(node, DirtyFlags::Layout);
+	} else {
+		const auto horizontalPadding = style.padding.left + style.padding.right;
+		const auto contentWidth = std::max(0.0f, style.width.value_or(constraints.availableWidth - style.margin.left - style.margin.right - horizontalPadding));
+		const auto contentHeight = layoutChildren(node, contentWidth);
+
+		geometry.width = contentWidth + horizontalPadding;
+		geometry.height = style.height.value_or(contentHeight) + style.padding.top + style.padding.bottom;
+	}
+
+	// Ancestors are not notified here, because siblings may be laid out concurrently - parents pick this up themselves
+	if (geometry.width != previousGeometry.width || geometry.height != previousGeometry.height) {
+		node.markDirtyLocally(DirtyFlags::Paint);
+	}
+
+	cache.constraints = constraints;
+	cache.geometry = geometry;
+	node.clearDirty(DirtyFlags::Layout | DirtyFlags::DescendantLayout);
+
+	return geometry;
+}
+
+float LayoutEngine::layoutChildren(Node& node, const float contentWidth) {
+	const auto& style = node.getComputedStyle();
+	const Constraints childConstraints{ contentWidth };
+
+	layoutIndependentContextsInParallel(node, childConstraints);
+
+	auto contentHeight = 0.0f;
+	std::vector<Node*> inlineRun;
+
+	const auto flushInlineRun = [&]() {
+		if (!inlineRun.empty()) {
+			contentHeight += layoutInlineRun(inlineRun, style, contentWidth, style.padding.top + contentHeight);
+			inlineRun.clear();
+		}
+	};
+
+	for (const auto& child : node.getChildren()) {
+		const auto& childStyle = child->getComputedStyle();
+
+		if (childStyle.display == Display::None) {
+			clearDirtySubtree(*child, DirtyFlags::Layout);
+			continue;
+		}
+
+		if (childStyle.display == Display::Inline) {
+			inlineRun.push_back(child.get());
+			continue;
+		}
+
+		flushInlineRun();
+
+		const auto childGeometry = layoutBox(*child, childConstraints);
+
+		// Block-level children are stacked vertically, positioned relative to this box's border box
+		auto& childCache = child->getLayoutCache();
+		const auto x = style.padding.left + childStyle.margin.left;
+		const auto y = style.padding.top + contentHeight + childStyle.margin.top;
+
+		if (childCache.geometry.x != x || childCache.geometry.y != y) {
+			childCache.geometry.x = x;
+			childCache.geometry.y = y;
+			child->markDirtyLocally(DirtyFlags::Paint);
+		}
+
+		contentHeight += childStyle.margin.top + childGeometry.height + childStyle.margin.bottom;
+	}
+
+	flushInlineRun();
+
+	for (const auto& child : node.getChildren()) {
+		if (child->isDirty(DirtyFlags::Paint | DirtyFlags::DescendantPaint)) {
+			node.markDirtyLocally(DirtyFlags::DescendantPaint);
+			break;
+		}
+	}
+
+	return contentHeight;
+}
+
+float LayoutEngine::layoutInlineRun(const std::vector<Node*>& items, const ComputedStyle& containerStyle, const float contentWidth, const float startY) {
+	auto lineX = 0.0f;
+	auto lineY = startY;
+	auto lineHeight = 0.0f;
+	auto pendingSpace = false;
+
+	const auto placeText = [&](Node& textNode) {
+		++boxesLaidOut;
+
+		const auto& style = textNode.getComputedStyle();
+		measureText(textNode);
+
+		auto& cache = textNode.getLayoutCache();
+		const auto& measuredText = cache.measuredText;
+
+		auto& fragments = cache.textFragments;
+		fragments.clear();
+
+		// Only line breaks are placed here, the segments were measured when the text or its font last changed
+		for (std::size_t i = 0; i < measuredText.segments.size(); ++i) {
+			const auto& segment = measuredText.segments[i];
+
+			// Whitespace hangs past the end of the line, consecutive whitespace collapses into a single space between words
+			// Line feeds collapse as well, which makes mandatory breaks irrelevant as long as whitespace is never preserved
+			if (segment.length == 0) {
+				pendingSpace = pendingSpace || segment.whitespaceLength > 0;
+				continue;
+			}
+
+			const auto wordStart = static_cast<std::size_t>(segment.start);
+			const auto position = wordStart + segment.length;
+			const auto wordWidth = measuredText.segmentWidths[i];
+			const auto spacing = pendingSpace && lineX > 0.0f ? measuredText.spaceWidth : 0.0f;
+			pendingSpace = segment.whitespaceLength > 0;
+
+			// Break the line when the word does not fit, unless it is the first word on the line
+			if (lineX > 0.0f && lineX + spacing + wordWidth > contentWidth) {
+				lineY += lineHeight;
+				lineX = 0.0f;
+				lineHeight = 0.0f;
+			} else {
+				lineX += spacing;
+			}
+
+			lineHeight = std::max(lineHeight, style.lineHeight);
+
+			const auto x = containerStyle.padding.left + lineX;
+
+			// Words on the same line are merged into a single fragment
+			if (!fragments.empty() && fragments.back().y == lineY) {
+				auto& fragment = fragments.back();
+				fragment.length = static_cast<std::uint32_t>(position - fragment.start);
+				fragment.width = x + wordWidth - fragment.x;
+			} else {
+				fragments.push_back({ segment.start, segment.length, x, lineY, wordWidth, style.lineHeight });
+			}
+
+			lineX += wordWidth;
+		}
+	};
+
+	// A block-level box inside an inline element splits the run, as if the lines before and after it were wrapped in anonymous blocks
+	// It is laid out like any other block-level child and stacked below the current line
+	const auto placeBlock = [&](Node& block) {
+		if (lineX > 0.0f || lineHeight > 0.0f) {
+			lineY += lineHeight;
+			lineX = 0.0f;
+			lineHeight = 0.0f;
+		}
+
+		pendingSpace = false;
+
+		const auto& blockStyle = block.getComputedStyle();
+		const auto blockGeometry = layoutBox(block, Constraints{ contentWidth });
+
+		auto& blockCache = block.getLayoutCache();
+		const auto x = containerStyle.padding.left + blockStyle.margin.left;
+		const auto y = lineY + blockStyle.margin.top;
+
+		if (blockCache.geometry.x != x || blockCache.geometry.y != y) {
+			blockCache.geometry.x = x;
+			blockCache.geometry.y = y;
+			block.markDirtyLocally(DirtyFlags::Paint);
+		}
+
+		lineY += blockStyle.margin.top + blockGeometry.height + blockStyle.margin.bottom;
+	};
+
+	// Inline elements do not generate boxes of their own, only the text inside of them is placed on lines
+	const auto placeInline = [&](const auto& self, Node& node) -> void {
+		const auto display = node.getComputedStyle().display;
+
+		if (display == Display::None) {
+			clearDirtySubtree(node, DirtyFlags::Layout);
+			return;
+		}
+
+		if (node.getType() != NodeType::Text && display != Display::Inline) {
+			placeBlock(node);
+			return;
+		}
+
+		node.clearDirty(DirtyFlags::Layout | DirtyFlags::DescendantLayout);
+		node.markDirtyLocally(DirtyFlags::Paint);
+
+		if (node.getType() == NodeType::Text) {
+			placeText(node);
+			return;
+		}
+
+		for (const auto& child : node.getChildren()) {
+			self(self, *child);
+		}
+	};
+
+	for (const auto item : items) {
+		placeInline(placeInline, *item);
+	}
+
+	return lineY + lineHeight - startY;
+}
+
+void LayoutEngine::layoutIndependentContextsInParallel(Node& node, const Constraints& childConstraints) {
+	// Nested formatting contexts inside a parallel task are laid out serially, waiting on the pool from within the pool could deadlock
+	if (threadPool == nullptr || threadPool->isWorkerThread()) {
+		return;
+	}
+
+	std::vector<Node*> candidates;
+
+	for (const auto& child : node.getChildren()) {
+		const auto isIndependent = child->getComputedStyle().display == Display::FlowRoot;
+		const auto needsLayout = child->isDirty(DirtyFlags::Layout | DirtyFlags::DescendantLayout) || !child->getLayoutCache().isValidFor(childConstraints);
+
+		if (isIndependent && needsLayout) {
+			candidates.push_back(child.get());
+		}
+	}
+
+	if (candidates.size() < MINIMUM_PARALLEL_FORMATTING_CONTEXTS) {
+		return;
+	}
+
+	// The layout of an independent formatting context only depends on its constraints, so each subtree can be processed in isolation
+	// Placing the resulting boxes is left to the serial pass, which will find the geometry of these subtrees in their layout caches
+	std::vector<std::future<BoxGeometry>> results;
+	results.reserve(candidates.size());
+
+	for (const auto candidate : candidates) {
+		results.push_back(threadPool->submit([this, candidate, childConstraints]() {
+			return layoutBox(*candidate, childConstraints);
+		}));
+	}
+
+	for (auto& result : results) {
+		result.get();
+	}
+
+	formattingContextsLaidOutInParallel += static_cast<std::uint32_t>(candidates.size());
+}
+
+void LayoutEngine::measureText(Node& textNode) {
+	const auto fontSize = textNode.getComputedStyle().fontSize;
+	auto& measuredText = textNode.getLayoutCache().measuredText;
+
+	if (measuredText.isValidFor(fontSize)) {
+		return;
+	}
+
+	++textNodesMeasured;
+
+	const auto text = std::string_view(textNode.getText());
+	text::findTextSegments(text, measuredText.segments);
+
+	measuredText.segmentWidths.resize(measuredText.segments.size());
+	measuredText.spaceWidth = textMeasurer.measure(" ", fontSize);
+	measuredText.fontSize = fontSize;
+
+	for (std::size_t i = 0; i < measuredText.segments.size(); ++i) {
+		const auto& segment = measuredText.segments[i];
+		measuredText.segmentWidths[i] = segment.length > 0 ? textMeasurer.measure(text.substr(segment.start, segment.length), fontSize) : 0.0f;
+	}
+}
+
+void LayoutEngine::buildFragments(Node& node, const float originX, const float originY, const std::uint32_t parent, const FragmentAnchor& anchor) {
+	const auto& style = node.getComputedStyle();
+	auto& cache = node.getLayoutCache();
+
+	const auto start = fragmentTreeBuilder.size();
+	const auto hasPrevious = anchor.hasPrevious && cache.hasFragments;
+	const auto previousStart = anchor.previousStart + cache.fragmentOffset;
+	const auto previousOriginX = anchor.previousOriginX + cache.fragmentOriginX;
+	const auto previousOriginY = anchor.previousOriginY + cache.fragmentOriginY;
+
+	cache.hasFragments = true;
+	cache.fragmentOffset = start - anchor.start;
+	cache.fragmentOriginX = originX - anchor.originX;
+	cache.fragmentOriginY = originY - anchor.originY;
+
+	// Nothing in the subtree changed its appearance or its position relative to the containing block
+	if (hasPrevious && !node.isDirty(DirtyFlags::Paint | DirtyFlags::DescendantPaint)) {
+		fragmentTreeBuilder.addRange(*fragmentTree, previousStart, cache.fragmentCount, parent, originX - previousOriginX, originY - previousOriginY);
+		fragmentsCopied += cache.fragmentCount;
+		return;
+	}
+
+	// The descendants of a hidden node are not visited, what they remember about their fragments is outdated once it is shown again
+	if (style.display == Display::None) {
+		clearDirtySubtree(node, DirtyFlags::Paint);
+		cache.hasFragments = false;
+		return;
+	}
+
+	node.clearDirty(DirtyFlags::Paint | DirtyFlags::DescendantPaint);
+
+	const FragmentAnchor childAnchor{ start, originX, originY, hasPrevious, previousStart, previousOriginX, previousOriginY };
+
+	if (node.getType() == NodeType::Text) {
+		for (const auto& textFragment : cache.textFragments) {
+			FragmentDescription description{};
+			description.x = originX + textFragment.x;
+			description.y = originY + textFragment.y;
+			description.width = textFragment.width;
+			description.height = textFragment.height;
+			description.flags = FragmentFlags::Text;
+			description.parent = parent;
+			description.color = style.color;
+			description.fontSize = style.fontSize;
+
+			fragmentTreeBuilder.addText(description, std::string_view(node.getText()).substr(textFragment.start, textFragment.length));
+			++fragmentsBuilt;
+		}
+	} else if (style.display == Display::Inline) {
+		// Inline elements have no box of their own, their text is positioned relative to the containing block
+		for (const auto& child : node.getChildren()) {
+			buildFragments(*child, originX, originY, parent, childAnchor);
+		}
+	} else {
+		FragmentDescription description{};
+		description.x = originX + cache.geometry.x;
+		description.y = originY + cache.geometry.y;
+		description.width = cache.geometry.width;
+		description.height = cache.geometry.height;
+		description.flags = FragmentFlags::Box;
+		description.parent = parent;
+		description.color = style.color;
+		description.backgroundColor = style.backgroundColor;
+		description.fontSize = style.fontSize;
+
+		if (style.display == Display::FlowRoot) {
+			description.flags = description.flags | FragmentFlags::FormattingContextRoot;
+		}
+
+		if ((style.backgroundColor & 0xFF) != 0) {
+			description.flags = description.flags | FragmentFlags::HasBackground;
+		}
+
+		const auto index = fragmentTreeBuilder.addBox(description);
+		++fragmentsBuilt;
+
+		for (const auto& child : node.getChildren()) {
+			buildFragments(*child, description.x, description.y, index, childAnchor);
+		}
+	}
+
+	cache.fragmentCount = fragmentTreeBuilder.size() - start;
+}
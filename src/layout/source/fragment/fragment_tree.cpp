@@ -0,0 +1,69 @@
+#include "layout/fragment/fragment_tree.hpp"
+
+#include <vector>
+
+using namespace layout::fragment;
+
+std::size_t FragmentTree::size() const {
+	return flags.size();
+}
+
+std::span<const float> FragmentTree::getX() const {
+	return x;
+}
+
+std::span<const float> FragmentTree::getY() const {
+	return y;
+}
+
+std::span<const float> FragmentTree::getWidth() const {
+	return width;
+}
+
+std::span<const float> FragmentTree::getHeight() const {
+	return height;
+}
+
+std::span<const FragmentFlags> FragmentTree::getFlags() const {
+	return flags;
+}
+
+std::span<const std::uint32_t> FragmentTree::getParents() const {
+	return parents;
+}
+
+std::span<const std::uint32_t> FragmentTree::getColors() const {
+	return colors;
+}
+
+std::span<const std::uint32_t> FragmentTree::getBackgroundColors() const {
+	return backgroundColors;
+}
+
+std::span<const float> FragmentTree::getFontSizes() const {
+	return fontSizes;
+}
+
+std::string_view FragmentTree::getText(const std::size_t index) const {
+	return std::string_view(text).substr(textOffsets[index], textLengths[index]);
+}
+
+std::optional<std::uint32_t> FragmentTree::hitTest(const float pointX, const float pointY) const {
+	if (spatialIndex == nullptr) {
+		return std::nullopt;
+	}
+
+	std::vector<std::uint32_t> candidates;
+	spatialIndex->query({ pointX, pointY, 0.0f, 0.0f }, candidates);
+
+	// Candidates are sorted in paint order, so the first fragment that contains the point from the back is on top
+	for (auto candidate = candidates.rbegin(); candidate != candidates.rend(); ++candidate) {
+		const auto i = *candidate;
+
+		if (pointX >= x[i] && pointX < x[i] + width[i] && pointY >= y[i] && pointY < y[i] + height[i]) {
+			return i;
+		}
+	}
+
+	return std::nullopt;
+}
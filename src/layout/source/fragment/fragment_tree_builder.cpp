@@ -0,0 +1,111 @@
+#include "layout/fragment/fragment_tree_builder.hpp"
+
+#include <cstddef>
+
+using namespace layout::fragment;
+
+// Size of the cells of the spatial index in pixels, about a few lines of text
+constexpr float SPATIAL_INDEX_CELL_SIZE = 128.0f;
+
+FragmentTreeBuilder::FragmentTreeBuilder(const std::size_t capacity) :
+	tree(new FragmentTree()),
+	spatialIndexBuilder{ SPATIAL_INDEX_CELL_SIZE },
+	fragmentBounds{} {
+	tree->x.reserve(capacity);
+	tree->y.reserve(capacity);
+	tree->width.reserve(capacity);
+	tree->height.reserve(capacity);
+	tree->flags.reserve(capacity);
+	tree->parents.reserve(capacity);
+	tree->colors.reserve(capacity);
+	tree->backgroundColors.reserve(capacity);
+	tree->fontSizes.reserve(capacity);
+	tree->textOffsets.reserve(capacity);
+	tree->textLengths.reserve(capacity);
+}
+
+std::uint32_t FragmentTreeBuilder::addBox(const FragmentDescription& description) {
+	return addText(description, {});
+}
+
+std::uint32_t FragmentTreeBuilder::addText(const FragmentDescription& description, const std::string_view& text) {
+	const auto index = size();
+
+	tree->x.push_back(description.x);
+	tree->y.push_back(description.y);
+	tree->width.push_back(description.width);
+	tree->height.push_back(description.height);
+	tree->flags.push_back(description.flags);
+	tree->parents.push_back(description.parent);
+	tree->colors.push_back(description.color);
+	tree->backgroundColors.push_back(description.backgroundColor);
+	tree->fontSizes.push_back(description.fontSize);
+	tree->textOffsets.push_back(static_cast<std::uint32_t>(tree->text.size()));
+	tree->textLengths.push_back(static_cast<std::uint32_t>(text.size()));
+	tree->text += text;
+
+	return index;
+}
+
+std::uint32_t FragmentTreeBuilder::addRange(const FragmentTree& source, const std::uint32_t first, const std::uint32_t count, const std::uint32_t parent, const float offsetX, const float offsetY) {
+	const auto index = size();
+
+	if (count == 0) {
+		return index;
+	}
+
+	const auto last = first + count;
+	const auto begin = static_cast<std::ptrdiff_t>(first);
+	const auto end = static_cast<std::ptrdiff_t>(last);
+
+	for (auto i = first; i < last; ++i) {
+		tree->x.push_back(source.x[i] + offsetX);
+		tree->y.push_back(source.y[i] + offsetY);
+	}
+
+	tree->width.insert(tree->width.end(), source.width.begin() + begin, source.width.begin() + end);
+	tree->height.insert(tree->height.end(), source.height.begin() + begin, source.height.begin() + end);
+	tree->flags.insert(tree->flags.end(), source.flags.begin() + begin, source.flags.begin() + end);
+	tree->colors.insert(tree->colors.end(), source.colors.begin() + begin, source.colors.begin() + end);
+	tree->backgroundColors.insert(tree->backgroundColors.end(), source.backgroundColors.begin() + begin, source.backgroundColors.begin() + end);
+	tree->fontSizes.insert(tree->fontSizes.end(), source.fontSizes.begin() + begin, source.fontSizes.begin() + end);
+	tree->textLengths.insert(tree->textLengths.end(), source.textLengths.begin() + begin, source.textLengths.begin() + end);
+
+	// Parents precede their children, so a parent index below the range points outside of the subtree
+	for (auto i = first; i < last; ++i) {
+		const auto sourceParent = source.parents[i];
+		tree->parents.push_back(sourceParent != NO_PARENT && sourceParent >= first ? sourceParent - first + index : parent);
+	}
+
+	// The text of a subtree is stored back to back, so it is copied in one piece
+	const auto textStart = source.textOffsets[first];
+	const auto textEnd = source.textOffsets[last - 1] + source.textLengths[last - 1];
+	const auto textOffset = static_cast<std::uint32_t>(tree->text.size());
+
+	for (auto i = first; i < last; ++i) {
+		tree->textOffsets.push_back(source.textOffsets[i] - textStart + textOffset);
+	}
+
+	tree->text.append(source.text, textStart, textEnd - textStart);
+
+	return index;
+}
+
+std::uint32_t FragmentTreeBuilder::size() const {
+	return static_cast<std::uint32_t>(tree->flags.size());
+}
+
+std::shared_ptr<const FragmentTree> FragmentTreeBuilder::build() {
+	fragmentBounds.resize(tree->size());
+
+	for (std::size_t i = 0; i < fragmentBounds.size(); ++i) {
+		fragmentBounds[i] = { tree->x[i], tree->y[i], tree->width[i], tree->height[i] };
+	}
+
+	tree->spatialIndex = spatialIndexBuilder.update(fragmentBounds);
+
+	std::shared_ptr<const FragmentTree> result = std::move(tree);
+	tree.reset(new FragmentTree());
+
+	return result;
+}
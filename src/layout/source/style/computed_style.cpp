@@ -0,0 +1,40 @@
+#include "layout/style/computed_style.hpp"
+
+using namespace layout::style;
+
+// Default text size of most browsers
+constexpr float DEFAULT_FONT_SIZE = 16.0f;
+
+// Multiplier used to derive the line height from the font size ("line-height: normal")
+constexpr float DEFAULT_LINE_HEIGHT_FACTOR = 1.2f;
+
+constexpr std::uint32_t OPAQUE_BLACK = 0x000000FF;
+
+bool ComputedStyle::affectsLayoutComparedTo(const ComputedStyle& other) const {
+	return display != other.display
+		|| width != other.width
+		|| height != other.height
+		|| margin != other.margin
+		|| padding != other.padding
+		|| fontSize != other.fontSize
+		|| lineHeight != other.lineHeight;
+}
+
+bool ComputedStyle::affectsInheritanceComparedTo(const ComputedStyle& other) const {
+	return fontSize != other.fontSize
+		|| lineHeight != other.lineHeight
+		|| color != other.color;
+}
+
+ComputedStyle layout::style::initialStyle() {
+	ComputedStyle style{};
+	style.display = Display::Block;
+	style.margin = { 0.0f, 0.0f, 0.0f, 0.0f };
+	style.padding = { 0.0f, 0.0f, 0.0f, 0.0f };
+	style.fontSize = DEFAULT_FONT_SIZE;
+	style.lineHeight = DEFAULT_FONT_SIZE * DEFAULT_LINE_HEIGHT_FACTOR;
+	style.color = OPAQUE_BLACK;
+	style.backgroundColor = 0;
+
+	return style;
+}
@@ -0,0 +1,226 @@
+#include "layout/style/style_resolver.hpp"
+#include "layout/tree/node.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <charconv>
+#include <map>
+#include <optional>
+#include <vector>
+
+using namespace layout::style;
+using namespace layout::tree;
+
+static const std::map<std::string_view, Display> TAG_NAME_TO_DEFAULT_DISPLAY {
+	{ "a", Display::Inline },
+	{ "b", Display::Inline },
+	{ "em", Display::Inline },
+	{ "i", Display::Inline },
+	{ "span", Display::Inline },
+	{ "strong", Display::Inline },
+	{ "head", Display::None },
+	{ "script", Display::None },
+	{ "style", Display::None },
+	{ "title", Display::None }
+};
+
+static const std::map<std::string_view, std::uint32_t> COLOR_NAME_TO_RGBA {
+	{ "black", 0x000000FF },
+	{ "white", 0xFFFFFFFF },
+	{ "red", 0xFF0000FF },
+	{ "green", 0x008000FF },
+	{ "blue", 0x0000FFFF },
+	{ "gray", 0x808080FF },
+	{ "transparent", 0x00000000 }
+};
+
+// Remove leading and trailing whitespace
+static std::string_view trim(const std::string_view& text) {
+	const auto first = text.find_first_not_of(" \t\r\n");
+
+	if (first == std::string_view::npos) {
+		return {};
+	}
+
+	const auto last = text.find_last_not_of(" \t\r\n");
+	return text.substr(first, last - first + 1);
+}
+
+// Parse a length such as "12px" or "12" - relative units are resolved against the font size
+static std::optional<float> parseLength(const std::string_view& value, const float fontSize) {
+	auto result = 0.0f;
+	const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+
+	if (error != std::errc{}) {
+		return std::nullopt;
+	}
+
+	const auto unit = std::string_view(end, value.data() + value.size() - end);
+
+	if (unit.empty() || unit == "px") {
+		return result;
+	}
+
+	if (unit == "em") {
+		return result * fontSize;
+	}
+
+	spdlog::debug("Unsupported length unit: {}", unit);
+	return std::nullopt;
+}
+
+// Parse a color such as "#rgb", "#rrggbb" or a named color into RGBA
+static std::optional<std::uint32_t> parseColor(const std::string_view& value) {
+	const auto named = COLOR_NAME_TO_RGBA.find(value);
+
+	if (named != COLOR_NAME_TO_RGBA.end()) {
+		return named->second;
+	}
+
+	if ((value.size() != 4 && value.size() != 7) || value[0] != '#') {
+		return std::nullopt;
+	}
+
+	std::uint32_t rgb = 0;
+	const auto digits = value.substr(1);
+	const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), rgb, 16);
+
+	if (error != std::errc{} || end != digits.data() + digits.size()) {
+		return std::nullopt;
+	}
+
+	// Expand the short hand notation, every digit is duplicated ("#abc" becomes "#aabbcc")
+	if (digits.size() == 3) {
+		const auto r = (rgb >> 8) & 0xF;
+		const auto g = (rgb >> 4) & 0xF;
+		const auto b = rgb & 0xF;
+		rgb = (r * 0x11) << 16 | (g * 0x11) << 8 | (b * 0x11);
+	}
+
+	return rgb << 8 | 0xFF;
+}
+
+// Parse the short hand notation of margin and padding, which accepts one to four lengths
+static std::optional<Edges> parseEdges(const std::string_view& value, const float fontSize) {
+	std::vector<float> lengths;
+	std::size_t start = 0;
+
+	while (start < value.size()) {
+		const auto end = std::min(value.find(' ', start), value.size());
+		const auto token = trim(value.substr(start, end - start));
+
+		if (!token.empty()) {
+			const auto length = parseLength(token, fontSize);
+
+			if (!length.has_value()) {
+				return std::nullopt;
+			}
+
+			lengths.push_back(length.value());
+		}
+
+		start = end + 1;
+	}
+
+	switch (lengths.size()) {
+		case 1:
+			return Edges{ lengths[0], lengths[0], lengths[0], lengths[0] };
+
+		case 2:
+			return Edges{ lengths[0], lengths[1], lengths[0], lengths[1] };
+
+		case 3:
+			return Edges{ lengths[0], lengths[1], lengths[2], lengths[1] };
+
+		case 4:
+			return Edges{ lengths[0], lengths[1], lengths[2], lengths[3] };
+
+		default:
+			return std::nullopt;
+	}
+}
+
+ComputedStyle StyleResolver::resolve(const Node& node, const ComputedStyle& parentStyle) const {
+	auto style = initialStyle();
+
+	// Inherited properties
+	style.fontSize = parentStyle.fontSize;
+	style.lineHeight = parentStyle.lineHeight;
+	style.color = parentStyle.color;
+
+	// Text is always part of the inline formatting context of its parent
+	if (node.getType() == NodeType::Text) {
+		style.display = Display::Inline;
+		return style;
+	}
+
+	const auto defaultDisplay = TAG_NAME_TO_DEFAULT_DISPLAY.find(node.getTagName());
+
+	if (defaultDisplay != TAG_NAME_TO_DEFAULT_DISPLAY.end()) {
+		style.display = defaultDisplay->second;
+	}
+
+	const auto inlineStyle = node.getAttribute("style");
+
+	if (inlineStyle == nullptr) {
+		return style;
+	}
+
+	// Declarations are separated by semicolons: "width: 100px; color: red"
+	const std::string_view declarations = *inlineStyle;
+	std::size_t start = 0;
+
+	while (start < declarations.size()) {
+		const auto end = std::min(declarations.find(';', start), declarations.size());
+		const auto declaration = declarations.substr(start, end - start);
+		const auto colon = declaration.find(':');
+
+		if (colon != std::string_view::npos) {
+			applyDeclaration(style, trim(declaration.substr(0, colon)), trim(declaration.substr(colon + 1)));
+		}
+
+		start = end + 1;
+	}
+
+	return style;
+}
+
+void StyleResolver::applyDeclaration(ComputedStyle& style, const std::string_view& property, const std::string_view& value) const {
+	if (property == "display") {
+		if (value == "block") {
+			style.display = Display::Block;
+		} else if (value == "inline") {
+			style.display = Display::Inline;
+		} else if (value == "flow-root") {
+			style.display = Display::FlowRoot;
+		} else if (value == "none") {
+			style.display = Display::None;
+		}
+	} else if (property == "width" || property == "height") {
+		auto& target = property == "width" ? style.width : style.height;
+		target = value == "auto" ? std::nullopt : parseLength(value, style.fontSize);
+	} else if (property == "margin" || property == "padding") {
+		const auto edges = parseEdges(value, style.fontSize);
+
+		if (edges.has_value()) {
+			(property == "margin" ? style.margin : style.padding) = edges.value();
+		}
+	} else if (property == "font-size") {
+		const auto fontSize = parseLength(value, style.fontSize);
+
+		if (fontSize.has_value()) {
+			// Keep the ratio between line height and font size intact
+			style.lineHeight *= fontSize.value() / style.fontSize;
+			style.fontSize = fontSize.value();
+		}
+	} else if (property == "line-height") {
+		style.lineHeight = parseLength(value, style.fontSize).value_or(style.lineHeight);
+	} else if (property == "color") {
+		style.color = parseColor(value).value_or(style.color);
+	} else if (property == "background-color") {
+		style.backgroundColor = parseColor(value).value_or(style.backgroundColor);
+	} else {
+		spdlog::debug("Unsupported style property: {}", property);
+	}
+}
@@ -0,0 +1,595 @@
+#include "layout/text/line_breaker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLAIN_LINE_BREAKER_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace layout::text;
+
+// Substituted for malformed UTF-8 sequences
+constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// Line breaking class of every code point outside of the ASCII range that is not alphabetic
+struct BreakClassRange {
+	char32_t first;
+	char32_t last;
+	BreakClass breakClass;
+};
+
+// Reference: https://www.unicode.org/Public/UCD/latest/ucd/LineBreak.txt
+// Ambiguous and unknown characters resolve to alphabetic, Hangul syllables to ideographic, conditional Japanese starters to nonstarters
+// Emoji modifiers are treated as combining marks, so they stay attached to their base
+constexpr std::array<BreakClassRange, 205> BREAK_CLASS_RANGES = { {
+	{ 0x0085, 0x0085, BreakClass::NextLine },
+	{ 0x00A0, 0x00A0, BreakClass::Glue },
+	{ 0x00A1, 0x00A1, BreakClass::OpenPunctuation },
+	{ 0x00A2, 0x00A2, BreakClass::PostfixNumeric },
+	{ 0x00A3, 0x00A5, BreakClass::PrefixNumeric },
+	{ 0x00AB, 0x00AB, BreakClass::Quotation },
+	{ 0x00AD, 0x00AD, BreakClass::BreakAfter },
+	{ 0x00B0, 0x00B0, BreakClass::PostfixNumeric },
+	{ 0x00B1, 0x00B1, BreakClass::PrefixNumeric },
+	{ 0x00B4, 0x00B4, BreakClass::BreakBefore },
+	{ 0x00BB, 0x00BB, BreakClass::Quotation },
+	{ 0x00BF, 0x00BF, BreakClass::OpenPunctuation },
+	{ 0x0300, 0x036F, BreakClass::CombiningMark },
+	{ 0x0483, 0x0489, BreakClass::CombiningMark },
+	{ 0x0591, 0x05BD, BreakClass::CombiningMark },
+	{ 0x05BE, 0x05BE, BreakClass::BreakAfter },
+	{ 0x05BF, 0x05BF, BreakClass::CombiningMark },
+	{ 0x05C1, 0x05C2, BreakClass::CombiningMark },
+	{ 0x05C4, 0x05C5, BreakClass::CombiningMark },
+	{ 0x05C7, 0x05C7, BreakClass::CombiningMark },
+	{ 0x0610, 0x061A, BreakClass::CombiningMark },
+	{ 0x064B, 0x065F, BreakClass::CombiningMark },
+	{ 0x0660, 0x0669, BreakClass::Numeric },
+	{ 0x066A, 0x066A, BreakClass::PostfixNumeric },
+	{ 0x066B, 0x066C, BreakClass::Numeric },
+	{ 0x0670, 0x0670, BreakClass::CombiningMark },
+	{ 0x06D6, 0x06DC, BreakClass::CombiningMark },
+	{ 0x06DF, 0x06E4, BreakClass::CombiningMark },
+	{ 0x06E7, 0x06E8, BreakClass::CombiningMark },
+	{ 0x06EA, 0x06ED, BreakClass::CombiningMark },
+	{ 0x06F0, 0x06F9, BreakClass::Numeric },
+	{ 0x0900, 0x0903, BreakClass::CombiningMark },
+	{ 0x093A, 0x093C, BreakClass::CombiningMark },
+	{ 0x093E, 0x094F, BreakClass::CombiningMark },
+	{ 0x0951, 0x0957, BreakClass::CombiningMark },
+	{ 0x0962, 0x0963, BreakClass::CombiningMark },
+	{ 0x0964, 0x0965, BreakClass::BreakAfter },
+	{ 0x0966, 0x096F, BreakClass::Numeric },
+	{ 0x0F0B, 0x0F0B, BreakClass::BreakAfter },
+	{ 0x1680, 0x1680, BreakClass::BreakAfter },
+	{ 0x1AB0, 0x1AFF, BreakClass::CombiningMark },
+	{ 0x1DC0, 0x1DFF, BreakClass::CombiningMark },
+	{ 0x2000, 0x2006, BreakClass::BreakAfter },
+	{ 0x2007, 0x2007, BreakClass::Glue },
+	{ 0x2008, 0x200A, BreakClass::BreakAfter },
+	{ 0x200B, 0x200B, BreakClass::ZeroWidthSpace },
+	{ 0x200C, 0x200C, BreakClass::CombiningMark },
+	{ 0x200D, 0x200D, BreakClass::ZeroWidthJoiner },
+	{ 0x2010, 0x2010, BreakClass::BreakAfter },
+	{ 0x2011, 0x2011, BreakClass::Glue },
+	{ 0x2012, 0x2013, BreakClass::BreakAfter },
+	{ 0x2014, 0x2014, BreakClass::BreakBoth },
+	{ 0x2018, 0x2019, BreakClass::Quotation },
+	{ 0x201A, 0x201A, BreakClass::OpenPunctuation },
+	{ 0x201B, 0x201D, BreakClass::Quotation },
+	{ 0x201E, 0x201E, BreakClass::OpenPunctuation },
+	{ 0x201F, 0x201F, BreakClass::Quotation },
+	{ 0x2024, 0x2026, BreakClass::Inseparable },
+	{ 0x2027, 0x2027, BreakClass::BreakAfter },
+	{ 0x2028, 0x2029, BreakClass::MandatoryBreak },
+	{ 0x202F, 0x202F, BreakClass::Glue },
+	{ 0x2030, 0x2037, BreakClass::PostfixNumeric },
+	{ 0x2039, 0x203A, BreakClass::Quotation },
+	{ 0x203C, 0x203D, BreakClass::Nonstarter },
+	{ 0x2044, 0x2044, BreakClass::InfixSeparator },
+	{ 0x2045, 0x2045, BreakClass::OpenPunctuation },
+	{ 0x2046, 0x2046, BreakClass::ClosePunctuation },
+	{ 0x2047, 0x2049, BreakClass::Nonstarter },
+	{ 0x2060, 0x2060, BreakClass::WordJoiner },
+	{ 0x20A0, 0x20CF, BreakClass::PrefixNumeric },
+	{ 0x20D0, 0x20FF, BreakClass::CombiningMark },
+	{ 0x2103, 0x2103, BreakClass::PostfixNumeric },
+	{ 0x2116, 0x2116, BreakClass::PrefixNumeric },
+	{ 0x2212, 0x2213, BreakClass::PrefixNumeric },
+	{ 0x2E80, 0x2FFF, BreakClass::Ideographic },
+	{ 0x3000, 0x3000, BreakClass::BreakAfter },
+	{ 0x3001, 0x3002, BreakClass::ClosePunctuation },
+	{ 0x3003, 0x3004, BreakClass::Ideographic },
+	{ 0x3005, 0x3005, BreakClass::Nonstarter },
+	{ 0x3006, 0x3007, BreakClass::Ideographic },
+	{ 0x3008, 0x3008, BreakClass::OpenPunctuation },
+	{ 0x3009, 0x3009, BreakClass::ClosePunctuation },
+	{ 0x300A, 0x300A, BreakClass::OpenPunctuation },
+	{ 0x300B, 0x300B, BreakClass::ClosePunctuation },
+	{ 0x300C, 0x300C, BreakClass::OpenPunctuation },
+	{ 0x300D, 0x300D, BreakClass::ClosePunctuation },
+	{ 0x300E, 0x300E, BreakClass::OpenPunctuation },
+	{ 0x300F, 0x300F, BreakClass::ClosePunctuation },
+	{ 0x3010, 0x3010, BreakClass::OpenPunctuation },
+	{ 0x3011, 0x3011, BreakClass::ClosePunctuation },
+	{ 0x3012, 0x3013, BreakClass::Ideographic },
+	{ 0x3014, 0x3014, BreakClass::OpenPunctuation },
+	{ 0x3015, 0x3015, BreakClass::ClosePunctuation },
+	{ 0x3016, 0x3016, BreakClass::OpenPunctuation },
+	{ 0x3017, 0x3017, BreakClass::ClosePunctuation },
+	{ 0x3018, 0x3018, BreakClass::OpenPunctuation },
+	{ 0x3019, 0x3019, BreakClass::ClosePunctuation },
+	{ 0x301A, 0x301A, BreakClass::OpenPunctuation },
+	{ 0x301B, 0x301B, BreakClass::ClosePunctuation },
+	{ 0x301C, 0x301C, BreakClass::Nonstarter },
+	{ 0x301D, 0x301D, BreakClass::OpenPunctuation },
+	{ 0x301E, 0x301F, BreakClass::ClosePunctuation },
+	{ 0x3020, 0x3029, BreakClass::Ideographic },
+	{ 0x302A, 0x302F, BreakClass::CombiningMark },
+	{ 0x3030, 0x3040, BreakClass::Ideographic },
+	{ 0x3041, 0x3041, BreakClass::Nonstarter },
+	{ 0x3042, 0x3042, BreakClass::Ideographic },
+	{ 0x3043, 0x3043, BreakClass::Nonstarter },
+	{ 0x3044, 0x3044, BreakClass::Ideographic },
+	{ 0x3045, 0x3045, BreakClass::Nonstarter },
+	{ 0x3046, 0x3046, BreakClass::Ideographic },
+	{ 0x3047, 0x3047, BreakClass::Nonstarter },
+	{ 0x3048, 0x3048, BreakClass::Ideographic },
+	{ 0x3049, 0x3049, BreakClass::Nonstarter },
+	{ 0x304A, 0x3062, BreakClass::Ideographic },
+	{ 0x3063, 0x3063, BreakClass::Nonstarter },
+	{ 0x3064, 0x3082, BreakClass::Ideographic },
+	{ 0x3083, 0x3083, BreakClass::Nonstarter },
+	{ 0x3084, 0x3084, BreakClass::Ideographic },
+	{ 0x3085, 0x3085, BreakClass::Nonstarter },
+	{ 0x3086, 0x3086, BreakClass::Ideographic },
+	{ 0x3087, 0x3087, BreakClass::Nonstarter },
+	{ 0x3088, 0x308D, BreakClass::Ideographic },
+	{ 0x308E, 0x308E, BreakClass::Nonstarter },
+	{ 0x308F, 0x3094, BreakClass::Ideographic },
+	{ 0x3095, 0x3096, BreakClass::Nonstarter },
+	{ 0x3097, 0x3098, BreakClass::Ideographic },
+	{ 0x3099, 0x309A, BreakClass::CombiningMark },
+	{ 0x309B, 0x309E, BreakClass::Nonstarter },
+	{ 0x309F, 0x309F, BreakClass::Ideographic },
+	{ 0x30A0, 0x30A1, BreakClass::Nonstarter },
+	{ 0x30A2, 0x30A2, BreakClass::Ideographic },
+	{ 0x30A3, 0x30A3, BreakClass::Nonstarter },
+	{ 0x30A4, 0x30A4, BreakClass::Ideographic },
+	{ 0x30A5, 0x30A5, BreakClass::Nonstarter },
+	{ 0x30A6, 0x30A6, BreakClass::Ideographic },
+	{ 0x30A7, 0x30A7, BreakClass::Nonstarter },
+	{ 0x30A8, 0x30A8, BreakClass::Ideographic },
+	{ 0x30A9, 0x30A9, BreakClass::Nonstarter },
+	{ 0x30AA, 0x30C2, BreakClass::Ideographic },
+	{ 0x30C3, 0x30C3, BreakClass::Nonstarter },
+	{ 0x30C4, 0x30E2, BreakClass::Ideographic },
+	{ 0x30E3, 0x30E3, BreakClass::Nonstarter },
+	{ 0x30E4, 0x30E4, BreakClass::Ideographic },
+	{ 0x30E5, 0x30E5, BreakClass::Nonstarter },
+	{ 0x30E6, 0x30E6, BreakClass::Ideographic },
+	{ 0x30E7, 0x30E7, BreakClass::Nonstarter },
+	{ 0x30E8, 0x30ED, BreakClass::Ideographic },
+	{ 0x30EE, 0x30EE, BreakClass::Nonstarter },
+	{ 0x30EF, 0x30F4, BreakClass::Ideographic },
+	{ 0x30F5, 0x30F6, BreakClass::Nonstarter },
+	{ 0x30F7, 0x30FA, BreakClass::Ideographic },
+	{ 0x30FB, 0x30FE, BreakClass::Nonstarter },
+	{ 0x30FF, 0x31EF, BreakClass::Ideographic },
+	{ 0x31F0, 0x31FF, BreakClass::Nonstarter },
+	{ 0x3200, 0x4DBF, BreakClass::Ideographic },
+	{ 0x4E00, 0xA4CF, BreakClass::Ideographic },
+	{ 0xAC00, 0xD7A3, BreakClass::Ideographic },
+	{ 0xF900, 0xFAFF, BreakClass::Ideographic },
+	{ 0xFE00, 0xFE0F, BreakClass::CombiningMark },
+	{ 0xFE20, 0xFE2F, BreakClass::CombiningMark },
+	{ 0xFE30, 0xFE4F, BreakClass::Ideographic },
+	{ 0xFEFF, 0xFEFF, BreakClass::WordJoiner },
+	{ 0xFF01, 0xFF01, BreakClass::Exclamation },
+	{ 0xFF02, 0xFF03, BreakClass::Ideographic },
+	{ 0xFF04, 0xFF04, BreakClass::PrefixNumeric },
+	{ 0xFF05, 0xFF05, BreakClass::PostfixNumeric },
+	{ 0xFF06, 0xFF07, BreakClass::Ideographic },
+	{ 0xFF08, 0xFF08, BreakClass::OpenPunctuation },
+	{ 0xFF09, 0xFF09, BreakClass::CloseParenthesis },
+	{ 0xFF0A, 0xFF0B, BreakClass::Ideographic },
+	{ 0xFF0C, 0xFF0C, BreakClass::ClosePunctuation },
+	{ 0xFF0D, 0xFF0D, BreakClass::Ideographic },
+	{ 0xFF0E, 0xFF0E, BreakClass::ClosePunctuation },
+	{ 0xFF0F, 0xFF19, BreakClass::Ideographic },
+	{ 0xFF1A, 0xFF1B, BreakClass::Nonstarter },
+	{ 0xFF1C, 0xFF1E, BreakClass::Ideographic },
+	{ 0xFF1F, 0xFF1F, BreakClass::Exclamation },
+	{ 0xFF20, 0xFF3A, BreakClass::Ideographic },
+	{ 0xFF3B, 0xFF3B, BreakClass::OpenPunctuation },
+	{ 0xFF3C, 0xFF3C, BreakClass::Ideographic },
+	{ 0xFF3D, 0xFF3D, BreakClass::CloseParenthesis },
+	{ 0xFF3E, 0xFF5A, BreakClass::Ideographic },
+	{ 0xFF5B, 0xFF5B, BreakClass::OpenPunctuation },
+	{ 0xFF5C, 0xFF5C, BreakClass::Ideographic },
+	{ 0xFF5D, 0xFF5D, BreakClass::ClosePunctuation },
+	{ 0xFF5E, 0xFF5E, BreakClass::Ideographic },
+	{ 0xFF5F, 0xFF5F, BreakClass::OpenPunctuation },
+	{ 0xFF60, 0xFF61, BreakClass::ClosePunctuation },
+	{ 0xFF62, 0xFF62, BreakClass::OpenPunctuation },
+	{ 0xFF63, 0xFF64, BreakClass::ClosePunctuation },
+	{ 0xFF65, 0xFF65, BreakClass::Nonstarter },
+	{ 0xFFE0, 0xFFE0, BreakClass::PostfixNumeric },
+	{ 0xFFE1, 0xFFE1, BreakClass::PrefixNumeric },
+	{ 0xFFE5, 0xFFE6, BreakClass::PrefixNumeric },
+	{ 0x1F000, 0x1F1E5, BreakClass::Ideographic },
+	{ 0x1F1E6, 0x1F1FF, BreakClass::RegionalIndicator },
+	{ 0x1F200, 0x1F3FA, BreakClass::Ideographic },
+	{ 0x1F3FB, 0x1F3FF, BreakClass::CombiningMark },
+	{ 0x1F400, 0x1FAFF, BreakClass::Ideographic },
+	{ 0x20000, 0x2FFFD, BreakClass::Ideographic },
+	{ 0x30000, 0x3FFFD, BreakClass::Ideographic },
+	{ 0xE0001, 0xE0001, BreakClass::CombiningMark },
+	{ 0xE0020, 0xE007F, BreakClass::CombiningMark },
+	{ 0xE0100, 0xE01EF, BreakClass::CombiningMark }
+} };
+
+static constexpr bool areRangesSortedAndDisjoint() {
+	for (std::size_t i = 0; i < BREAK_CLASS_RANGES.size(); ++i) {
+		if (BREAK_CLASS_RANGES[i].first > BREAK_CLASS_RANGES[i].last || (i > 0 && BREAK_CLASS_RANGES[i - 1].last >= BREAK_CLASS_RANGES[i].first)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Classes are looked up with a binary search
+static_assert(areRangesSortedAndDisjoint(), "Line breaking class ranges have to be sorted and must not overlap");
+
+static constexpr std::array<BreakClass, 128> createAsciiBreakClasses() {
+	std::array<BreakClass, 128> classes{};
+	classes.fill(BreakClass::Alphabetic);
+
+	// Control characters behave like combining marks, apart from the ones that break lines
+	for (std::size_t i = 0; i < 0x20; ++i) {
+		classes[i] = BreakClass::CombiningMark;
+	}
+
+	classes[0x7F] = BreakClass::CombiningMark;
+
+	for (auto i = '0'; i <= '9'; ++i) {
+		classes[static_cast<std::size_t>(i)] = BreakClass::Numeric;
+	}
+
+	classes['\t'] = BreakClass::BreakAfter;
+	classes['\n'] = BreakClass::LineFeed;
+	classes['\v'] = BreakClass::MandatoryBreak;
+	classes['\f'] = BreakClass::MandatoryBreak;
+	classes['\r'] = BreakClass::CarriageReturn;
+	classes[' '] = BreakClass::Space;
+	classes['!'] = BreakClass::Exclamation;
+	classes['"'] = BreakClass::Quotation;
+	classes['$'] = BreakClass::PrefixNumeric;
+	classes['%'] = BreakClass::PostfixNumeric;
+	classes['\''] = BreakClass::Quotation;
+	classes['('] = BreakClass::OpenPunctuation;
+	classes[')'] = BreakClass::CloseParenthesis;
+	classes['+'] = BreakClass::PrefixNumeric;
+	classes[','] = BreakClass::InfixSeparator;
+	classes['-'] = BreakClass::Hyphen;
+	classes['.'] = BreakClass::InfixSeparator;
+	classes['/'] = BreakClass::Symbol;
+	classes[':'] = BreakClass::InfixSeparator;
+	classes[';'] = BreakClass::InfixSeparator;
+	classes['?'] = BreakClass::Exclamation;
+	classes['['] = BreakClass::OpenPunctuation;
+	classes['\\'] = BreakClass::PrefixNumeric;
+	classes[']'] = BreakClass::CloseParenthesis;
+	classes['{'] = BreakClass::OpenPunctuation;
+	classes['|'] = BreakClass::BreakAfter;
+	classes['}'] = BreakClass::ClosePunctuation;
+
+	return classes;
+}
+
+constexpr auto ASCII_BREAK_CLASSES = createAsciiBreakClasses();
+
+// State of the algorithm at the position between two characters
+struct BreakState {
+	// Class of the character before the position, combining marks are merged into the character they follow (LB9)
+	BreakClass previous;
+
+	// Class of the last character before the spaces that precede the position (LB8, LB14 - LB17)
+	BreakClass beforeSpaces;
+
+	// The character before the position is a zero width joiner (LB8a)
+	bool isAfterJoiner;
+
+	// Number of consecutive regional indicators before the position (LB30a)
+	std::size_t regionalIndicatorCount;
+};
+
+// Decode the code point starting at "position" and advance past it
+static char32_t decodeUtf8(const std::string_view& text, std::size_t& position) {
+	const auto lead = static_cast<std::uint8_t>(text[position++]);
+
+	if (lead < 0x80) {
+		return lead;
+	}
+
+	std::size_t continuationCount = 0;
+	char32_t codePoint = 0;
+
+	if ((lead & 0xE0) == 0xC0) {
+		continuationCount = 1;
+		codePoint = lead & 0x1F;
+	} else if ((lead & 0xF0) == 0xE0) {
+		continuationCount = 2;
+		codePoint = lead & 0x0F;
+	} else if ((lead & 0xF8) == 0xF0) {
+		continuationCount = 3;
+		codePoint = lead & 0x07;
+	} else {
+		return REPLACEMENT_CHARACTER;
+	}
+
+	for (std::size_t i = 0; i < continuationCount; ++i) {
+		if (position >= text.size() || (static_cast<std::uint8_t>(text[position]) & 0xC0) != 0x80) {
+			return REPLACEMENT_CHARACTER;
+		}
+
+		codePoint = (codePoint << 6) | (static_cast<std::uint8_t>(text[position++]) & 0x3F);
+	}
+
+	return codePoint;
+}
+
+static bool isAsciiAlphanumeric(const char character) {
+	return (character >= '0' && character <= '9') || (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z');
+}
+
+// Whitespace that collapses and hangs at the end of a line
+static bool isCollapsibleWhitespace(const char character) {
+	return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\f';
+}
+
+static bool isLineSeparator(const BreakClass breakClass) {
+	return breakClass == BreakClass::MandatoryBreak || breakClass == BreakClass::CarriageReturn || breakClass == BreakClass::LineFeed || breakClass == BreakClass::NextLine;
+}
+
+// Returns the number of ASCII letters and digits at the start of the text, a run of them never contains a break opportunity (LB23, LB28)
+static std::size_t countAlphanumericPrefix(const std::string_view& text) {
+	const auto* const bytes = text.data();
+	const auto size = text.size();
+	std::size_t i = 0;
+
+#ifdef PLAIN_LINE_BREAKER_SSE2
+	const auto belowDigits = _mm_set1_epi8('0' - 1);
+	const auto aboveDigits = _mm_set1_epi8('9' + 1);
+	const auto belowLetters = _mm_set1_epi8('a' - 1);
+	const auto aboveLetters = _mm_set1_epi8('z' + 1);
+	const auto caseBit = _mm_set1_epi8(0x20);
+
+	// Bytes outside of the ASCII range are negative, which places them outside of both ranges
+	for (; i + 16 <= size; i += 16) {
+		const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+
+		// Setting the case bit turns upper case letters into lower case letters, and no other character into a letter
+		const auto lowercase = _mm_or_si128(block, caseBit);
+		const auto isDigit = _mm_and_si128(_mm_cmpgt_epi8(block, belowDigits), _mm_cmpgt_epi8(aboveDigits, block));
+		const auto isLetter = _mm_and_si128(_mm_cmpgt_epi8(lowercase, belowLetters), _mm_cmpgt_epi8(aboveLetters, lowercase));
+		const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter))) ^ 0xFFFFu;
+
+		if (mask != 0) {
+			return i + static_cast<std::size_t>(std::countr_zero(mask));
+		}
+	}
+#endif
+
+	while (i < size && isAsciiAlphanumeric(bytes[i])) {
+		++i;
+	}
+
+	return i;
+}
+
+// Pair rules of the algorithm that do not involve mandatory breaks or combining marks
+// Reference: https://www.unicode.org/reports/tr14/#Algorithm
+static bool isBreakAllowed(const BreakState& state, const BreakClass next) {
+	const auto previous = state.previous;
+	const auto beforeSpaces = state.beforeSpaces;
+
+	// LB6, LB7
+	if (isLineSeparator(next) || next == BreakClass::Space || next == BreakClass::ZeroWidthSpace) {
+		return false;
+	}
+
+	// LB8
+	if (beforeSpaces == BreakClass::ZeroWidthSpace) {
+		return true;
+	}
+
+	// LB8a, LB11, LB12
+	if (state.isAfterJoiner || previous == BreakClass::WordJoiner || next == BreakClass::WordJoiner || previous == BreakClass::Glue) {
+		return false;
+	}
+
+	// LB12a
+	if (next == BreakClass::Glue && previous != BreakClass::Space && previous != BreakClass::BreakAfter && previous != BreakClass::Hyphen) {
+		return false;
+	}
+
+	// LB13
+	if (next == BreakClass::ClosePunctuation || next == BreakClass::CloseParenthesis || next == BreakClass::Exclamation || next == BreakClass::InfixSeparator || next == BreakClass::Symbol) {
+		return false;
+	}
+
+	// LB14 - LB17, these apply across spaces
+	if (beforeSpaces == BreakClass::OpenPunctuation) {
+		return false;
+	}
+
+	if (beforeSpaces == BreakClass::Quotation && next == BreakClass::OpenPunctuation) {
+		return false;
+	}
+
+	if ((beforeSpaces == BreakClass::ClosePunctuation || beforeSpaces == BreakClass::CloseParenthesis) && next == BreakClass::Nonstarter) {
+		return false;
+	}
+
+	if (beforeSpaces == BreakClass::BreakBoth && next == BreakClass::BreakBoth) {
+		return false;
+	}
+
+	// LB18
+	if (previous == BreakClass::Space) {
+		return true;
+	}
+
+	// LB19
+	if (previous == BreakClass::Quotation || next == BreakClass::Quotation) {
+		return false;
+	}
+
+	// LB21, LB22
+	if (next == BreakClass::BreakAfter || next == BreakClass::Hyphen || next == BreakClass::Nonstarter || next == BreakClass::Inseparable || previous == BreakClass::BreakBefore) {
+		return false;
+	}
+
+	const auto isPrefixOrPostfix = [](const BreakClass breakClass) {
+		return breakClass == BreakClass::PrefixNumeric || breakClass == BreakClass::PostfixNumeric;
+	};
+
+	switch (next) {
+		case BreakClass::Alphabetic:
+			// LB23, LB24, LB28, LB29, LB30
+			return previous != BreakClass::Alphabetic && previous != BreakClass::Numeric && !isPrefixOrPostfix(previous)
+				&& previous != BreakClass::InfixSeparator && previous != BreakClass::CloseParenthesis;
+
+		case BreakClass::Numeric:
+			// LB23, LB25, LB30
+			return previous != BreakClass::Alphabetic && previous != BreakClass::Numeric && !isPrefixOrPostfix(previous) && previous != BreakClass::Hyphen
+				&& previous != BreakClass::InfixSeparator && previous != BreakClass::Symbol && previous != BreakClass::CloseParenthesis;
+
+		case BreakClass::Ideographic:
+			// LB23a
+			return previous != BreakClass::PrefixNumeric;
+
+		case BreakClass::PrefixNumeric:
+		case BreakClass::PostfixNumeric:
+			// LB23a, LB24, LB25
+			return previous != BreakClass::Alphabetic && previous != BreakClass::Numeric && previous != BreakClass::ClosePunctuation
+				&& previous != BreakClass::CloseParenthesis && (next != BreakClass::PostfixNumeric || previous != BreakClass::Ideographic);
+
+		case BreakClass::OpenPunctuation:
+			// LB25, LB30
+			return previous != BreakClass::Alphabetic && previous != BreakClass::Numeric && !isPrefixOrPostfix(previous);
+
+		case BreakClass::RegionalIndicator:
+			// LB30a
+			return previous != BreakClass::RegionalIndicator || state.regionalIndicatorCount % 2 == 0;
+
+		default:
+			// LB31
+			return true;
+	}
+}
+
+BreakClass layout::text::getBreakClass(const char32_t codePoint) {
+	if (codePoint < ASCII_BREAK_CLASSES.size()) {
+		return ASCII_BREAK_CLASSES[codePoint];
+	}
+
+	const auto next = std::upper_bound(BREAK_CLASS_RANGES.begin(), BREAK_CLASS_RANGES.end(), codePoint, [](const char32_t value, const BreakClassRange& range) {
+		return value < range.first;
+	});
+
+	if (next != BREAK_CLASS_RANGES.begin() && codePoint <= std::prev(next)->last) {
+		return std::prev(next)->breakClass;
+	}
+
+	return BreakClass::Alphabetic;
+}
+
+void layout::text::findTextSegments(const std::string_view& text, std::vector<TextSegment>& segments) {
+	segments.clear();
+
+	if (text.empty()) {
+		return;
+	}
+
+	std::size_t segmentStart = 0;
+
+	const auto addSegment = [&text, &segments, &segmentStart](const std::size_t end, const bool isMandatoryBreak) {
+		auto contentEnd = end;
+
+		while (contentEnd > segmentStart && isCollapsibleWhitespace(text[contentEnd - 1])) {
+			--contentEnd;
+		}
+
+		segments.push_back({
+			static_cast<std::uint32_t>(segmentStart),
+			static_cast<std::uint32_t>(contentEnd - segmentStart),
+			static_cast<std::uint32_t>(end - contentEnd),
+			isMandatoryBreak
+		});
+
+		segmentStart = end;
+	};
+
+	std::size_t position = 0;
+	const auto first = getBreakClass(decodeUtf8(text, position));
+
+	// LB10, a combining mark without a base character is alphabetic
+	BreakState state{};
+	state.previous = first == BreakClass::CombiningMark || first == BreakClass::ZeroWidthJoiner ? BreakClass::Alphabetic : first;
+	state.beforeSpaces = state.previous;
+	state.isAfterJoiner = first == BreakClass::ZeroWidthJoiner;
+	state.regionalIndicatorCount = first == BreakClass::RegionalIndicator ? 1 : 0;
+
+	while (position < text.size()) {
+		if (state.previous == BreakClass::Alphabetic || state.previous == BreakClass::Numeric) {
+			const auto runLength = countAlphanumericPrefix(text.substr(position));
+
+			if (runLength > 0) {
+				position += runLength;
+
+				state.previous = ASCII_BREAK_CLASSES[static_cast<std::size_t>(text[position - 1])];
+				state.beforeSpaces = state.previous;
+				state.isAfterJoiner = false;
+				state.regionalIndicatorCount = 0;
+
+				continue;
+			}
+		}
+
+		const auto breakPosition = position;
+		const auto next = getBreakClass(decodeUtf8(text, position));
+		const auto isCombining = next == BreakClass::CombiningMark || next == BreakClass::ZeroWidthJoiner;
+
+		// LB4, LB5
+		if (isLineSeparator(state.previous) && (state.previous != BreakClass::CarriageReturn || next != BreakClass::LineFeed)) {
+			addSegment(breakPosition, true);
+		} else if (isCombining && state.previous != BreakClass::Space && state.previous != BreakClass::ZeroWidthSpace) {
+			// LB9, the mark takes the class of the character it follows
+			state.isAfterJoiner = next == BreakClass::ZeroWidthJoiner;
+			continue;
+		} else if (isBreakAllowed(state, next)) {
+			addSegment(breakPosition, false);
+		}
+
+		// LB10
+		const auto resolved = isCombining ? BreakClass::Alphabetic : next;
+
+		state.regionalIndicatorCount = resolved == BreakClass::RegionalIndicator ? state.regionalIndicatorCount + 1 : 0;
+		state.isAfterJoiner = next == BreakClass::ZeroWidthJoiner;
+		state.previous = resolved;
+
+		if (resolved != BreakClass::Space) {
+			state.beforeSpaces = resolved;
+		}
+	}
+
+	// LB3, the end of the text is always a break opportunity
+	addSegment(text.size(), false);
+}
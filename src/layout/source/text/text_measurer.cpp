@@ -0,0 +1,82 @@
+#include "layout/text/text_measurer.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+using namespace layout::text;
+
+// Rough advance of an average glyph relative to the font size, used when text cannot be measured properly
+constexpr float AVERAGE_GLYPH_ADVANCE_EM = 0.5f;
+
+// Entries are small, but the number of distinct words in a document is unbounded - the cache starts over once it holds this many
+constexpr std::size_t MAXIMUM_ENTRY_COUNT = 65'536;
+
+TextMeasurer::TextMeasurer(MeasureFunction measureFunction) :
+	measureFunction(std::move(measureFunction)),
+	mutex{},
+	widthsByFontSize{},
+	entryCount{ 0 },
+	hitCount{ 0 },
+	missCount{ 0 } {}
+
+float TextMeasurer::measure(const std::string_view& text, const float fontSize) {
+	{
+		std::shared_lock lock(mutex);
+		const auto widths = widthsByFontSize.find(fontSize);
+
+		if (widths != widthsByFontSize.end()) {
+			const auto width = widths->second.find(text);
+
+			if (width != widths->second.end()) {
+				++hitCount;
+				return width->second;
+			}
+		}
+	}
+
+	std::unique_lock lock(mutex);
+	++missCount;
+
+	if (entryCount >= MAXIMUM_ENTRY_COUNT) {
+		widthsByFontSize.clear();
+		entryCount = 0;
+	}
+
+	const auto width = measureFunction ? measureFunction(text, fontSize) : estimate(text, fontSize);
+
+	// Another thread may have measured the same text in the meantime, in which case this does nothing
+	if (widthsByFontSize[fontSize].emplace(text, width).second) {
+		++entryCount;
+	}
+
+	return width;
+}
+
+void TextMeasurer::clear() {
+	std::unique_lock lock(mutex);
+
+	widthsByFontSize.clear();
+	entryCount = 0;
+}
+
+std::size_t TextMeasurer::getHitCount() const {
+	return hitCount;
+}
+
+std::size_t TextMeasurer::getMissCount() const {
+	return missCount;
+}
+
+float TextMeasurer::estimate(const std::string_view& text, const float fontSize) {
+	std::size_t characterCount = 0;
+
+	// Continuation bytes do not start a character
+	for (const auto character : text) {
+		if ((static_cast<std::uint8_t>(character) & 0xC0) != 0x80) {
+			++characterCount;
+		}
+	}
+
+	return static_cast<float>(characterCount) * fontSize * AVERAGE_GLYPH_ADVANCE_EM;
+}
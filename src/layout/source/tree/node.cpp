@@ -0,0 +1,169 @@
+#include "layout/tree/node.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+
+using namespace layout::tree;
+
+// Every bit a freshly created node starts out with, so the first update styles and lays it out
+constexpr DirtyFlags ALL_SELF_DIRTY = DirtyFlags::Style | DirtyFlags::Layout | DirtyFlags::Paint;
+
+Node::Node(const NodeType type, const std::string_view& tagNameOrText) :
+	type(type),
+	tagNameOrText(tagNameOrText),
+	attributes{},
+	parent(nullptr),
+	children{},
+	dirtyFlags(ALL_SELF_DIRTY),
+	computedStyle(style::initialStyle()),
+	layoutCache{} {}
+
+std::unique_ptr<Node> Node::createElement(const std::string_view& tagName) {
+	return std::make_unique<Node>(NodeType::Element, tagName);
+}
+
+std::unique_ptr<Node> Node::createText(const std::string_view& text) {
+	return std::make_unique<Node>(NodeType::Text, text);
+}
+
+Node& Node::appendChild(std::unique_ptr<Node> child) {
+	child->parent = this;
+	auto& added = *children.emplace_back(std::move(child));
+
+	// The new subtree is dirty in its entirety, and this node has to place it
+	// Its fragments were stored relative to the previous parent, so none of them can be reused
+	added.markDirty(ALL_SELF_DIRTY);
+	added.layoutCache.invalidateFragments();
+	markDirty(DirtyFlags::Layout);
+
+	return added;
+}
+
+std::unique_ptr<Node> Node::removeChild(Node& child) {
+	const auto found = std::find_if(children.begin(), children.end(), [&child](const std::unique_ptr<Node>& entry) {
+		return entry.get() == &child;
+	});
+
+	if (found == children.end()) {
+		spdlog::error("Cannot remove a node that is not a child of this node");
+		return nullptr;
+	}
+
+	auto removed = std::move(*found);
+	children.erase(found);
+	removed->parent = nullptr;
+
+	markDirty(DirtyFlags::Layout | DirtyFlags::Paint);
+	return removed;
+}
+
+void Node::setAttribute(const std::string_view& name, const std::string_view& value) {
+	const auto found = attributes.find(name);
+
+	if (found != attributes.end() && found->second == value) {
+		return;
+	}
+
+	attributes.insert_or_assign(std::string(name), std::string(value));
+	markDirty(DirtyFlags::Style);
+}
+
+void Node::removeAttribute(const std::string_view& name) {
+	const auto found = attributes.find(name);
+
+	if (found == attributes.end()) {
+		return;
+	}
+
+	attributes.erase(found);
+	markDirty(DirtyFlags::Style);
+}
+
+void Node::setText(const std::string_view& text) {
+	if (type != NodeType::Text) {
+		spdlog::error("Cannot set the text of an element node");
+		return;
+	}
+
+	if (tagNameOrText == text) {
+		return;
+	}
+
+	tagNameOrText = text;
+	layoutCache.measuredText.invalidate();
+	markDirty(DirtyFlags::Layout | DirtyFlags::Paint);
+}
+
+void Node::markDirty(const DirtyFlags flags) {
+	dirtyFlags |= flags;
+
+	// Walk up the ancestor chain, but stop as soon as an ancestor already knows about a dirty descendant
+	// Anything above that ancestor has been notified by an earlier call, keeping this O(depth) at worst
+	const auto ancestorFlags = toDescendantFlags(flags);
+
+	for (auto ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent) {
+		if ((ancestor->dirtyFlags & ancestorFlags) == ancestorFlags) {
+			break;
+		}
+
+		ancestor->dirtyFlags |= ancestorFlags;
+	}
+}
+
+void Node::markDirtyLocally(const DirtyFlags flags) {
+	dirtyFlags |= flags;
+}
+
+void Node::clearDirty(const DirtyFlags flags) {
+	dirtyFlags &= ~flags;
+}
+
+bool Node::isDirty(const DirtyFlags flags) const {
+	return hasAny(dirtyFlags, flags);
+}
+
+const std::string* Node::getAttribute(const std::string_view& name) const {
+	const auto found = attributes.find(name);
+	return found != attributes.end() ? &found->second : nullptr;
+}
+
+NodeType Node::getType() const {
+	return type;
+}
+
+const std::string& Node::getTagName() const {
+	return tagNameOrText;
+}
+
+const std::string& Node::getText() const {
+	return tagNameOrText;
+}
+
+DirtyFlags Node::getDirtyFlags() const {
+	return dirtyFlags;
+}
+
+Node* Node::getParent() const {
+	return parent;
+}
+
+const std::vector<std::unique_ptr<Node>>& Node::getChildren() const {
+	return children;
+}
+
+const layout::style::ComputedStyle& Node::getComputedStyle() const {
+	return computedStyle;
+}
+
+void Node::setComputedStyle(const style::ComputedStyle& style) {
+	computedStyle = style;
+}
+
+layout::engine::LayoutCache& Node::getLayoutCache() {
+	return layoutCache;
+}
+
+const layout::engine::LayoutCache& Node::getLayoutCache() const {
+	return layoutCache;
+}
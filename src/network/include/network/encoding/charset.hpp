@@ -0,0 +1,42 @@
+#ifndef NETWORK_ENCODING_CHARSET_HPP
+#define NETWORK_ENCODING_CHARSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace network::encoding {
+
+	// Character encodings a document can be decoded from, labels of other encodings are not recognized yet
+	// Reference: https://encoding.spec.whatwg.org/#names-and-labels
+	enum class Charset {
+		Utf8,
+		Utf16LittleEndian,
+		Utf16BigEndian,
+
+		// Also used for ISO-8859-1 and US-ASCII, as browsers do
+		Windows1252
+	};
+
+	// Find the encoding a label such as "utf-8" or "latin1" refers to, ignoring case and surrounding whitespace
+	std::optional<Charset> getCharsetForLabel(const std::string_view& label);
+
+	// Recognize a byte order mark at the start of a document
+	std::optional<Charset> detectByteOrderMark(const std::span<const std::uint8_t> data);
+
+	// Read the "charset" parameter of a Content-Type header value such as "text/html; charset=utf-8"
+	std::optional<Charset> getCharsetFromContentType(const std::string_view& contentType);
+
+	// Look for a <meta charset> or <meta http-equiv="Content-Type"> declaration in the first kilobyte of a document
+	// Reference: https://html.spec.whatwg.org/multipage/parsing.html#prescan-a-byte-stream-to-determine-its-encoding
+	std::optional<Charset> prescanForCharset(const std::span<const std::uint8_t> data);
+
+	// Decide how to decode a document from its first bytes and its Content-Type header, in the order the HTML specification uses
+	// Documents that declare nothing are decoded as UTF-8 when their first bytes are valid UTF-8, and as Windows-1252 otherwise
+	Charset determineCharset(const std::span<const std::uint8_t> prefix, const std::string_view& contentType = {});
+
+}
+
+#endif // !NETWORK_ENCODING_CHARSET_HPP
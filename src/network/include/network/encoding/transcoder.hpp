@@ -0,0 +1,57 @@
+#ifndef NETWORK_ENCODING_TRANSCODER_HPP
+#define NETWORK_ENCODING_TRANSCODER_HPP
+
+#include "charset.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace network::encoding {
+
+	// Converts a document to UTF-8 as its bytes arrive, malformed input is replaced with U+FFFD
+	// Runs of ASCII and valid UTF-8 are appended to the output in a single copy, only a sequence that is split between chunks is held back
+	class Transcoder final {
+	public:
+		explicit Transcoder(const Charset charset);
+		Transcoder(const Transcoder&) = delete;
+		Transcoder(Transcoder&&) = delete;
+		Transcoder& operator=(const Transcoder&) = delete;
+		Transcoder& operator=(Transcoder&&) = delete;
+		~Transcoder() = default;
+
+		// Convert the next chunk of the document and append it to "output", a byte order mark at the start is left out
+		void decode(const std::span<const std::uint8_t> chunk, std::string& output);
+
+		// Replace a sequence that was cut off by the end of the document, after which the transcoder can start a new document
+		void finish(std::string& output);
+
+		// Encoding the document is decoded from
+		Charset getCharset() const;
+
+		// Number of replacement characters that were written for malformed input
+		std::size_t getErrorCount() const;
+
+	private:
+		void decodeUtf8(std::span<const std::uint8_t> chunk, std::string& output);
+		void decodeUtf16(const std::span<const std::uint8_t> chunk, std::string& output);
+		void decodeWindows1252(const std::span<const std::uint8_t> chunk, std::string& output);
+
+	private:
+		const Charset charset;
+
+		// Start of a sequence that continues in the next chunk, at most three bytes (UTF-16 needs three for a split surrogate pair)
+		std::array<std::uint8_t, 4> pendingBytes;
+		std::size_t pendingSize;
+
+		// Whether no character was written yet, which is where a byte order mark is dropped
+		bool isAtStart;
+
+		std::size_t errorCount;
+	};
+
+}
+
+#endif // !NETWORK_ENCODING_TRANSCODER_HPP
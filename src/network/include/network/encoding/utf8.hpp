@@ -0,0 +1,45 @@
+#ifndef NETWORK_ENCODING_UTF8_HPP
+#define NETWORK_ENCODING_UTF8_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace network::encoding {
+
+	enum class SequenceStatus {
+		Valid,
+		Invalid,
+
+		// The data ends in the middle of a sequence that is valid so far
+		Incomplete
+	};
+
+	// Result of checking the UTF-8 sequence at the start of some data
+	struct Utf8Sequence {
+		SequenceStatus status;
+
+		// Bytes in a valid sequence, or bytes to replace with a single U+FFFD when it is invalid (always at least one)
+		std::size_t size;
+	};
+
+	// Replacement character for malformed input
+	constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+	// Number of ASCII bytes at the start of the data, checked 16 bytes at a time where SSE2 is available
+	std::size_t countAsciiPrefix(const std::span<const std::uint8_t> data);
+
+	// Check the UTF-8 sequence at the start of non-empty data, invalid input is split the way the Encoding Standard specifies
+	// Reference: https://encoding.spec.whatwg.org/#utf-8-decoder
+	Utf8Sequence checkUtf8Sequence(const std::span<const std::uint8_t> data);
+
+	// Returns whether the data is valid UTF-8, "allowIncomplete" accepts a sequence that is cut off at the end (as in the first chunk of a stream)
+	bool isValidUtf8(const std::span<const std::uint8_t> data, const bool allowIncomplete = false);
+
+	// Append the UTF-8 encoding of a code point
+	void appendUtf8(std::string& output, const char32_t codePoint);
+
+}
+
+#endif // !NETWORK_ENCODING_UTF8_HPP
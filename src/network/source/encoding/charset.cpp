@@ -0,0 +1,302 @@
+#include "network/encoding/charset.hpp"
+#include "network/encoding/utf8.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+using namespace network::encoding;
+
+// The prescan gives up after this many bytes
+constexpr std::size_t PRESCAN_LENGTH = 1'024;
+
+// Reference: https://encoding.spec.whatwg.org/#names-and-labels
+constexpr std::array<std::pair<std::string_view, Charset>, 31> CHARSET_LABELS = { {
+	{ "ansi_x3.4-1968", Charset::Windows1252 },
+	{ "ascii", Charset::Windows1252 },
+	{ "cp1252", Charset::Windows1252 },
+	{ "cp819", Charset::Windows1252 },
+	{ "csisolatin1", Charset::Windows1252 },
+	{ "csunicode", Charset::Utf16LittleEndian },
+	{ "ibm819", Charset::Windows1252 },
+	{ "iso-10646-ucs-2", Charset::Utf16LittleEndian },
+	{ "iso-8859-1", Charset::Windows1252 },
+	{ "iso-ir-100", Charset::Windows1252 },
+	{ "iso8859-1", Charset::Windows1252 },
+	{ "iso88591", Charset::Windows1252 },
+	{ "iso_8859-1", Charset::Windows1252 },
+	{ "iso_8859-1:1987", Charset::Windows1252 },
+	{ "l1", Charset::Windows1252 },
+	{ "latin1", Charset::Windows1252 },
+	{ "ucs-2", Charset::Utf16LittleEndian },
+	{ "unicode", Charset::Utf16LittleEndian },
+	{ "unicode-1-1-utf-8", Charset::Utf8 },
+	{ "unicode11utf8", Charset::Utf8 },
+	{ "unicode20utf8", Charset::Utf8 },
+	{ "unicodefeff", Charset::Utf16LittleEndian },
+	{ "unicodefffe", Charset::Utf16BigEndian },
+	{ "us-ascii", Charset::Windows1252 },
+	{ "utf-16", Charset::Utf16LittleEndian },
+	{ "utf-16be", Charset::Utf16BigEndian },
+	{ "utf-16le", Charset::Utf16LittleEndian },
+	{ "utf-8", Charset::Utf8 },
+	{ "utf8", Charset::Utf8 },
+	{ "windows-1252", Charset::Windows1252 },
+	{ "x-cp1252", Charset::Windows1252 }
+} };
+
+static bool isWhitespace(const char character) {
+	return character == ' ' || character == '\t' || character == '\n' || character == '\f' || character == '\r';
+}
+
+static char toLower(const char character) {
+	return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character;
+}
+
+static bool equalsIgnoringCase(const std::string_view& text, const std::string_view& lowercase) {
+	return text.size() == lowercase.size() && std::equal(text.begin(), text.end(), lowercase.begin(), [](const char a, const char b) {
+		return toLower(a) == b;
+	});
+}
+
+static std::string_view trimWhitespace(std::string_view text) {
+	while (!text.empty() && isWhitespace(text.front())) {
+		text.remove_prefix(1);
+	}
+
+	while (!text.empty() && isWhitespace(text.back())) {
+		text.remove_suffix(1);
+	}
+
+	return text;
+}
+
+// Find "charset=" in a Content-Type value (or the content attribute of a meta element) and return the label that follows it
+// Reference: https://html.spec.whatwg.org/multipage/urls-and-fetching.html#algorithm-for-extracting-a-character-encoding-from-a-meta-element
+static std::optional<std::string_view> extractCharsetParameter(const std::string_view& text) {
+	constexpr std::string_view parameterName = "charset";
+
+	for (std::size_t position = 0; position + parameterName.size() <= text.size(); ++position) {
+		if (!equalsIgnoringCase(text.substr(position, parameterName.size()), parameterName)) {
+			continue;
+		}
+
+		auto rest = text.substr(position + parameterName.size());
+
+		while (!rest.empty() && isWhitespace(rest.front())) {
+			rest.remove_prefix(1);
+		}
+
+		// "charset" without an equals sign is not the parameter, keep looking after it
+		if (rest.empty() || rest.front() != '=') {
+			position += parameterName.size() - 1;
+			continue;
+		}
+
+		rest = trimWhitespace(rest.substr(1));
+
+		if (rest.empty()) {
+			return std::nullopt;
+		}
+
+		if (rest.front() == '"' || rest.front() == '\'') {
+			const auto end = rest.find(rest.front(), 1);
+			return end == std::string_view::npos ? std::nullopt : std::optional(rest.substr(1, end - 1));
+		}
+
+		return rest.substr(0, std::min(rest.find(';'), rest.find_first_of(" \t\n\f\r")));
+	}
+
+	return std::nullopt;
+}
+
+// Read the next attribute of a tag, "position" is moved past it - returns nothing at the end of the tag
+// Reference: https://html.spec.whatwg.org/multipage/parsing.html#concept-get-attributes-when-sniffing
+static std::optional<std::pair<std::string_view, std::string_view>> readAttribute(const std::string_view& text, std::size_t& position) {
+	while (position < text.size() && (isWhitespace(text[position]) || text[position] == '/')) {
+		++position;
+	}
+
+	if (position >= text.size() || text[position] == '>') {
+		return std::nullopt;
+	}
+
+	const auto nameStart = position;
+
+	// The first character is part of the name even when it is an equals sign
+	do {
+		++position;
+	} while (position < text.size() && text[position] != '=' && text[position] != '>' && text[position] != '/' && !isWhitespace(text[position]));
+
+	const auto name = text.substr(nameStart, position - nameStart);
+
+	while (position < text.size() && isWhitespace(text[position])) {
+		++position;
+	}
+
+	if (position >= text.size() || text[position] != '=') {
+		return std::pair(name, std::string_view());
+	}
+
+	++position;
+
+	while (position < text.size() && isWhitespace(text[position])) {
+		++position;
+	}
+
+	if (position < text.size() && (text[position] == '"' || text[position] == '\'')) {
+		const auto quote = text[position];
+		const auto valueStart = ++position;
+
+		position = std::min(text.find(quote, valueStart), text.size());
+		const auto value = text.substr(valueStart, position - valueStart);
+
+		++position;
+		return std::pair(name, value);
+	}
+
+	const auto valueStart = position;
+
+	while (position < text.size() && text[position] != '>' && !isWhitespace(text[position])) {
+		++position;
+	}
+
+	return std::pair(name, text.substr(valueStart, position - valueStart));
+}
+
+// Attributes of a meta element that declare an encoding
+static std::optional<Charset> readMetaCharset(const std::string_view& text, std::size_t& position) {
+	auto hasPragma = false;
+	std::optional<bool> needsPragma;
+	std::optional<Charset> charset;
+
+	while (const auto attribute = readAttribute(text, position)) {
+		const auto& [name, value] = attribute.value();
+
+		if (equalsIgnoringCase(name, "http-equiv")) {
+			hasPragma = hasPragma || equalsIgnoringCase(value, "content-type");
+		} else if (equalsIgnoringCase(name, "content") && !charset.has_value()) {
+			const auto label = extractCharsetParameter(value);
+
+			if (label.has_value()) {
+				charset = getCharsetForLabel(label.value());
+				needsPragma = true;
+			}
+		} else if (equalsIgnoringCase(name, "charset")) {
+			charset = getCharsetForLabel(value);
+			needsPragma = false;
+		}
+	}
+
+	if (!needsPragma.has_value() || (needsPragma.value() && !hasPragma) || !charset.has_value()) {
+		return std::nullopt;
+	}
+
+	// A document that could be read this far is not UTF-16, whatever it claims
+	if (charset.value() == Charset::Utf16LittleEndian || charset.value() == Charset::Utf16BigEndian) {
+		return Charset::Utf8;
+	}
+
+	return charset;
+}
+
+std::optional<Charset> network::encoding::getCharsetForLabel(const std::string_view& label) {
+	const auto trimmed = trimWhitespace(label);
+
+	const auto entry = std::find_if(CHARSET_LABELS.begin(), CHARSET_LABELS.end(), [&trimmed](const auto& candidate) {
+		return equalsIgnoringCase(trimmed, candidate.first);
+	});
+
+	return entry != CHARSET_LABELS.end() ? std::optional(entry->second) : std::nullopt;
+}
+
+std::optional<Charset> network::encoding::detectByteOrderMark(const std::span<const std::uint8_t> data) {
+	if (data.size() >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+		return Charset::Utf8;
+	}
+
+	if (data.size() >= 2 && data[0] == 0xFE && data[1] == 0xFF) {
+		return Charset::Utf16BigEndian;
+	}
+
+	if (data.size() >= 2 && data[0] == 0xFF && data[1] == 0xFE) {
+		return Charset::Utf16LittleEndian;
+	}
+
+	return std::nullopt;
+}
+
+std::optional<Charset> network::encoding::getCharsetFromContentType(const std::string_view& contentType) {
+	const auto label = extractCharsetParameter(contentType);
+	return label.has_value() ? getCharsetForLabel(label.value()) : std::nullopt;
+}
+
+std::optional<Charset> network::encoding::prescanForCharset(const std::span<const std::uint8_t> data) {
+	const std::string_view text(reinterpret_cast<const char*>(data.data()), std::min(data.size(), PRESCAN_LENGTH));
+	std::size_t position = 0;
+
+	const auto startsWith = [&text, &position](const std::string_view& prefix) {
+		return equalsIgnoringCase(text.substr(position, prefix.size()), prefix);
+	};
+
+	const auto isLetter = [](const char character) {
+		return toLower(character) >= 'a' && toLower(character) <= 'z';
+	};
+
+	while (position < text.size()) {
+		if (startsWith("<!--")) {
+			// The end of the comment may share its dashes with the start
+			position = text.find("-->", position + 2);
+
+			if (position == std::string_view::npos) {
+				return std::nullopt;
+			}
+
+			position += 3;
+		} else if (startsWith("<meta") && position + 5 < text.size() && (isWhitespace(text[position + 5]) || text[position + 5] == '/')) {
+			position += 5;
+
+			if (const auto charset = readMetaCharset(text, position)) {
+				return charset;
+			}
+		} else if (position + 1 < text.size() && text[position] == '<' && (isLetter(text[position + 1]) || (text[position + 1] == '/' && position + 2 < text.size() && isLetter(text[position + 2])))) {
+			// Other tags are skipped along with their attributes, so a ">" inside a quoted value does not end them
+			while (position < text.size() && !isWhitespace(text[position]) && text[position] != '>') {
+				++position;
+			}
+
+			while (readAttribute(text, position).has_value()) {}
+
+			++position;
+		} else if (startsWith("<!") || startsWith("</") || startsWith("<?")) {
+			position = text.find('>', position + 2);
+
+			if (position == std::string_view::npos) {
+				return std::nullopt;
+			}
+
+			++position;
+		} else {
+			++position;
+		}
+	}
+
+	return std::nullopt;
+}
+
+Charset network::encoding::determineCharset(const std::span<const std::uint8_t> prefix, const std::string_view& contentType) {
+	if (const auto charset = detectByteOrderMark(prefix)) {
+		return charset.value();
+	}
+
+	if (const auto charset = getCharsetFromContentType(contentType)) {
+		return charset.value();
+	}
+
+	if (const auto charset = prescanForCharset(prefix)) {
+		return charset.value();
+	}
+
+	// Text in any other encoding rarely happens to be valid UTF-8, so this guess is cheap and almost never wrong
+	return isValidUtf8(prefix, true) ? Charset::Utf8 : Charset::Windows1252;
+}
@@ -0,0 +1,209 @@
+#include "network/encoding/transcoder.hpp"
+#include "network/encoding/utf8.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+using namespace network::encoding;
+
+// Code points of bytes 0x80 to 0x9F, the remaining bytes above ASCII map to the same code point as in ISO-8859-1
+// Reference: https://encoding.spec.whatwg.org/index-windows-1252.txt
+constexpr std::array<char16_t, 32> WINDOWS_1252_HIGH_CONTROLS = {
+	0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+// U+FEFF in UTF-8
+constexpr std::string_view BYTE_ORDER_MARK = "\xEF\xBB\xBF";
+
+static void appendBytes(std::string& output, const std::span<const std::uint8_t> bytes) {
+	output.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+Transcoder::Transcoder(const Charset charset) :
+	charset(charset),
+	pendingBytes{},
+	pendingSize{ 0 },
+	isAtStart{ true },
+	errorCount{ 0 } {}
+
+void Transcoder::decode(const std::span<const std::uint8_t> chunk, std::string& output) {
+	const auto start = output.size();
+
+	switch (charset) {
+		case Charset::Utf8:
+			decodeUtf8(chunk, output);
+			break;
+
+		case Charset::Utf16LittleEndian:
+		case Charset::Utf16BigEndian:
+			decodeUtf16(chunk, output);
+			break;
+
+		case Charset::Windows1252:
+			decodeWindows1252(chunk, output);
+			break;
+	}
+
+	// The byte order mark is always written as a whole, a partial one is still pending
+	if (isAtStart && output.size() > start) {
+		if (charset != Charset::Windows1252 && std::string_view(output).substr(start, BYTE_ORDER_MARK.size()) == BYTE_ORDER_MARK) {
+			output.erase(start, BYTE_ORDER_MARK.size());
+		}
+
+		isAtStart = false;
+	}
+}
+
+void Transcoder::finish(std::string& output) {
+	if (pendingSize > 0) {
+		appendUtf8(output, REPLACEMENT_CHARACTER);
+		++errorCount;
+	}
+
+	pendingSize = 0;
+	isAtStart = true;
+}
+
+Charset Transcoder::getCharset() const {
+	return charset;
+}
+
+std::size_t Transcoder::getErrorCount() const {
+	return errorCount;
+}
+
+void Transcoder::decodeUtf8(std::span<const std::uint8_t> chunk, std::string& output) {
+	// Complete the sequence the previous chunk ended in, one byte at a time as it is at most four bytes long
+	if (pendingSize > 0) {
+		std::size_t takenBytes = 0;
+		auto sequence = checkUtf8Sequence({ pendingBytes.data(), pendingSize });
+
+		while (sequence.status == SequenceStatus::Incomplete && takenBytes < chunk.size()) {
+			pendingBytes[pendingSize++] = chunk[takenBytes++];
+			sequence = checkUtf8Sequence({ pendingBytes.data(), pendingSize });
+		}
+
+		if (sequence.status == SequenceStatus::Incomplete) {
+			return;
+		}
+
+		if (sequence.status == SequenceStatus::Valid) {
+			appendBytes(output, { pendingBytes.data(), sequence.size });
+		} else {
+			appendUtf8(output, REPLACEMENT_CHARACTER);
+			++errorCount;
+		}
+
+		// A byte that broke the sequence may start the next one, it is read again from the chunk
+		const auto unusedBytes = pendingSize - sequence.size;
+		pendingSize = 0;
+		chunk = chunk.subspan(takenBytes - unusedBytes);
+	}
+
+	// Valid input is appended in runs, which are only broken up by malformed sequences
+	std::size_t runStart = 0;
+	std::size_t position = 0;
+
+	while (true) {
+		position += countAsciiPrefix(chunk.subspan(position));
+
+		if (position == chunk.size()) {
+			break;
+		}
+
+		const auto sequence = checkUtf8Sequence(chunk.subspan(position));
+
+		if (sequence.status == SequenceStatus::Valid) {
+			position += sequence.size;
+			continue;
+		}
+
+		appendBytes(output, chunk.subspan(runStart, position - runStart));
+
+		if (sequence.status == SequenceStatus::Incomplete) {
+			std::copy(chunk.begin() + static_cast<std::ptrdiff_t>(position), chunk.end(), pendingBytes.begin());
+			pendingSize = chunk.size() - position;
+			return;
+		}
+
+		appendUtf8(output, REPLACEMENT_CHARACTER);
+		++errorCount;
+
+		position += sequence.size;
+		runStart = position;
+	}
+
+	appendBytes(output, chunk.subspan(runStart));
+}
+
+void Transcoder::decodeUtf16(const std::span<const std::uint8_t> chunk, std::string& output) {
+	const auto isBigEndian = charset == Charset::Utf16BigEndian;
+	const auto totalSize = pendingSize + chunk.size();
+
+	// Bytes held back from the previous chunk come first
+	const auto getByte = [this, &chunk](const std::size_t index) -> std::uint32_t {
+		return index < pendingSize ? pendingBytes[index] : chunk[index - pendingSize];
+	};
+
+	const auto readUnit = [&getByte, isBigEndian](const std::size_t index) {
+		return isBigEndian ? getByte(index) << 8 | getByte(index + 1) : getByte(index + 1) << 8 | getByte(index);
+	};
+
+	std::size_t position = 0;
+
+	while (position + 2 <= totalSize) {
+		const auto unit = readUnit(position);
+
+		if (unit < 0xD800 || unit > 0xDFFF) {
+			appendUtf8(output, unit);
+			position += 2;
+			continue;
+		}
+
+		// A high surrogate must be followed by a low surrogate, anything else is replaced and read again
+		if (unit <= 0xDBFF) {
+			if (position + 4 > totalSize) {
+				break;
+			}
+
+			const auto next = readUnit(position + 2);
+
+			if (next >= 0xDC00 && next <= 0xDFFF) {
+				appendUtf8(output, 0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00));
+				position += 4;
+				continue;
+			}
+		}
+
+		appendUtf8(output, REPLACEMENT_CHARACTER);
+		++errorCount;
+		position += 2;
+	}
+
+	std::array<std::uint8_t, 4> remainingBytes{};
+
+	for (auto i = position; i < totalSize; ++i) {
+		remainingBytes[i - position] = static_cast<std::uint8_t>(getByte(i));
+	}
+
+	pendingBytes = remainingBytes;
+	pendingSize = totalSize - position;
+}
+
+void Transcoder::decodeWindows1252(const std::span<const std::uint8_t> chunk, std::string& output) {
+	std::size_t position = 0;
+
+	while (true) {
+		const auto asciiSize = countAsciiPrefix(chunk.subspan(position));
+		appendBytes(output, chunk.subspan(position, asciiSize));
+		position += asciiSize;
+
+		if (position == chunk.size()) {
+			break;
+		}
+
+		const auto byte = chunk[position++];
+		appendUtf8(output, byte < 0xA0 ? static_cast<char32_t>(WINDOWS_1252_HIGH_CONTROLS[byte - 0x80]) : static_cast<char32_t>(byte));
+	}
+}
@@ -0,0 +1,127 @@
+#include "network/encoding/utf8.hpp"
+
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PLAIN_ENCODING_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace network::encoding;
+
+std::size_t network::encoding::countAsciiPrefix(const std::span<const std::uint8_t> data) {
+	const auto* const bytes = data.data();
+	const auto size = data.size();
+	std::size_t i = 0;
+
+#ifdef PLAIN_ENCODING_SSE2
+	// Four vectors are combined before testing, which keeps long runs of ASCII at memory bandwidth
+	for (; i + 64 <= size; i += 64) {
+		const auto first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+		const auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i + 16));
+		const auto third = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i + 32));
+		const auto fourth = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i + 48));
+
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(first, second), _mm_or_si128(third, fourth))) != 0) {
+			break;
+		}
+	}
+
+	// The most significant bit of every byte ends up in the mask, the first one that is set is the first byte that is not ASCII
+	for (; i + 16 <= size; i += 16) {
+		const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i))));
+
+		if (mask != 0) {
+			return i + static_cast<std::size_t>(std::countr_zero(mask));
+		}
+	}
+#endif
+
+	while (i < size && bytes[i] < 0x80) {
+		++i;
+	}
+
+	return i;
+}
+
+Utf8Sequence network::encoding::checkUtf8Sequence(const std::span<const std::uint8_t> data) {
+	const auto lead = data[0];
+
+	if (lead < 0x80) {
+		return { SequenceStatus::Valid, 1 };
+	}
+
+	std::size_t continuationCount = 0;
+
+	// The second byte has a narrower range for some lead bytes, which rules out overlong encodings, surrogates, and code points beyond U+10FFFF
+	std::uint8_t lowerBound = 0x80;
+	std::uint8_t upperBound = 0xBF;
+
+	if (lead >= 0xC2 && lead <= 0xDF) {
+		continuationCount = 1;
+	} else if (lead >= 0xE0 && lead <= 0xEF) {
+		continuationCount = 2;
+		lowerBound = lead == 0xE0 ? 0xA0 : 0x80;
+		upperBound = lead == 0xED ? 0x9F : 0xBF;
+	} else if (lead >= 0xF0 && lead <= 0xF4) {
+		continuationCount = 3;
+		lowerBound = lead == 0xF0 ? 0x90 : 0x80;
+		upperBound = lead == 0xF4 ? 0x8F : 0xBF;
+	} else {
+		return { SequenceStatus::Invalid, 1 };
+	}
+
+	for (std::size_t i = 1; i <= continuationCount; ++i) {
+		if (i == data.size()) {
+			return { SequenceStatus::Incomplete, i };
+		}
+
+		if (data[i] < lowerBound || data[i] > upperBound) {
+			// The byte that does not fit is not part of the replaced bytes, it may start the next sequence
+			return { SequenceStatus::Invalid, i };
+		}
+
+		lowerBound = 0x80;
+		upperBound = 0xBF;
+	}
+
+	return { SequenceStatus::Valid, continuationCount + 1 };
+}
+
+bool network::encoding::isValidUtf8(const std::span<const std::uint8_t> data, const bool allowIncomplete) {
+	std::size_t i = 0;
+
+	while (true) {
+		i += countAsciiPrefix(data.subspan(i));
+
+		if (i == data.size()) {
+			return true;
+		}
+
+		const auto sequence = checkUtf8Sequence(data.subspan(i));
+
+		if (sequence.status != SequenceStatus::Valid) {
+			return sequence.status == SequenceStatus::Incomplete && allowIncomplete;
+		}
+
+		i += sequence.size;
+	}
+}
+
+void network::encoding::appendUtf8(std::string& output, const char32_t codePoint) {
+	if (codePoint < 0x80) {
+		output += static_cast<char>(codePoint);
+	} else if (codePoint < 0x800) {
+		output += static_cast<char>(0xC0 | (codePoint >> 6));
+		output += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else if (codePoint < 0x10000) {
+		output += static_cast<char>(0xE0 | (codePoint >> 12));
+		output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		output += static_cast<char>(0x80 | (codePoint & 0x3F));
+	} else {
+		output += static_cast<char>(0xF0 | (codePoint >> 18));
+		output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		output += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
@@ -1,5 +1,7 @@
 #include "network/http/request_message.hpp"
 
+#include "core/profiling/trace.hpp"
+
 #include "spdlog/spdlog.h"
 
 using namespace network::http;
@@ -8,6 +10,8 @@ using namespace network::http;
 constexpr const char* const LINE_BREAK = "\r\n";
 
 std::string RequestMessage::generate() const {
+	PLAIN_TRACE_SCOPE("RequestMessage::generate");
+
 	// Start line
 	auto data = method + ' ' + target + ' ' + version + LINE_BREAK;
 
@@ -22,7 +26,7 @@ std::string RequestMessage::generate() const {
 	// Optional body
 	data += body;
 
-	spdlog::trace(data);
+	SPDLOG_TRACE("{}", data);
 
 	return data;
 }
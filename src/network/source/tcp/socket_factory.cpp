@@ -1,6 +1,8 @@
 #include "network/tcp/socket_factory.hpp"
 #include "network/tcp/windows/windows_socket.hpp"
 
+#include "core/profiling/trace.hpp"
+
 #include "spdlog/spdlog.h"
 
 #include <memory>
@@ -8,6 +10,8 @@
 using namespace network::tcp;
 
 std::unique_ptr<TcpSocket> SocketFactory::create() {
+	PLAIN_TRACE_SCOPE("SocketFactory::create");
+
 #if WIN32
 	spdlog::debug("Creating new Windows TCP socket");
 	return std::make_unique<windows::WindowsTcpSocket>();
@@ -2,11 +2,15 @@
 
 #include "network/tcp/windows/windows_socket.hpp"
 
+#include "core/profiling/trace.hpp"
+
 #include "spdlog/spdlog.h"
 
 #include <WS2tcpip.h>
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace network;
@@ -47,6 +51,8 @@ WindowsTcpSocket::~WindowsTcpSocket() {
 }
 
 bool WindowsTcpSocket::open(const std::string_view& hostName, std::uint32_t port) {
+	PLAIN_TRACE_SCOPE("TcpSocket::open");
+
 	ADDRINFO hints;
 	PADDRINFOA addrinfo;
 
@@ -110,7 +116,9 @@ bool WindowsTcpSocket::open(const std::string_view& hostName, std::uint32_t port
 }
 
 bool WindowsTcpSocket::send(const std::string_view& payload) {
-	spdlog::debug("Sending payload...");
+	PLAIN_TRACE_SCOPE("TcpSocket::send");
+
+	SPDLOG_DEBUG("Sending payload...");
 	const auto result = ::send(socket, payload.data(), static_cast<int>(payload.length()), 0);
 
 	if (result == SOCKET_ERROR) {
@@ -118,11 +126,13 @@ bool WindowsTcpSocket::send(const std::string_view& payload) {
 		return false;
 	}
 
-	spdlog::debug("Successfully sent payload");
+	SPDLOG_DEBUG("Successfully sent payload");
 	return true;
 }
 
 bool WindowsTcpSocket::receive() {
+	PLAIN_TRACE_SCOPE("TcpSocket::receive");
+
 	{
 		auto result = -1;
 
@@ -130,16 +140,11 @@ bool WindowsTcpSocket::receive() {
 			result = recv(socket, reinterpret_cast<char*>(receiveBuffer), sizeof(receiveBuffer), 0);
 
 			if (result > 0) {
-				spdlog::debug("Bytes received: {}", result);
-
-				std::string output;
-				for (int i = 0; i < result; ++i) {
-					output += receiveBuffer[i];
-				}
-
-				spdlog::trace(output);
+				// Compiled out below the debug and trace levels, the received bytes are not copied just to log them
+				SPDLOG_DEBUG("Bytes received: {}", result);
+				SPDLOG_TRACE("{}", std::string_view(reinterpret_cast<const char*>(receiveBuffer), static_cast<std::size_t>(result)));
 			} else if (result == 0) {
-				spdlog::debug("Connection closed by server");
+				SPDLOG_DEBUG("Connection closed by server");
 			} else {
 				spdlog::error("Receive failed: {}", WSAGetLastError());
 				return false;
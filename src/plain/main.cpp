@@ -1,36 +1,338 @@
+#include "painter.hpp"
+
+#include "graphics/renderer/compositor.hpp"
 #include "graphics/renderer/renderer.hpp"
+#include "graphics/text/text_system.hpp"
 #include "graphics/window/window.hpp"
 
+#include "layout/engine/layout_engine.hpp"
+#include "layout/tree/node.hpp"
+
+#include "core/logging/async_logging.hpp"
+#include "core/profiling/trace.hpp"
+#include "core/threading/thread_pool.hpp"
+
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
 using namespace graphics::window;
 using namespace graphics::renderer;
 
 constexpr const char* const USER_AGENT_NAME = "Plain/0.1";
 
+// Size of the window, and of the images rendered in headless mode
+constexpr std::uint32_t WINDOW_WIDTH = 800;
+constexpr std::uint32_t WINDOW_HEIGHT = 600;
+
+// Number of frames rendered in headless mode when not specified on the command line
+constexpr std::uint32_t HEADLESS_DEFAULT_FRAME_COUNT = 100;
+
+// Upper limit of how long the main loop blocks on the event queue, frames are drawn by the compositor thread in the meantime
+// The compositor wakes the loop right away through Window::wake() once a scroll comes to rest, so the hovered fragment follows the page
+constexpr std::chrono::milliseconds IDLE_WAIT_TIMEOUT{ 1'000 };
+
+// Time it takes a new document to fade in, which the compositor animates on its own
+constexpr std::chrono::milliseconds PAGE_FADE_IN_DURATION{ 200 };
+
+// Locations of a sans-serif font on common platforms, the first one that exists is used
+constexpr std::array<std::string_view, 4> DEFAULT_FONT_PATHS = {
+	"./resources/fonts/default.ttf",
+	"C:/Windows/Fonts/arial.ttf",
+	"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+	"/System/Library/Fonts/Supplemental/Arial.ttf"
+};
+
+// Small document that is shown until pages can be loaded from the network
+std::unique_ptr<layout::tree::Node> createWelcomeDocument() {
+	auto body = layout::tree::Node::createElement("body");
+	body->setAttribute("style", "padding: 16px; background-color: #ffffff; color: #202020; font-size: 16px; line-height: 24px");
+
+	auto& heading = body->appendChild(layout::tree::Node::createElement("h1"));
+	heading.setAttribute("style", "font-size: 32px; line-height: 48px");
+	heading.appendChild(layout::tree::Node::createText("Plain"));
+
+	auto& paragraph = body->appendChild(layout::tree::Node::createElement("p"));
+	paragraph.setAttribute("style", "padding: 8px; background-color: #e8eef8");
+	paragraph.appendChild(layout::tree::Node::createText("A webbrowser written from scratch, rendered with Vulkan."));
+
+	return body;
+}
+
+// Command line options
+struct Options {
+	// Render without a window, used for automated tests and benchmarks
+	bool isHeadless;
+
+	// Number of frames rendered in headless mode
+	std::uint32_t frameCount;
+
+	// File the last headless frame is written to (PNG or PPM), nothing is written when empty
+	std::string outputPath;
+
+	// How frames are paced on screen
+	PacingPolicy pacingPolicy;
+
+	// Show the GPU time of every pass on screen
+	bool showProfiler;
+
+	// File trace events are written to on exit (Chrome trace format), nothing is traced when empty
+	std::string tracePath;
+};
+
+Options parseOptions(const int argc, char* argv[]) {
+	Options options{ false, HEADLESS_DEFAULT_FRAME_COUNT, {}, PacingPolicy::Adaptive, false, {} };
+
+	for (auto i = 1; i < argc; ++i) {
+		const std::string_view argument = argv[i];
+		const auto hasValue = i + 1 < argc;
+
+		if (argument == "--headless") {
+			options.isHeadless = true;
+		} else if (argument == "--frames" && hasValue) {
+			options.frameCount = static_cast<std::uint32_t>(std::max(1, std::atoi(argv[++i])));
+		} else if (argument == "--output" && hasValue) {
+			options.outputPath = argv[++i];
+		} else if (argument == "--profile") {
+			options.showProfiler = true;
+		} else if (argument == "--trace" && hasValue) {
+			options.tracePath = argv[++i];
+		} else if (argument == "--pacing" && hasValue) {
+			const std::string_view policy = argv[++i];
+
+			if (policy == "low-latency") {
+				options.pacingPolicy = PacingPolicy::LowLatency;
+			} else if (policy == "power-saving") {
+				options.pacingPolicy = PacingPolicy::PowerSaving;
+			} else if (policy == "adaptive") {
+				options.pacingPolicy = PacingPolicy::Adaptive;
+			} else {
+				spdlog::warn("Ignoring unknown pacing policy \"{}\"", policy);
+			}
+		} else {
+			spdlog::warn("Ignoring unknown command line argument \"{}\"", argument);
+		}
+	}
+
+	return options;
+}
+
+// Start recording trace events when a trace file was requested
+void startTrace(const Options& options) {
+	if (options.tracePath.empty()) {
+		return;
+	}
+
+#ifndef PLAIN_TRACING
+	spdlog::warn("Trace scopes are not compiled in, configure with PLAIN_TRACING=ON to record events");
+#endif
+
+	core::profiling::setThreadName("Main");
+	core::profiling::startTracing();
+}
+
+// Write the recorded trace events, if any were requested
+void finishTrace(const Options& options) {
+	if (options.tracePath.empty()) {
+		return;
+	}
+
+	core::profiling::stopTracing();
+	core::profiling::writeTrace(options.tracePath);
+}
+
+// Text is measured with the font, size, and shaping the painter uses, so lines break where the glyphs actually end
+// The fonts are separate from those of the renderer, which the compositor thread rasterizes glyphs with while layout measures text
+layout::text::MeasureFunction createMeasureFunction(graphics::text::FontCollection& fonts, graphics::text::ShapingCache& shapingCache, const std::optional<graphics::text::FontId>& font) {
+	if (!font.has_value()) {
+		return {};
+	}
+
+	return [&fonts, &shapingCache, font = font.value()](const std::string_view& text, const float fontSize) {
+		return shapingCache.shape(fonts, font, static_cast<std::uint32_t>(std::lround(fontSize)), text).width;
+	};
+}
+
+// Paint the fragments of a layout pass into a layer tree the compositor can take over
+LayerTree createLayerTree(const layout::fragment::FragmentTree& fragments, const graphics::text::FontId font, const std::optional<LayerAnimation>& animation = {}) {
+	auto contentWidth = 0.0f;
+	auto contentHeight = 0.0f;
+
+	for (std::size_t i = 0; i < fragments.size(); ++i) {
+		contentWidth = std::max(contentWidth, fragments.getX()[i] + fragments.getWidth()[i]);
+		contentHeight = std::max(contentHeight, fragments.getY()[i] + fragments.getHeight()[i]);
+	}
+
+	return { plain::paint(fragments, font), contentWidth, contentHeight, DEFAULT_LAYER_PROPERTIES, animation };
+}
+
+// Render a fixed number of frames as fast as possible and report the throughput
+bool runHeadless(Renderer& renderer, const Options& options) {
+	const auto start = std::chrono::steady_clock::now();
+
+	for (std::uint32_t i = 0; i < options.frameCount; ++i) {
+		// Every frame rasterizes the whole page, otherwise only the first frame would do any work
+		renderer.invalidate();
+		renderer.render();
+	}
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	spdlog::info("Rendered {} frames in {:.3f}s ({:.1f} frames per second)", options.frameCount, elapsed, options.frameCount / elapsed);
+
+	for (const auto& timing : renderer.getGpuTimings()) {
+		spdlog::info("  GPU {}: {:.3f}ms", timing.name, timing.milliseconds);
+	}
+
+	return options.outputPath.empty() || renderer.saveFrame(options.outputPath);
+}
+
 int main(int argc, char* argv[]) {
-	// Unreferenced formal parameter warnings
-	argc;
-	argv;
+	// Declared first so it outlives everything that logs, queued messages are written when main returns
+	const auto logging = core::logging::AsyncLogging();
+
+	const auto options = parseOptions(argc, argv);
+	startTrace(options);
+
+	// Shared by layout and by the renderer, which builds its pipelines on it during startup
+	auto threadPool = core::threading::ThreadPool();
+
+	// The window (and GLFW) only exists when rendering on screen
+	std::optional<Window> window;
+	auto renderer = Renderer(&threadPool);
+	renderer.setPacingPolicy(options.pacingPolicy);
+
+	if (options.isHeadless) {
+		if (!renderer.initializeHeadless(WINDOW_WIDTH, WINDOW_HEIGHT)) {
+			spdlog::critical("Application failed to start because the renderer could not be initialized");
+			return EXIT_FAILURE;
+		}
+	} else {
+		window.emplace(WINDOW_WIDTH, WINDOW_HEIGHT, "Plain - a webbrowser by Tahar Meijs");
+
+		if (!window->create()) {
+			spdlog::critical("Application failed to start because the window could not be created");
+			return EXIT_FAILURE;
+		}
+
+		if (!renderer.initialize(*window)) {
+			spdlog::critical("Application failed to start because the renderer could not be initialized");
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::optional<graphics::text::FontId> font;
+	std::optional<graphics::text::FontId> measuringFont;
+
+	graphics::text::FontCollection measuringFonts;
+	graphics::text::ShapingCache measuringShapingCache;
+
+	if (!measuringFonts.initialize()) {
+		spdlog::warn("Text cannot be measured, line breaks are based on estimated widths");
+	}
+
+	for (const auto& path : DEFAULT_FONT_PATHS) {
+		if (std::filesystem::exists(path)) {
+			font = renderer.getTextSystem().loadFont(path);
 
-	spdlog::set_level(spdlog::level::level_enum::debug);
+			if (font.has_value()) {
+				measuringFont = measuringFonts.load(path);
+				break;
+			}
+		}
+	}
+
+	if (!font.has_value()) {
+		spdlog::warn("No font could be loaded, text will not be drawn");
+	} else if (options.showProfiler) {
+		renderer.setProfilerOverlay(font);
+	}
+
+	auto layoutEngine = layout::engine::LayoutEngine(&threadPool, createMeasureFunction(measuringFonts, measuringShapingCache, measuringFont));
+	auto document = createWelcomeDocument();
+
+	if (options.isHeadless) {
+		layoutEngine.update(*document, { static_cast<float>(WINDOW_WIDTH) });
+		renderer.setDisplayList(plain::paint(*layoutEngine.getFragmentTree(), font.value_or(0)));
+
+		const auto isSuccessful = runHeadless(renderer, options);
+		renderer.destroy();
+		finishTrace(options);
 
-	auto window = Window(800, 600, "Plain - a webbrowser by Tahar Meijs");
-	if (!window.create()) {
-		spdlog::critical("Application failed to start because the window could not be created");
+		return isSuccessful ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// From here on only the compositor thread uses the renderer, until it is stopped
+	auto compositor = Compositor(renderer, *window);
+	const auto fadeIn = LayerAnimation{ { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f }, DEFAULT_LAYER_PROPERTIES, PAGE_FADE_IN_DURATION, Easing::EaseInOut };
+
+	layoutEngine.update(*document, { static_cast<float>(window->getWidth()) });
+	compositor.commit(createLayerTree(*layoutEngine.getFragmentTree(), font.value_or(0), fadeIn));
+
+	if (!compositor.start()) {
+		spdlog::critical("Application failed to start because the compositor could not be started");
+		renderer.destroy();
 		return EXIT_FAILURE;
 	}
 
-	auto renderer = Renderer();
-	renderer.initialize(window);
+	std::optional<std::uint32_t> hoveredFragment;
+
+	// Position on the page the hovered fragment was last looked up at
+	auto hoveredPageX = 0.0f;
+	auto hoveredPageY = 0.0f;
 
 	do {
-		window.poll();
-		renderer.render();
-	} while (window.isAlive());
-	
+		// Frames are drawn by the compositor, the main thread only has to respond to events
+		window->wait(IDLE_WAIT_TIMEOUT);
+
+		// Only the swapchain is rebuilt, the page is laid out again at the new width
+		if (window->consumeResize()) {
+			compositor.resize();
+
+			layoutEngine.update(*document, { static_cast<float>(window->getWidth()) });
+			compositor.commit(createLayerTree(*layoutEngine.getFragmentTree(), font.value_or(0)));
+		}
+
+		if (window->consumeInput()) {
+			compositor.notifyInput();
+		}
+
+		if (const auto [scrollX, scrollY] = window->consumeScroll(); scrollX != 0.0f || scrollY != 0.0f) {
+			compositor.scrollBy(scrollX, scrollY);
+		}
+
+		// Scrolling moves the page under a cursor that stands still, the compositor wakes the loop once the page is at rest
+		const auto isCursorMoved = window->consumeCursorMove();
+		const auto pageX = window->getCursorX() + compositor.getScrollX();
+		const auto pageY = window->getCursorY() + compositor.getScrollY();
+
+		if (isCursorMoved || pageX != hoveredPageX || pageY != hoveredPageY) {
+			hoveredPageX = pageX;
+			hoveredPageY = pageY;
+
+			const auto fragment = layoutEngine.getFragmentTree()->hitTest(pageX, pageY);
+
+			if (fragment != hoveredFragment && fragment.has_value()) {
+				SPDLOG_TRACE("Cursor moved over fragment {}", fragment.value());
+			}
+
+			hoveredFragment = fragment;
+		}
+	} while (window->isAlive());
+
+	compositor.stop();
 	renderer.destroy();
-	window.destroy();
+	window->destroy();
+	finishTrace(options);
 
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,41 @@
+#include "painter.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+using namespace graphics::renderer;
+using namespace layout::fragment;
+
+// Approximate distance from the top of the em box to the baseline, until font metrics are exposed to the painter
+constexpr float ASCENT_EM = 0.8f;
+
+DisplayList plain::paint(const FragmentTree& fragments, const graphics::text::FontId font) {
+	DisplayList displayList;
+
+	const auto x = fragments.getX();
+	const auto y = fragments.getY();
+	const auto width = fragments.getWidth();
+	const auto height = fragments.getHeight();
+	const auto flags = fragments.getFlags();
+	const auto colors = fragments.getColors();
+	const auto backgroundColors = fragments.getBackgroundColors();
+	const auto fontSizes = fragments.getFontSizes();
+
+	for (std::size_t i = 0; i < fragments.size(); ++i) {
+		const auto bounds = Rectangle{ x[i], y[i], width[i], height[i] };
+
+		if (hasFlag(flags[i], FragmentFlags::HasBackground)) {
+			displayList.pushRectangle(bounds, backgroundColors[i]);
+		}
+
+		if (hasFlag(flags[i], FragmentFlags::Text)) {
+			// Center the em box within the line
+			const auto baseline = y[i] + (height[i] - fontSizes[i]) * 0.5f + fontSizes[i] * ASCENT_EM;
+			const auto pixelSize = static_cast<std::uint32_t>(std::lround(fontSizes[i]));
+
+			displayList.pushGlyphRun(bounds, std::round(baseline), font, pixelSize, fragments.getText(i), colors[i]);
+		}
+	}
+
+	return displayList;
+}
@@ -0,0 +1,16 @@
+#ifndef PLAIN_PAINTER_HPP
+#define PLAIN_PAINTER_HPP
+
+#include "graphics/renderer/display_list.hpp"
+#include "graphics/text/font_collection.hpp"
+
+#include "layout/fragment/fragment_tree.hpp"
+
+namespace plain {
+
+	// Convert the fragments of a layout pass into a display list, in paint order
+	graphics::renderer::DisplayList paint(const layout::fragment::FragmentTree& fragments, const graphics::text::FontId font);
+
+}
+
+#endif // !PLAIN_PAINTER_HPP
@@ -0,0 +1,42 @@
+#version 450
+
+layout(push_constant) uniform PushConstants {
+    // Applied to viewport pixels after scrolling, the identity everywhere except when compositing the page
+    mat4 transform;
+
+    vec2 viewportSize;
+
+    // Page coordinate that ends up in the top-left corner of the viewport
+    vec2 origin;
+} pushConstants;
+
+// Per-instance data, see "QuadInstance"
+layout(location = 0) in vec4 inputRectangle;
+layout(location = 1) in vec4 inputTextureCoordinates;
+layout(location = 2) in vec4 inputColor;
+layout(location = 3) in uint inputTexture;
+
+layout(location = 0) out vec2 outputTextureCoordinates;
+layout(location = 1) out vec4 outputColor;
+layout(location = 2) flat out uint outputTexture;
+
+// Two triangles that form a unit quad
+vec2 corners[6] = vec2[](
+    vec2(0.0, 0.0),
+    vec2(1.0, 0.0),
+    vec2(1.0, 1.0),
+    vec2(0.0, 0.0),
+    vec2(1.0, 1.0),
+    vec2(0.0, 1.0)
+);
+
+void main() {
+    vec2 corner = corners[gl_VertexIndex];
+    vec2 position = (pushConstants.transform * vec4(inputRectangle.xy + corner * inputRectangle.zw - pushConstants.origin, 0.0, 1.0)).xy;
+
+    // Pixels to normalized device coordinates, Vulkan's y-axis already points down
+    gl_Position = vec4(position / pushConstants.viewportSize * 2.0 - 1.0, 0.0, 1.0);
+    outputTextureCoordinates = mix(inputTextureCoordinates.xy, inputTextureCoordinates.zw, corner);
+    outputColor = inputColor;
+    outputTexture = inputTexture;
+}
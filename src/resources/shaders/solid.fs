@@ -0,0 +1,10 @@
+#version 450
+
+layout(location = 0) in vec2 inputTextureCoordinates;
+layout(location = 1) in vec4 inputColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = inputColor;
+}
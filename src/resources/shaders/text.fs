@@ -0,0 +1,18 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Every texture the renderer knows about, must be as large as "MAX_TEXTURE_COUNT"
+layout(set = 0, binding = 0) uniform sampler2D textures[1024];
+
+layout(location = 0) in vec2 inputTextureCoordinates;
+layout(location = 1) in vec4 inputColor;
+
+// Element of "textures" that holds the glyph atlas
+layout(location = 2) flat in uint inputTexture;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // The atlas only stores coverage, the color is premultiplied so scaling all channels is enough
+    outColor = inputColor * texture(textures[nonuniformEXT(inputTexture)], inputTextureCoordinates).r;
+}